@@ -7,6 +7,8 @@
 // Last Modified: Wed May 19 15:30:49 PDT 2010 Added tick & rational values
 // Last Modified: Sat Apr 28 09:03:39 PDT 2018 Converted to HumdrumStream input
 // Last Modified: Sun Apr 29 15:07:07 PDT 2018 Added -m and --meter-bottom options
+// Last Modified: Mon Oct 19 01:22:16 PDT 2026 Added -L line index lookup
+// Last Modified: Mon Oct 19 02:40:12 PDT 2026 Added --cache option
 // Filename:      ...sig/examples/all/beat.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/beat.cpp
 // Syntax:        C++; museinfo
@@ -104,7 +106,9 @@ void      fillAttackArray    (HumdrumFile& infile, vector<int>& attacks);
 int       getCountForLine    (HumdrumFile& infile, int line);
 int       doTickAnalysis     (vector<int>& tickanalysis, HumdrumFile& infile);
 RationalNumber getDurationOfFirstMeasure(HumdrumFile& file);
-void      analyzeFile        (HumdrumFile& infile);
+void      analyzeFile        (HumdrumFile& infile, int analyzedQ = 0);
+void      printLineIndexes   (HumdrumFile& infile);
+RationalNumber getRationalBeat(const string& astring);
 void      prepareMeterData   (HumdrumFile& infile);
 
 // global variables
@@ -119,6 +123,7 @@ int       zeroQ    = 0;        // zero offset instead of 1 for first beat
 int       nullQ    = 0;        // used with -n option
 vector<double> Bsearch;        // used with -B option
 vector<double> Dsearch;        // used with -D option
+vector<string> Lbeats;         // used with -L option
 double    Rvalue   = -1.0;     // used with -R option
 double    Tolerance = 0.001;   // used for rounding
 int       Attack   = 1;        // used with -A option
@@ -134,6 +139,8 @@ int       fillQ    = 0;        // used with --fill option
 string    beatbase = "4";      // used with --beatsize option
 int       uQ       = 0;        // used for -f and -u interactions
 int       debugQ   = 0;        // used with --debug option
+string    cachefile;           // used with --cache option
+int       cachestatusQ = 0;    // used with --cache-status option
 
 vector<string> Metertop;      // used with -m option
 vector<string> Meterbot;      // used with -meter-bottom option
@@ -143,9 +150,23 @@ vector<RationalNumber> Meterdur; // used with --meter-duration option
 
 int main(int argc, char* argv[]) {
 	checkOptions(options, argc, argv);
-	HumdrumStream streamer(options);
 	HumdrumFile infile;
 
+	if (cachefile.size() > 0) {
+		if (options.getArgCount() != 1) {
+			cerr << "Error: --cache requires a single input file" << endl;
+			exit(1);
+		}
+		int status = infile.readCached(options.getArg(1), cachefile,
+				beatbase.c_str());
+		if (cachestatusQ) {
+			cerr << "cache " << (status ? "used" : "rebuilt") << endl;
+		}
+		analyzeFile(infile, 1);
+		return 0;
+	}
+
+	HumdrumStream streamer(options);
 	while (streamer.read(infile)) {
 		analyzeFile(infile);
 	}
@@ -157,16 +178,20 @@ int main(int argc, char* argv[]) {
 
 //////////////////////////////
 //
-// analyzeFile --
+// analyzeFile -- If analyzedQ is true, then the rhythm of the file has
+//     already been analyzed (by reading it through the --cache file).
+//     default value: analyzedQ = 0
 //
 
-void analyzeFile(HumdrumFile& infile) {
+void analyzeFile(HumdrumFile& infile, int analyzedQ) {
 	vector<RationalNumber> Bfeatures; // used to extract beat data from input
 	vector<RationalNumber> Dfeatures; // used to extract duration data from input
 	vector<int>    Blines;            // used to extract beat data from input
 	vector<int>    Dlines;            // used to extract duration data from input
 
-	infile.analyzeRhythm(beatbase.c_str());
+	if (!analyzedQ) {
+		infile.analyzeRhythm(beatbase.c_str());
+	}
 
 	if (metertopQ || meterbotQ || meterdurQ) {
 		prepareMeterData(infile);
@@ -200,7 +225,9 @@ void analyzeFile(HumdrumFile& infile) {
 	}
 	extractDurFeatures(infile, Dlines, Dfeatures);
 
-	if (Bsearch.size() > 0 || Dsearch.size() > 0) {
+	if (Lbeats.size() > 0) {
+		printLineIndexes(infile);
+	} else if (Bsearch.size() > 0 || Dsearch.size() > 0) {
 		printSearchResults(infile, Bfeatures, Blines, Dfeatures, Dlines);
 	} else {
 		printOutput(infile, Bfeatures, Blines, Dfeatures, Dlines,
@@ -213,6 +240,74 @@ void analyzeFile(HumdrumFile& infile) {
 
 
 
+//////////////////////////////
+//
+// printLineIndexes -- Print the line indexes which HumdrumFile::getStartIndex
+//     and HumdrumFile::getStopIndex return for each absolute beat given
+//     with the -L option.  The first two index columns are from the
+//     floating-point lookups, and the last two from the RationalNumber
+//     lookups.
+//
+
+void printLineIndexes(HumdrumFile& infile) {
+	cout << "**absb\t**start\t**stop\t**startr\t**stopr\n";
+	for (int i=0; i<(int)Lbeats.size(); i++) {
+		RationalNumber beat = getRationalBeat(Lbeats[i]);
+		cout << Lbeats[i];
+		cout << "\t" << infile.getStartIndex(beat.getFloat());
+		cout << "\t" << infile.getStopIndex(beat.getFloat());
+		cout << "\t" << infile.getStartIndex(beat);
+		cout << "\t" << infile.getStopIndex(beat);
+		cout << "\n";
+	}
+	cout << "*-\t*-\t*-\t*-\t*-" << endl;
+}
+
+
+
+//////////////////////////////
+//
+// getRationalBeat -- Convert a beat given as an integer, a decimal
+//     number or a fraction such as "1/3" into a RationalNumber.
+//
+
+RationalNumber getRationalBeat(const string& astring) {
+	long long top = 0;
+	long long bot = 1;
+	if (sscanf(astring.c_str(), "%lld/%lld", &top, &bot) == 2) {
+		if (bot == 0) {
+			cerr << "Error: invalid beat: " << astring << endl;
+			exit(1);
+		}
+		return RationalNumber(top, bot);
+	}
+	int sign = 1;
+	int i = 0;
+	if ((i < (int)astring.size()) && (astring[i] == '-')) {
+		sign = -1;
+		i++;
+	}
+	top = 0;
+	bot = 1;
+	int decimalQ = 0;
+	for ( ; i<(int)astring.size(); i++) {
+		if (astring[i] == '.' && !decimalQ) {
+			decimalQ = 1;
+		} else if (isdigit(astring[i])) {
+			top = top * 10 + (astring[i] - '0');
+			if (decimalQ) {
+				bot *= 10;
+			}
+		} else {
+			cerr << "Error: invalid beat: " << astring << endl;
+			exit(1);
+		}
+	}
+	return RationalNumber(sign * top, bot);
+}
+
+
+
 //////////////////////////////
 //
 // prepareMeterData --
@@ -1310,6 +1405,9 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("B=s");                  // Do a composite beat search
 	opts.define("D=s");                  // Do a composite duration search
 	opts.define("R=d:-1.0");             // Limit total duration range of search
+	opts.define("L|lines=s");            // line indexes for absolute beats
+	opts.define("cache=s");              // binary cache file for input
+	opts.define("cache-status=b");       // report cache use on stderr
 	opts.define("u|beatsize=s:4");       // beat unit
 	opts.define("A|attacks|attack=i:1"); // Minimum num of note onsets for event
 	opts.define("t|tick=b", "display durations as tick values");
@@ -1363,6 +1461,10 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	beatbase  = opts.getString("beatsize");
 	uQ        = opts.getBoolean("beatsize");
 	debugQ    = opts.getBoolean("debug");
+	if (opts.getBoolean("cache")) {
+		cachefile = opts.getString("cache");
+	}
+	cachestatusQ = opts.getBoolean("cache-status");
 
 	if (rationalQ) {
 		tickQ = 1;
@@ -1383,6 +1485,19 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 		fillSearchString(Dsearch, opts.getString("D"));
 	}
 
+	Lbeats.resize(0);
+	if (opts.getBoolean("lines")) {
+		string list = opts.getString("lines");
+		char* tempstr = new char[list.size()+1];
+		strcpy(tempstr, list.c_str());
+		char* ptr = strtok(tempstr, " \t\n:;,");
+		while (ptr != NULL) {
+			Lbeats.push_back(ptr);
+			ptr = strtok(NULL, " \t\n:;,");
+		}
+		delete [] tempstr;
+	}
+
 	if (prependQ && appendQ) {
 		prependQ = 1;
 		appendQ = 0;
@@ -1469,6 +1584,8 @@ void usage(const char* command) {
 	"   -b = set the base rhythm for analysis to specified kern rhythm value. \n"
 	"   -d = gives the duration of each kern record in beat measurements.     \n"
 	"   -s = sum the beat count in each measure.                              \n"
+	"   -L = list the getStartIndex/getStopIndex lines for absolute beats.    \n"
+	"   --cache file = read the (single) input file through a binary cache.   \n"
 	"   --options = list of all options, aliases and default values           \n"
 	"                                                                         \n"
 	<< endl;
@@ -7,6 +7,7 @@
 // Last Modified: Wed Apr 28 18:49:29 PDT 2010 Added -T and -D options
 // Last Modified: Wed Sep 14 10:40:48 PDT 2011 Added -F option
 // Last Modified: Sat Apr  6 01:16:22 PDT 2013 Enabled multiple segment input
+// Last Modified: Sun Oct 18 21:48:15 PDT 2026 Added literal prefilter, threads
 // Filename:      ...sig/examples/all/hgrep.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/hgrep.cpp
 // Syntax:        C++; museinfo
@@ -23,6 +24,7 @@
 #include <regex.h>
 
 #include "humdrum.h"
+#include "ThemeIndex.h"
 
 using namespace std;
 
@@ -32,14 +34,16 @@ using namespace std;
 void      checkOptions        (Options& opts, int argc, char** argv);
 void      example             (void);
 void      usage               (const string& command);
-void      doSearch            (const string& searchstring, HumdrumFile& infile,
-                               const string& filename);
-void      printPreInfo        (const string& filename, HumdrumFile& infile,
-                               double measure, int line, int spine = -1);
+void      doSearch            (ostream& out, HumdrumFile& infile,
+                               const string& filename, int& markcount,
+                               int& markmatchcount);
+void      printPreInfo        (ostream& out, const string& filename,
+                               HumdrumFile& infile, double measure,
+                               int line, int spine = -1);
 char*     searchAndReplace    (char* buffer, const string& searchstring,
                                const string& replacestring,
                                const string& datastring);
-void      displayFraction     (double fraction);
+void      displayFraction     (ostream& out, double fraction);
 void      fillAndSearches     (vector<regex_t>& relist,
                                vector<string>& exlist,
                                const string& string);
@@ -49,9 +53,14 @@ int       singleTokenSearch   (int& column, HumdrumFile& infile, int line,
                                regex_t& re, const string& exstring);
 void      destroyAndSearches  (vector<regex_t>& relist);
 double    getBeatOfNextData   (HumdrumFile& infile, int line);
-void      printDitto          (HumdrumFile& infile, int line);
-void      markKernNotes       (HumdrumFile& infile, int line);
-void      analyzeFile         (HumdrumFile& infile);
+void      printDitto          (ostream& out, HumdrumFile& infile, int line);
+void      markKernNotes       (HumdrumFile& infile, int line,
+                               int& markcount, int& markmatchcount);
+void      analyzeFile         (HumdrumFile& infile, ostream& out);
+void      compileSearch       (regex_t& re, const string& pattern);
+void      fillLiterals        (vector<string>& literals);
+int       hasLiterals         (const char* text);
+int       prefilterFile       (const string& text);
 
 // User interface variables:
 Options     options;
@@ -80,8 +89,9 @@ string      exinterps       = "";    // used with -x option
 char        separator[1024] = {0};   // used with --sep option
 vector<regex_t> Andlist;              // used with --and option
 vector<string> Andexinterp;     // used with --and option
-int         MarkerCount     = 0;
-int         MarkerMatchCount= 0;
+regex_t     Searchre;                // compiled search string
+vector<string> Literals;             // strings required for any match
+int         rhythmQ         = 0;     // used with -a, -b, -f, -m options
 
 // standard grep option emulations:
 int         fileQ           = 0;     // used with -H option
@@ -96,13 +106,17 @@ int         invertQ         = 0;     // used with -v option
 
 int main(int argc, char** argv) {
 	checkOptions(options, argc, argv);
-	HumdrumStream streamer(options);
-	HumdrumFile infile;
-
-	while (streamer.read(infile)) {
-		analyzeFile(infile);
+	HumdrumStreamPool pool(options);
+	pool.setThreadCount(options.getInteger("threads"));
+	if (!Literals.empty() && !invertQ && !nomatchfilesQ && !formQ &&
+			!markQ) {
+		// files without the literal parts of the search strings cannot
+		// contain a match, so don't parse them.
+		pool.setTextFilter(prefilterFile);
 	}
+	pool.run(analyzeFile);
 
+	regfree(&Searchre);
 	destroyAndSearches(Andlist);
 
 	return 0;
@@ -115,56 +129,70 @@ int main(int argc, char** argv) {
 // analyzeFile --
 //
 
-void analyzeFile(HumdrumFile& infile) {
-	if (absbeatQ || beatQ || measureQ || fracQ) {
-		// need to do this for measureQ because of pickup information
-		infile.analyzeRhythm("4");
-	}
-
-	doSearch(searchstring.c_str(), infile, infile.getFilename());
+void analyzeFile(HumdrumFile& infile, ostream& out) {
+	int markcount = 0;
+	int markmatchcount = 0;
+	doSearch(out, infile, infile.getFilename(), markcount, markmatchcount);
 	if (markQ) {
-		cout << infile;
-		if (MarkerCount) {
-			cout << "!!!RDF**kern: @ = marked note ("
-					<< MarkerCount << " marks in " << MarkerMatchCount
+		out << infile;
+		if (markcount) {
+			out << "!!!RDF**kern: @ = marked note ("
+					<< markcount << " marks in " << markmatchcount
 					<< " matches)" << endl;
-			MarkerCount = 0;
-			MarkerMatchCount = 0;
 		}
 	}
 }
 
-//////////////////////////////////////////////////////////////////////////
 
 
 //////////////////////////////
 //
-// doSearch --
+// prefilterFile -- Returns true if the text of a file contains all of
+//     the literal strings required by the search strings.
 //
 
-void doSearch(const string& searchstring, HumdrumFile& infile,
-		const string& filename) {
-	regex_t re;
-	int flags = 0;
-	double measure = 1;
-	if (infile.getPickupDur() != 0.0) {
-		measure = 0;
+int prefilterFile(const string& text) {
+	for (int i=0; i<(int)Literals.size(); i++) {
+		if (text.find(Literals[i]) == string::npos) {
+			return 0;
+		}
 	}
+	return 1;
+}
 
-	if (!basicQ) {
-		flags = flags | REG_EXTENDED;
-	}
-	if (ignorecaseQ) {
-		flags = flags | REG_ICASE;
+
+
+//////////////////////////////
+//
+// hasLiterals -- Returns true if a line contains all of the literal
+//     strings required by the search strings.  Lines which fail this
+//     test do not need to be checked with the regular expressions.
+//
+
+int hasLiterals(const char* text) {
+	for (int i=0; i<(int)Literals.size(); i++) {
+		if (strstr(text, Literals[i].c_str()) == NULL) {
+			return 0;
+		}
 	}
+	return 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// doSearch --
+//
+
+void doSearch(ostream& out, HumdrumFile& infile, const string& filename,
+		int& markcount, int& markmatchcount) {
+	regex_t& re = Searchre;
+	double measure = 1;
+	int barlineQ = 0;    // a barline has been found in the file
+	int analyzedQ = 0;   // rhythm analysis has been done
 	int status;
-	status = regcomp(&re, searchstring.c_str(), flags);
-	if (status != 0) {
-		char errstring[1024] = {0};
-		regerror(status, &re, errstring, 1000);
-		cerr << errstring << endl;
-		exit(1);
-	}
 	int i;
 	int matchcount = 0;
 
@@ -175,10 +203,10 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 		if (formQ && !infile[i].isData()) {
 			if (!invertQ) {
 				if (nullQ) {
-					printDitto(infile, i);
-					cout << endl;
+					printDitto(out, infile, i);
+					out << endl;
 				} else {
-					cout << infile[i] << endl;
+					out << infile[i] << endl;
 				}
 			} else {
 				if (strcmp(infile[i][0], "*-") == 0) {
@@ -187,10 +215,10 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 					// handled at marker xyga
 				} else {
 					if (nullQ) {
-						printDitto(infile, i);
-						cout << endl;
+						printDitto(out, infile, i);
+						out << endl;
 					} else {
-						cout << infile[i] << endl;
+						out << infile[i] << endl;
 					}
 				}
 			}
@@ -199,6 +227,7 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 		if (infile[i].isEmpty()) { continue; }
 		if (infile[i].isMeasure()) {
 			sscanf(infile[i][0],"=%lf", &measure);
+			barlineQ = 1;
 		}
 		if (dataQ && tandemQ) {
 			if (!(infile[i].isData() || infile[i].isTandem())) { continue; }
@@ -216,11 +245,15 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 				continue;
 			}
 			int column = -1;
-			status = tokenSearch(column, infile, i, re);
+			if (hasLiterals(infile[i].getLine())) {
+				status = tokenSearch(column, infile, i, re);
+			} else {
+				status = 1;
+			}
 			// status == 0 means a match was found
 			// status != 0 means a match was not found
 			if (markQ && !status) {
-				markKernNotes(infile, i);
+				markKernNotes(infile, i, markcount, markmatchcount);
 				continue;
 			}
 
@@ -230,31 +263,41 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 			if (status == 0) {
 				matchcount++;
 				if (matchfilesQ) {
-					cout << filename << endl;
+					out << filename << endl;
 					return;
 				}
 				if (nomatchfilesQ) {
 					continue;
 				}
-				printPreInfo(filename, infile, measure, i, column);
+				if (rhythmQ && !analyzedQ) {
+					// only needed for files which contain a match
+					infile.analyzeRhythm("4");
+					analyzedQ = 1;
+				}
+				if (!barlineQ) {
+					measure = (infile.getPickupDur() != 0.0) ? 0 : 1;
+				}
+				printPreInfo(out, filename, infile, measure, i, column);
 				if (!quietQ) {
 					// marker xyga
 					if (nullQ) {
-						printDitto(infile, i);
+						printDitto(out, infile, i);
 					} else {
-						cout << infile[i];
+						out << infile[i];
 					}
 				}
-				cout << endl;
+				out << endl;
 			}
 
 		} else { // search entire line as a single unit
-			if (tokenizeQ) {
+			if (!hasLiterals(infile[i].getLine())) {
+				status = 1;
+			} else if (tokenizeQ) {
 				status = 0;
 				for (int ii=0; ii<infile[i].getFieldCount(); ii++) {
 					status = tokenSearch(ii, infile, i, re);
 					if (markQ && !status) {
-						markKernNotes(infile, i);
+						markKernNotes(infile, i, markcount, markmatchcount);
 						continue;
 					}
 					if (status == 0) {
@@ -264,11 +307,11 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 			} else {
 				status = regexec(&re, infile[i].getLine(), 0, NULL, 0);
 				if (markQ && !status) {
-					markKernNotes(infile, i);
+					markKernNotes(infile, i, markcount, markmatchcount);
 					continue;
 				}
 			}
-			if (Andlist.size() > 0) {
+			if ((status == 0) && (Andlist.size() > 0)) {
 				for (int aa=0; aa<(int)Andlist.size(); aa++) {
 					int newstatus = regexec(&Andlist[aa], infile[i].getLine(),
 							0, NULL, 0);
@@ -283,29 +326,35 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 			if (status == 0) {
 				matchcount++;
 				if (matchfilesQ) {
-					cout << filename << endl;
+					out << filename << endl;
 					return;
 				}
 				if (nomatchfilesQ) {
 					continue;
 				}
-				printPreInfo(filename, infile, measure, i, -1);
+				if (rhythmQ && !analyzedQ) {
+					infile.analyzeRhythm("4");
+					analyzedQ = 1;
+				}
+				if (!barlineQ) {
+					measure = (infile.getPickupDur() != 0.0) ? 0 : 1;
+				}
+				printPreInfo(out, filename, infile, measure, i, -1);
 				if (!quietQ) {
 					if (nullQ) {
-						printDitto(infile, i);
+						printDitto(out, infile, i);
 					} else {
-						cout << infile[i];
+						out << infile[i];
 					}
 				}
-				cout << endl;
+				out << endl;
 			}
 
 		}
 	}
 
-	regfree(&re);
 	if (nomatchfilesQ && matchcount == 0) {
-		cout << filename << endl;
+		out << filename << endl;
 	}
 }
 
@@ -318,12 +367,13 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 // which are currently sounding.
 //
 
-void markKernNotes(HumdrumFile& infile, int line) {
+void markKernNotes(HumdrumFile& infile, int line, int& markcount,
+		int& markmatchcount) {
 	int j;
 	if (!infile[line].isData()) {
 		return;
 	}
-	MarkerMatchCount++;
+	markmatchcount++;
 	char buffer[1024] = {0};
 	HumdrumFileAddress add;
 	for (j=0; j<infile[line].getFieldCount(); j++) {
@@ -339,7 +389,7 @@ void markKernNotes(HumdrumFile& infile, int line) {
 			// don't duplicate @ marker in a token
 			continue;
 		}
-		MarkerCount++;
+		markcount++;
 		strcpy(buffer, infile[add]);
 		strcat(buffer, "@");
 		infile.changeField(add, buffer);
@@ -353,10 +403,10 @@ void markKernNotes(HumdrumFile& infile, int line) {
 // printDitto -- fill in null tokens with/without parentheses
 //
 
-void printDitto(HumdrumFile& infile, int line) {
+void printDitto(ostream& out, HumdrumFile& infile, int line) {
 	int j, ii, jj;
 	if (!infile[line].isData()) {
-		cout << infile[line] << endl;
+		out << infile[line] << endl;
 	}
 	int count = infile[line].getFieldCount();
 	int null = 0;
@@ -370,12 +420,12 @@ void printDitto(HumdrumFile& infile, int line) {
 			null = 1;
 		}
 		if (null && parenQ) {
-			cout << "(" << infile[ii][jj] << ")";
+			out << "(" << infile[ii][jj] << ")";
 		} else {
-			cout << infile[ii][jj];
+			out << infile[ii][jj];
 		}
 		if (j<count-1) {
-			cout << '\t';
+			out << '\t';
 		}
 	}
 }
@@ -513,37 +563,37 @@ char* searchAndReplace(char* buffer, const string& searchstring,
 //    default value: spine = -1
 //
 
-void printPreInfo(const string& filename, HumdrumFile& infile, double measure,
-		int line, int spine) {
+void printPreInfo(ostream& out, const string& filename, HumdrumFile& infile,
+		double measure, int line, int spine) {
 	if (fileQ) {
-		cout << filename << separator;
+		out << filename << separator;
 	}
 	if (lineQ) {
-		cout << "line " << line+1 << separator;
+		out << "line " << line+1 << separator;
 	}
 	if (spineQ && (spine >= 0)) {
-		cout << "spine " << spine+1 << separator;
+		out << "spine " << spine+1 << separator;
 	} /* else if (spineQ) {
-		cout << "spine " << 1 << separator;
+		out << "spine " << 1 << separator;
 	} */
 
 	if (measureQ) {
-		cout << "measure " << measure << separator;
+		out << "measure " << measure << separator;
 	}
 	if (beatQ) {
 		if (infile[line].getBeat() == 0.0) {
-			cout << "beat " << getBeatOfNextData(infile, line) << separator;
+			out << "beat " << getBeatOfNextData(infile, line) << separator;
 		} else {
-			cout << "beat " << infile[line].getBeat() << separator;
+			out << "beat " << infile[line].getBeat() << separator;
 		}
 	}
 	if (absbeatQ) {
-		cout << "absbeat " << infile[line].getAbsBeat() << separator;
+		out << "absbeat " << infile[line].getAbsBeat() << separator;
 	}
 	if (fracQ) {
-		cout << "frac ";
-		displayFraction(infile[line].getAbsBeat()/infile.getTotalDuration());
-		cout << separator;
+		out << "frac ";
+		displayFraction(out, infile[line].getAbsBeat()/infile.getTotalDuration());
+		out << separator;
 	}
 }
 
@@ -577,20 +627,20 @@ double getBeatOfNextData(HumdrumFile& infile, int line) {
 // displayFraction
 //
 
-void displayFraction(double fraction) {
+void displayFraction(ostream& out, double fraction) {
 	int value;
 	if (fraction == 0.0) {
-		cout << "0.000";
+		out << "0.000";
 	} else if (fraction == 1.0) {
-		cout << "1.000";
+		out << "1.000";
 	} else if (fraction > 0.0 && fraction < 1.0) {
 		value = int(fraction * 1000.0 + 0.5);
-		cout << "0.";
-		if (value < 100) { cout << "0"; }
-		if (value < 10) { cout << "0"; }
-		cout << value;
+		out << "0.";
+		if (value < 100) { out << "0"; }
+		if (value < 10) { out << "0"; }
+		out << value;
 	} else {
-		cout << fraction;
+		out << fraction;
 	}
 }
 
@@ -625,6 +675,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("sep|separator=s::", "data separator string");
 	opts.define("no-paren=b",        "don't display null parentheses");
 	opts.define("and=s:",            "anded search strings");
+	opts.define("threads=i:0",       "number of threads (0 = one per core)");
 
 	// options which mimic regular grep program:
 	opts.define("G|basic-regexp=b",  "use basic regular expression syntax");
@@ -707,6 +758,81 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	if (opts.getBoolean("and")) {
 		fillAndSearches(Andlist, Andexinterp, opts.getString("and").c_str());
 	}
+
+	// need rhythm analysis for measureQ because of pickup information
+	rhythmQ = absbeatQ || beatQ || measureQ || fracQ;
+	compileSearch(Searchre, searchstring);
+	fillLiterals(Literals);
+}
+
+
+
+//////////////////////////////
+//
+// compileSearch -- compile the search string into a regular expression.
+//
+
+void compileSearch(regex_t& re, const string& pattern) {
+	int flags = 0;
+	if (!basicQ) {
+		flags = flags | REG_EXTENDED;
+	}
+	if (ignorecaseQ) {
+		flags = flags | REG_ICASE;
+	}
+	int status = regcomp(&re, pattern.c_str(), flags);
+	if (status != 0) {
+		char errstring[1024] = {0};
+		regerror(status, &re, errstring, 1000);
+		cerr << errstring << endl;
+		exit(1);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// fillLiterals -- Store the literal strings which must be present in
+//    any line matched by the search string and the --and search strings.
+//    Basic regular expressions and case-insensitive searches are not
+//    prefiltered.
+//
+
+void fillLiterals(vector<string>& literals) {
+	literals.clear();
+	if (basicQ || ignorecaseQ) {
+		return;
+	}
+	vector<string> patterns;
+	patterns.push_back(searchstring);
+	if (options.getBoolean("and")) {
+		char* buffer;
+		int bufsize = (int)options.getString("and").size() * 2 + 128;
+		buffer = new char[bufsize];
+		searchAndReplace(buffer, "[\\]n", "\n", options.getString("and"));
+		char* ptr = strtok(buffer, "\n");
+		while (ptr != NULL) {
+			if (strncmp("**", ptr, 2) != 0) {
+				patterns.push_back(ptr);
+			}
+			ptr = strtok(NULL, "\n");
+		}
+		delete [] buffer;
+	}
+
+	vector<string> strings;
+	for (int i=0; i<(int)patterns.size(); i++) {
+		if (strstr(patterns[i].c_str(), "\\<") ||
+				strstr(patterns[i].c_str(), "\\>") ||
+				strstr(patterns[i].c_str(), "\\`") ||
+				strstr(patterns[i].c_str(), "\\'")) {
+			// GNU word and buffer anchors are not literal characters
+			continue;
+		}
+		ThemeIndex::getLiterals(strings, patterns[i]);
+		literals.insert(literals.end(), strings.begin(), strings.end());
+	}
 }
 
 
@@ -307,6 +307,7 @@ int main(int argc, char* argv[]) {
 
 		// analyze the input file according to command-line options
 		infile.analyzeRhythm("4", debugQ);
+		infile.analyzeTies();
 
 		infile.getKernTracks(Ktracks);
 
@@ -19,6 +19,7 @@
 // Last Modified: Mon Aug 19 15:12:09 PDT 2013 Added *elision controls
 // Last Modified: Fri Jan  3 14:34:21 PST 2014 Added RDF**kern:j tied group
 // Last Modified: Wed Jan  6 19:51:34 PST 2016 Added left/right quotes
+// Last Modified: Mon Oct 19 03:27:40 PDT 2026 Added --time-index and --threads
 // Filename:      ...sig/examples/all/hum2muse.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/hum2muse.cpp
 // Syntax:        C++; museinfo
@@ -469,6 +470,8 @@ void  processLyricsSpines      (Array<Array<int>>& spineinfo,
 void  verifyMuseDataFile       (const char* filename);
 void  verifyMuseDataFile       (istream& input);
 void  verifyMuseDataFiles      (Options& options);
+void  printMuseDataTimeIndexes (Options& options);
+void  printMuseDataTimeIndex   (MuseDataSet& mds, const char* filename);
 int   verifyPart               (MuseData& part);
 void  updateMuseDataFileTimeStamps(Options& options);
 void  removeOldTimeStamps      (MuseData& part);
@@ -568,6 +571,7 @@ string LyricSpines     = "";  // used with --ls option
 string Encoder         = "";  // used with --encoder option
 int    encoderQ        = 0;   // used with --encoder option
 int    copyrightQ      = 0;   // used with --copyright option
+int    threadCount     = 0;   // used with --threads option
 const char* Copyright  = "";  // used with --copyright option
 string Colorchar;        // charcter in **kern data which causes color
 string Colorout;         // converted charcter in col 14 of MuseData
@@ -8100,6 +8104,7 @@ void verifyMuseDataFiles(Options& options) {
 
 void verifyMuseDataFile(istream& input) {
 	MuseDataSet mds;
+	mds.setThreadCount(threadCount);
 	mds.read(input);
 	int vp;
 	for (int i=0; i<mds.getPartCount(); i++) {
@@ -8121,6 +8126,7 @@ void verifyMuseDataFile(istream& input) {
 
 void verifyMuseDataFile(const char* filename) {
 	MuseDataSet mds;
+	mds.setThreadCount(threadCount);
 	mds.read(filename);
 	int vp;
 	for (int i=0; i<mds.getPartCount(); i++) {
@@ -8135,6 +8141,58 @@ void verifyMuseDataFile(const char* filename) {
 
 
 
+//////////////////////////////
+//
+// printMuseDataTimeIndexes -- List the event times of multi-part
+//     MuseData files.
+//
+
+void printMuseDataTimeIndexes(Options& options) {
+	MuseDataSet mds;
+	mds.setThreadCount(threadCount);
+	if (options.getArgCount() == 0) {
+		mds.read(std::cin);
+		printMuseDataTimeIndex(mds, ".");
+	} else {
+		for (int i=0; i<options.getArgCount(); i++) {
+			mds.read(options.getArg(i+1).c_str());
+			printMuseDataTimeIndex(mds, options.getArg(i+1).c_str());
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// printMuseDataTimeIndex -- Print one line for each distinct event time
+//     in all parts, with the index of the event in each part at that
+//     time, or "." if the part has no event there.
+//
+
+void printMuseDataTimeIndex(MuseDataSet& mds, const char* filename) {
+	int i, j, eindex;
+	cout << "#" << filename << "\ttime";
+	for (j=0; j<mds.getPartCount(); j++) {
+		cout << "\tpart_" << j+1;
+	}
+	cout << "\n";
+	for (i=0; i<mds.getTimeCount(); i++) {
+		cout << i << "\t" << mds.getTime(i);
+		for (j=0; j<mds.getPartCount(); j++) {
+			eindex = mds.getEventIndex(i, j);
+			if (eindex < 0) {
+				cout << "\t.";
+			} else {
+				cout << "\t" << eindex;
+			}
+		}
+		cout << "\n";
+	}
+}
+
+
+
 //////////////////////////////
 //
 // verifyPart -- check to see if the MD5sum matches the part
@@ -8366,6 +8424,7 @@ int getTimeStampLine(MuseRecord& arecord, MuseData& part) {
 
 void updateFileTimeStamps(istream& input, Options& options) {
 	MuseDataSet mds;
+	mds.setThreadCount(threadCount);
 	mds.read(input);
 	doUpdateWork(mds);
 
@@ -8383,6 +8442,7 @@ void updateFileTimeStamps(istream& input, Options& options) {
 
 void updateFileTimeStamps(const char* filename,  Options& options) {
 	MuseDataSet mds;
+	mds.setThreadCount(threadCount);
 	mds.read(filename);
 	doUpdateWork(mds);
 
@@ -8674,6 +8734,8 @@ void checkOptions(Options& opts, int argc, char** argv) {
 	opts.define("C|no-composer=b", "do not display automatic composer");
 	opts.define("T|no-title=b", "do not display automatic title");
 	opts.define("v|verify=b",  "Verify input MuseData file(s)");
+	opts.define("time-index=b",  "List event times of input MuseData file(s)");
+	opts.define("threads=i:0",  "Threads for reading MuseData parts (0=all cores)");
 	opts.define("d|debug=b",    "Debugging information");
 	opts.define("ns|no-slur|no-slurs|noslur|noslurs=b",  "do not convert slurs");
 	opts.define("no-hang-tie=b",  "try to deal with hanging ties");
@@ -8741,9 +8803,13 @@ void checkOptions(Options& opts, int argc, char** argv) {
 		exit(0);
 	}
 
+	threadCount = opts.getInteger("threads");
 	if (opts.getBoolean("verify")) {
 		verifyMuseDataFiles(options);
 		exit(0);
+	} else if (opts.getBoolean("time-index")) {
+		printMuseDataTimeIndexes(options);
+		exit(0);
 	} else if (opts.getBoolean("update")) {
 		updateMuseDataFileTimeStamps(options);
 		exit(0);
@@ -9168,6 +9234,7 @@ main:
 checkOptions:
 	CALLS:
 		example
+		printMuseDataTimeIndexes
 		updateMuseDataFileTimeStamps
 		usage
 		verifyMuseDataFiles
@@ -9256,6 +9323,14 @@ verifyMuseDataFile:
 		verifyPart
 	CALLED BY:
 		verifyMuseDataFiles
+printMuseDataTimeIndexes:
+	CALLS:
+		printMuseDataTimeIndex
+	CALLED BY:
+		checkOptions
+printMuseDataTimeIndex:
+	CALLED BY:
+		printMuseDataTimeIndexes
 convertData:
 	CALLS:
 		convertTrackToMuseData
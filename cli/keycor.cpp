@@ -7,6 +7,7 @@
 // Last Modified: Mon Sep 10 15:43:07 PDT 2012 Added enharmonic key labeling
 // Last Modified: Thu Apr 18 13:40:06 PDT 2013 Enabled multiple segment input
 // Last Modified: Sun Apr 21 21:52:30 PDT 2013 Added -e option
+// Last Modified: Sun Oct 18 17:20:44 PDT 2026 Use KeyCorrelation for -c
 // Filename:      ...sig/examples/all/keycordl.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/keycor.cpp
 // Syntax:        C++; museinfo
@@ -51,12 +52,11 @@ void   addToHistogramDouble     (Array<Array<double> >& histogram, int pc,
                                  double start, double dur, double tdur, 
 				 int segments);
 void   createHistogram          (Array<double>& pitchhist, int start, 
-                                 int count, Array<Array<double> >& segments);
+                                 int count, KeyCorrelation& engine);
 void   identifyKeyDouble        (Array<double>& histogram, 
                                  Array<double>& correlations,
-                                 double* majorKey, double* minorKey);
+                                 KeyCorrelation& engine);
 void   printBestKey             (int keynumber);
-double pearsonCorrelation       (int size, double* x, double* y);
 void   printCorrelation         (double value, int style);
 void   printHistogramTotals     (Array<Array<double> >& segments);
 double getConfidence            (Array<double>& cors, int best);
@@ -365,9 +365,11 @@ void analyzeContinuously(HumdrumFile& infile, int windowsize,
       correlations[i].allowGrowth(0);
    }
 
+   KeyCorrelation engine(majorKey, minorKey);
+   engine.setSegments(segments);
    for (i=0; i<segmentCount - windowsize; i++) {
-      createHistogram(pitchhist[i], i, windowsize, segments);
-      identifyKeyDouble(pitchhist[i], correlations[i], majorKey, minorKey);
+      createHistogram(pitchhist[i], i, windowsize, engine);
+      identifyKeyDouble(pitchhist[i], correlations[i], engine);
    }
 
 
@@ -549,43 +551,6 @@ void printCorrelation(double value, int style) {
 
 
 
-//////////////////////////////
-//
-// pearsonCorrelation --
-//
-
-double pearsonCorrelation(int size, double* x, double* y) {
-
-   double sumx  = 0.0;
-   double sumy  = 0.0;
-   double sumco = 0.0;
-   double meanx = x[0];
-   double meany = y[0];
-   double sweep;
-   double deltax;
-   double deltay;
-
-   int i;
-   for (i=2; i<=size; i++) {
-      sweep = (i-1.0) / i;
-      deltax = x[i-1] - meanx;
-      deltay = y[i-1] - meany;
-      sumx  += deltax * deltax * sweep;
-      sumy  += deltay * deltay * sweep;
-      sumco += deltax * deltay * sweep;
-      meanx += deltax / i;
-      meany += deltay / i;
-   }
-
-   double popsdx = sqrt(sumx / size);
-   double popsdy = sqrt(sumy / size);
-   double covxy  = sumco / size;
-
-   return covxy / (popsdx * popsdy);
-}
-
-
-
 //////////////////////////////
 //
 // printBestKey --
@@ -631,15 +596,10 @@ void printBestKey(int keynumber) {
 //
 
 void createHistogram(Array<double>& pitchhist, int start, int count, 
-   Array<Array<double> >& segments) {
+   KeyCorrelation& engine) {
 
    pitchhist.setAll(0);
-   int i, j;
-   for (i=0; i<count; i++) {
-      for (j=0; j<12; j++) {
-         pitchhist[j] += segments[i+start][j];
-      }
-   }
+   engine.getHistogram(pitchhist.getBase(), start, count);
 }
 
 
@@ -650,37 +610,15 @@ void createHistogram(Array<double>& pitchhist, int start, int count,
 //
 
 void identifyKeyDouble(Array<double>& histogram, Array<double>& correlations,
-   double* majorKey, double* minorKey) {
-   int i;
-
-   double h[24];
-   for (i=0; i<12; i++) {
-      h[i] = histogram[i];
-      h[i+12] = h[i];
-   }
+   KeyCorrelation& engine) {
 
-   double testsum = 0.0;
-   for (i=0; i<12; i++) {
-      testsum += h[i];
-      correlations[i]    = pearsonCorrelation(12, majorKey, h+i);
-      correlations[i+12] = pearsonCorrelation(12, minorKey, h+i);
-   }
+   int besti = engine.correlate(correlations.getBase(), histogram.getBase());
 
-   if (testsum == 0.0) {
+   if (besti < 0) {
       histogram[12] = 24;  // empty histogram, so going to display black
       return;
    }
 
-   // find max value
-   int besti = 0;
-   double bestsum = correlations[0];
-   for (i=1; i<24; i++) {
-      if (correlations[i] > bestsum) {
-         besti = i;
-         bestsum = correlations[i];
-      }
-   }
-
    histogram[12] = besti;
 }
 
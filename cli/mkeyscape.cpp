@@ -7,6 +7,9 @@
 // Last Modified: Sun May  1 10:32:02 PDT 2011 secondary key display
 // Last Modified: Wed Nov  9 17:34:49 PST 2011 fixed some irritating problems
 // Last Modified: Sun Oct 21 15:33:59 PDT 2012 added -k option
+// Last Modified: Sun Oct 18 17:20:44 PDT 2026 use KeyCorrelation engine
+// Last Modified: Sun Oct 18 18:05:12 PDT 2026 flat keyscape, threads, streaming
+// Last Modified: Mon Oct 19 03:12:05 PDT 2026 restored --average
 //
 // Filename:      ...sig/examples/all/mkeyscape.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/mkeyscape.cpp
@@ -24,6 +27,8 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <thread>
+#include <atomic>
 
 #include "humdrum.h"
 #include "MidiFile.h"
@@ -34,6 +39,65 @@
 #define HUMDRUMFILE 1
 #define MIDIFILE    2
 
+typedef signed char KEYTYPE;
+
+//////////////////////////////
+//
+// KeyscapeTriangle -- Storage for the key analysis of each cell in the
+//     keyscape.  Row i (counting from the top) has i+1 cells, and cell j
+//     of row i is the analysis of the window of (rows - i) segments
+//     starting at segment j.  All cells are stored in a single allocation
+//     as two lanes: the best key of every cell followed by the second-best
+//     key of every cell.  The histograms of the cells are not stored,
+//     since keyengine can recalculate any of them from its prefix sums.
+//     Cells are accessed as histograms[i][j][12] (best key) and
+//     histograms[i][j][13] (second-best key).
+//
+
+class KeyscapeCell {
+	public:
+		KeyscapeCell(KEYTYPE* aBest, KEYTYPE* aSecond) :
+				best(aBest), second(aSecond) { }
+		KEYTYPE& operator[](int index) { return index == 13 ? *second : *best; }
+	protected:
+		KEYTYPE* best;
+		KEYTYPE* second;
+};
+
+class KeyscapeRow {
+	public:
+		KeyscapeRow(KEYTYPE* aBest, KEYTYPE* aSecond, int aSize) :
+				best(aBest), second(aSecond), rowsize(aSize) { }
+		int          size      (void) const { return rowsize; }
+		KEYTYPE*     getBest   (void) { return best; }
+		KEYTYPE*     getSecond (void) { return second; }
+		KeyscapeCell operator[](int index) {
+				return KeyscapeCell(best + index, second + index); }
+	protected:
+		KEYTYPE* best;
+		KEYTYPE* second;
+		int      rowsize;
+};
+
+class KeyscapeTriangle {
+	public:
+		KeyscapeTriangle(void) : rows(0), cells(0) { }
+		void        resize     (int aRows) {
+				rows = aRows;
+				cells = (long)rows * (rows + 1) / 2;
+				keys.assign(2 * cells, 0); }
+		int         size       (void) const { return rows; }
+		KeyscapeRow operator[](int index) {
+				long start = (long)index * (index + 1) / 2;
+				return KeyscapeRow(keys.data() + start,
+						keys.data() + cells + start, index + 1); }
+	protected:
+		int             rows;
+		long            cells;
+		vector<KEYTYPE> keys;   // best-key lane, then second-best-key lane
+};
+
+
 // function declarations:
 void     checkOptions           (Options& opts, int argc, char** argv);
 void     example                (void);
@@ -56,16 +120,22 @@ void     addToHistogramInteger  (vector<vector<int> >& histogram, int pc,
 void     addToHistogramDouble   (vector<vector<double> >& histogram, int pc,
                                  double start, double dur, double tdur,
                                  int segments);
-void     fillAllHistograms      (vector<vector<vector<HISTTYPE> > >& histograms);
-void     printBest              (vector<vector<vector<HISTTYPE> > >& histogram);
-void     calculateBestKeys      (vector<vector<vector<HISTTYPE> > >& histograms);
+void     printBest              (KeyscapeTriangle& histogram);
+void     calculateBestKeys      (KeyscapeTriangle& histograms);
 void     identifyKey            (vector<HISTTYPE>& histogram);
-void     displayRawAnalysis     (vector<vector<vector<HISTTYPE> > >& histogram);
-void     displayAnalysisHistogram(vector<vector<vector<HISTTYPE> > >& histograms);
-void     identifyKeyDouble      (vector<HISTTYPE>& histogram);
-void     printPPM               (vector<vector<vector<HISTTYPE> > >& histograms,
+void     displayRawAnalysis     (KeyscapeTriangle& histogram);
+void     displayAnalysisHistogram(KeyscapeTriangle& histograms);
+void     identifyKeyDouble      (const double* histogram, KEYTYPE& best,
+                                 KEYTYPE& second);
+void     calculateKeyRows       (vector<KEYTYPE*>& best,
+                                 vector<KEYTYPE*>& second, int startrow,
+                                 int rows);
+int      getThreadCount         (void);
+void     printPPM               (KeyscapeTriangle* histograms, int rows,
                                  HumdrumFile& infile);
-double   pearsonCorrelation     (int size, double* x, double* y);
+void     printPPMRow            (string& line, int row, KEYTYPE* best,
+                                 int rows);
+void     printKeyName           (int key);
 void     setFilterOptions       (vector<int>& channelfilter,
                                  const char* exclude);
 void     processColorFile       (const char* filename, HumdrumFile& cfile);
@@ -84,21 +154,20 @@ void     processWeights         (const char* filename, vector<HISTTYPE>& major,
                                  vector<HISTTYPE>& minor);
 void     printColorMap          (vector<const char*>& colorindex);
 void     printWeights           (vector<HISTTYPE>& maj, vector<HISTTYPE>& min);
-void     printKeyAnalysisCorr   (vector<vector<vector<HISTTYPE> > >& histograms,
-                                 int level);
-void     printKeyCorrelations   (vector<HISTTYPE>& histogram);
+void     printKeyAnalysisCorr   (int rows, int level);
+void     printKeyCorrelations   (int rows, int row, int col);
 void     changeColorMapping     (vector<const char*>& ci, const char* type);
 void     fillColorMapping_castel(vector<const char*>& ci);
 void     fillColorMapping_newton(vector<const char*>& ci);
-void     doBlankAnalysis        (vector<vector<vector<HISTTYPE> > >& histograms);
+void     doBlankAnalysis        (KeyscapeTriangle& histograms);
 void     recurseMarkMask        (vector<vector<int> >& mask,
-                                 vector<vector<vector<HISTTYPE> > >& hist,
+                                 KeyscapeTriangle& hist,
                                  int starti, int startj, int mcounter);
-void     doFillBlanks           (vector<vector<vector<HISTTYPE> > >& histograms,
+void     doFillBlanks           (KeyscapeTriangle& histograms,
                                  vector<vector<int> >& mask);
 void     fillBoundedArea        (double target, int regionid, int line,
                                  int col, vector<vector<int> >& mask,
-                                 vector<vector<vector<double> > >& histograms);
+                                 KeyscapeTriangle& histograms);
 int      isBounded              (int target, int line, int col,
                                  vector<string>& tm,
                                  vector<vector<int> >& mask);
@@ -108,16 +177,16 @@ void     printNumbers           (HumdrumFile& infile, int numberheight,
                                  int numberwidth);
 double   getMeasureSize         (HumdrumFile& infile, int width);
 void     doTrim                 (vector<vector<int> >& mask,
-                                 vector<vector<vector<HISTTYPE> > >& histograms);
+                                 KeyscapeTriangle& histograms);
 void     trimRegion             (int start, int end, vector<vector<int> >& mask,
-                                 vector<vector<vector<HISTTYPE> > >& histograms,
+                                 KeyscapeTriangle& histograms,
                                  int color);
 void     doRegionID             (vector<vector<int> >& mask,
-                                 vector<vector<vector<HISTTYPE> > >& histograms);
-void     fillSurroundedBlanks   (vector<vector<vector<HISTTYPE> > >& histograms,
+                                 KeyscapeTriangle& histograms);
+void     fillSurroundedBlanks   (KeyscapeTriangle& histograms,
                                  vector<vector<int> >& mask,
                                  vector<int> blanksonrow);
-void     trimEdges              (vector<vector<vector<HISTTYPE> > >& histograms);
+void     trimEdges              (KeyscapeTriangle& histograms);
 int      hasdigit               (const char* strang);
 
 // User interface variables:
@@ -140,12 +209,17 @@ int       averageQ     = 0;     // used with --average option
 int       maxQ         = 0;     // used with --max option
 int       secondQ      = 0;     // used with --second option
 int       keyQ         = 0;     // used with -k option
+int       threadcount  = 0;     // used with --threads option
 
 vector<int> channelfilter;       // used with -x option
 vector<const char*> colorindex;  // used with -c option
 HumdrumFile colorfile;          // used with -c option (needs to be global)
 vector<HISTTYPE> majorweights;
 vector<HISTTYPE> minorweights;
+KeyCorrelation   keyengine;      // correlations with majorweights/minorweights
+KeyCorrelation   aaengine;       // Aarden-Essen correlations for --average
+KeyCorrelation   kpengine;       // Kostka-Payne correlations for --average
+KeyCorrelation   ssengine;       // Simple correlations for --average
 
 vector<HISTTYPE> aamajor;
 vector<HISTTYPE> aaminor;
@@ -238,16 +312,17 @@ fillWeightsWithBellmanBudge(majorweights, minorweights);
 
 	// process the command-line options
 	checkOptions(options, argc, argv);
-
-	vector<vector<vector<HISTTYPE> > > histograms;
-	histograms.resize(segments);
+	keyengine.setProfiles(majorweights.data(), minorweights.data());
+	aaengine.setProfiles(aamajor.data(), aaminor.data());
+	kpengine.setProfiles(kpmajor.data(), kpminor.data());
+	ssengine.setProfiles(ssmajor.data(), ssminor.data());
+
+	// pitch-class histograms of each segment
+	vector<vector<HISTTYPE> > basehist;
+	basehist.resize(segments);
 	for (int i=0; i<segments; i++) {
-		histograms[i].resize(i+1);
-		for (int j=0; j<i+1; j++) {
-			histograms[i][j].resize(14);   // index 12 is for best key result
-									              // index 13 for second best key result
-			std::fill(histograms[i][j].begin(), histograms[i][j].end(), 0);
-		}
+		basehist[i].resize(12);   // one value for each pitch class
+		std::fill(basehist[i].begin(), basehist[i].end(), 0);
 	}
 
 	HumdrumFile infile;
@@ -261,36 +336,45 @@ fillWeightsWithBellmanBudge(majorweights, minorweights);
 	if (fnlength != 0) {
 		if (strcmp(filename + (fnlength - 4), ".mid") == 0) {
 			filetype = MIDIFILE;
-			totalduration = loadHistogramFromMidiFile(
-					histograms[(int)histograms.size()-1], filename, segments);
+			totalduration = loadHistogramFromMidiFile(basehist, filename,
+					segments);
 		} else {
 			filetype = HUMDRUMFILE;
-			totalduration = loadHistogramFromHumdrumFile(
-					histograms[(int)histograms.size()-1], infile, filename, segments);
+			totalduration = loadHistogramFromHumdrumFile(basehist, infile,
+					filename, segments);
 		}
 	} else {
 		filetype = HUMDRUMFILE;
-		totalduration = loadHistogramFromHumdrumFile(
-					histograms[(int)histograms.size()-1], infile, filename, segments);
+		totalduration = loadHistogramFromHumdrumFile(basehist, infile,
+				filename, segments);
 	}
 	if ((filetype != HUMDRUMFILE) && numberQ) {
 		// turn off barline numbering axis if input file is not a Humdrum file
 		numberQ = 0;
 	}
 
-	fillAllHistograms(histograms);
+	keyengine.setSegments(basehist);
 
 	if (corQ) {
-		printKeyAnalysisCorr(histograms, corlevel);
+		printKeyAnalysisCorr(segments, corlevel);
 		exit(0);
 	}
 
 	if (histQ) {
-		// printBaseHistogram(histograms[(int)histograms.size()-1]);
-		printBaseHistogramHumdrumStyle(histograms[(int)histograms.size()-1],
-				totalduration);
+		// printBaseHistogram(basehist);
+		printBaseHistogramHumdrumStyle(basehist, totalduration);
 		exit(0);
 	}
+
+	if (!(blankQ || rawQ || khistQ)) {
+		// no post-processing of the keyscape is needed, so calculate
+		// the rows of the image as they are printed.
+		printPPM(NULL, segments, infile);
+		return 0;
+	}
+
+	KeyscapeTriangle histograms;
+	histograms.resize(segments);
 	//printNormalizedHistogram(histograms[0]);
 	//printBaseHistogram(histograms[1]);
 	//cout << "========================" << endl;
@@ -315,7 +399,7 @@ fillWeightsWithBellmanBudge(majorweights, minorweights);
 		exit(0);
 	}
 
-	printPPM(histograms, infile);
+	printPPM(&histograms, segments, infile);
 
 	return 0;
 }
@@ -328,7 +412,7 @@ fillWeightsWithBellmanBudge(majorweights, minorweights);
 // doBlankAnalysis -- remove non-plausible key analysis regions.
 //
 
-void doBlankAnalysis(vector<vector<vector<HISTTYPE> > >& histograms) {
+void doBlankAnalysis(KeyscapeTriangle& histograms) {
 
 	vector<vector<int> > mask;
 	doRegionID(mask, histograms);
@@ -355,7 +439,7 @@ void doBlankAnalysis(vector<vector<vector<HISTTYPE> > >& histograms) {
 //
 
 void doRegionID(vector<vector<int> >& mask,
-		vector<vector<vector<HISTTYPE> > >& histograms) {
+		KeyscapeTriangle& histograms) {
 
 	mask.resize(histograms.size());
 	int mcounter = 1;
@@ -406,7 +490,7 @@ void doRegionID(vector<vector<int> >& mask,
 // doFillBlanks --
 //
 
-void doFillBlanks(vector<vector<vector<HISTTYPE> > >& histograms,
+void doFillBlanks(KeyscapeTriangle& histograms,
 		vector<vector<int> >& mask) {
 
 	int blankcount;
@@ -602,7 +686,7 @@ void doFillBlanks(vector<vector<vector<HISTTYPE> > >& histograms,
 // fillSurroundedBlanks --
 //
 
-void fillSurroundedBlanks(vector<vector<vector<HISTTYPE> > >& histograms,
+void fillSurroundedBlanks(KeyscapeTriangle& histograms,
 		vector<vector<int> >& mask, vector<int> blanksonrow) {
 
 	// Examine blank spots to see if they are completely
@@ -654,7 +738,7 @@ void fillSurroundedBlanks(vector<vector<vector<HISTTYPE> > >& histograms,
 //
 
 void doTrim(vector<vector<int> >& mask,
-		vector<vector<vector<HISTTYPE> > >& histograms) {
+		KeyscapeTriangle& histograms) {
 
 	int i, j;
 	int bottom = (int)mask.size()-1;
@@ -684,7 +768,7 @@ void doTrim(vector<vector<int> >& mask,
 //   which touch the leading and trailing edge of the plot.
 //
 
-void trimEdges(vector<vector<vector<HISTTYPE> > >& histograms) {
+void trimEdges(KeyscapeTriangle& histograms) {
 	int i, j;
 	int target = int(histograms[0][0][12]+0.1);
 	int state = -1;
@@ -701,7 +785,7 @@ void trimEdges(vector<vector<vector<HISTTYPE> > >& histograms) {
 	}
 
 	state = -1;
-	vector<vector<vector<HISTTYPE> > >& h = histograms;
+	KeyscapeTriangle& h = histograms;
 
 	for (i=0; i<(int)histograms.size()-limiter; i++) {
 		if ((state < 0) && ((int)histograms[i][h[i].size()-1][12] != target)) {
@@ -793,7 +877,7 @@ void trimEdges(vector<vector<vector<HISTTYPE> > >& histograms) {
 //
 
 void trimRegion(int start, int end, vector<vector<int> >& mask,
-		vector<vector<vector<HISTTYPE> > >& histograms, int color) {
+		KeyscapeTriangle& histograms, int color) {
 	double trimratio = 1.1;
 
 //color = 24;
@@ -936,7 +1020,7 @@ int isValidCell(int line, int col, vector<vector<int> >& mask) {
 //
 
 void fillBoundedArea(double target, int regionid, int line, int col,
-		vector<vector<int> >& mask, vector<vector<vector<double> > >& histograms) {
+		vector<vector<int> >& mask, KeyscapeTriangle& histograms) {
 	if ((line < 0) || (line > (int)mask.size()-1)) {
 		return;  // out of bounds.
 	}
@@ -966,7 +1050,7 @@ void fillBoundedArea(double target, int regionid, int line, int col,
 //
 
 void recurseMarkMask(vector<vector<int> >& mask,
-		vector<vector<vector<HISTTYPE> > >& hist, int starti, int startj,
+		KeyscapeTriangle& hist, int starti, int startj,
 		int mcounter) {
 	// check above
 	if (starti > 0) {
@@ -1040,8 +1124,7 @@ void recurseMarkMask(vector<vector<int> >& mask,
 //   level of analysis.
 //
 
-void printKeyAnalysisCorr(vector<vector<vector<HISTTYPE> > >& histograms,
-		int level) {
+void printKeyAnalysisCorr(int rows, int level) {
 	int i;
 
 	cout << "% TARGETLEVEL = " << level << "\n";
@@ -1078,21 +1161,21 @@ void printKeyAnalysisCorr(vector<vector<vector<HISTTYPE> > >& histograms,
 	cout << "%          25:  A       minor Pearson correlation value (best=21)\n";
 	cout << "%          26:  B-flat  minor Pearson correlation value (best=22)\n";
 	cout << "%          27:  B       minor Pearson correlation value (best=23)\n";
-	int size = (int)histograms.size();
-	int last = size - 1;
+	int last = rows - 1;
 	int counter = 0;
 
 	// ramp up from a lower level
 	for (i=0; i<level; i+=2) {
 		cout << counter++ << "\t";
 		cout << i+1;
-		printKeyCorrelations(histograms[last-i][0]);
+		printKeyCorrelations(rows, last-i, 0);
 		cout << "\n";
 	}
-	for (i=1; i<(int)histograms[last-level+1].size()-1; i++) {
+	// (row last-level+1 has last-level+2 cells)
+	for (i=1; i<last-level+1; i++) {
 		cout << counter++     << "\t";
 		cout << level;
-		printKeyCorrelations(histograms[last-level+1][i]);
+		printKeyCorrelations(rows, last-level+1, i);
 		cout << "\n";
 	}
 	int ii;
@@ -1100,7 +1183,7 @@ void printKeyAnalysisCorr(vector<vector<vector<HISTTYPE> > >& histograms,
 		ii = last - level + i + 1;
 		cout << counter++ << "\t";
 		cout << level-i;
-		printKeyCorrelations(histograms[ii][(int)histograms[ii].size()-1]);
+		printKeyCorrelations(rows, ii, ii);
 		cout << "\n";
 	}
 }
@@ -1109,41 +1192,20 @@ void printKeyAnalysisCorr(vector<vector<vector<HISTTYPE> > >& histograms,
 
 //////////////////////////////
 //
-// printKeyCorrelations --
+// printKeyCorrelations -- print the key correlations for the given
+//    cell of the keyscape.
 //
 
-void printKeyCorrelations(vector<HISTTYPE>& histogram) {
+void printKeyCorrelations(int rows, int row, int col) {
 	int i;
 
-	double h[24];
-	for (i=0; i<12; i++) {
-		h[i] = histogram[i];
-		h[i+12] = h[i];
-	}
+	double histogram[12];
+	keyengine.getHistogram(histogram, col, rows - row);
 
 	double keysum[24];
-
-	double testsum = 0.0;
-	for (i=0; i<12; i++) {
-		testsum += h[i];
-		keysum[i]    = pearsonCorrelation(12, majorweights.data(), h+i);
-		keysum[i+12] = pearsonCorrelation(12, minorweights.data(), h+i);
-	}
-
-	int bestkey;
-	if (testsum == 0.0) {
+	int bestkey = keyengine.correlate(keysum, histogram);
+	if (bestkey < 0) {
 		bestkey = 24;
-	} else {
-		// find max value
-		int besti = 0;
-		HISTTYPE bestsum = keysum[0];
-		for (i=1; i<24; i++) {
-			if (keysum[i] > bestsum) {
-				besti = i;
-				bestsum = keysum[i];
-			}
-		}
-		bestkey = besti;
 	}
 
 	cout << "\t" << bestkey;
@@ -1241,46 +1303,35 @@ void printColorMap(vector<const char*>& ci) {
 
 //////////////////////////////
 //
-// printPPM --
+// printPPM -- print the keyscape as a PPM image.  If histograms is
+//    NULL, then the keys are calculated a block of rows at a time as
+//    the image is printed, so that the full keyscape is never stored.
 //
 
-void printPPM(vector<vector<vector<HISTTYPE> > >& histograms,
-		HumdrumFile& infile) {
+void printPPM(KeyscapeTriangle* histograms, int rows, HumdrumFile& infile) {
+
+	int blocksize = 64;    // number of rows calculated at once if streaming
+	vector<KEYTYPE>  keys;
+	vector<KEYTYPE*> best;
+	vector<KEYTYPE*> second;
 
 	if (keyQ) {
 		// print the top-level key and exit
-		switch (int(histograms[0][0][12])) {
-			case  0: cout << "C Major"  << endl;  break;
-			case  1: cout << "D- Major" << endl;  break;
-			case  2: cout << "D Major"  << endl;  break;
-			case  3: cout << "E- Major" << endl;  break;
-			case  4: cout << "E Major"  << endl;  break;
-			case  5: cout << "F Major"  << endl;  break;
-			case  6: cout << "F# Major" << endl;  break;
-			case  7: cout << "G Major"  << endl;  break;
-			case  8: cout << "A- Major" << endl;  break;
-			case  9: cout << "A Major"  << endl;  break;
-			case 10: cout << "B- Major" << endl;  break;
-			case 11: cout << "B Major"  << endl;  break;
-			case 12: cout << "C Minor"  << endl;  break;
-			case 13: cout << "C# Minor" << endl;  break;
-			case 14: cout << "D Minor"  << endl;  break;
-			case 15: cout << "E- Minor" << endl;  break;
-			case 16: cout << "E Minor"  << endl;  break;
-			case 17: cout << "F Minor"  << endl;  break;
-			case 18: cout << "F# Minor" << endl;  break;
-			case 19: cout << "G Minor"  << endl;  break;
-			case 20: cout << "A- Minor" << endl;  break;
-			case 21: cout << "A Minor"  << endl;  break;
-			case 22: cout << "B- Minor" << endl;  break;
-			case 23: cout << "B Minor"  << endl;  break;
+		if (histograms != NULL) {
+			printKeyName((*histograms)[0][0][12]);
+		} else {
+			keys.resize(2);
+			best.assign(1, &keys[0]);
+			second.assign(1, &keys[1]);
+			calculateKeyRows(best, second, 0, rows);
+			printKeyName(keys[0]);
 		}
 		return;
 	}
 
 	// Pitch to Color translations
 
-	int scapeheight = (int)histograms.size();
+	int scapeheight = rows;
 	int scapewidth  = scapeheight * 2;
 
 	int numberheight = 0;
@@ -1297,30 +1348,34 @@ void printPPM(vector<vector<vector<HISTTYPE> > >& histograms,
 		legendwidth  = scapewidth;
 	}
 
-	#define BGCOLOR colorindex[25]
-
 	cout << "P3\n";
 	cout << scapewidth  << " "
 		  << scapeheight + legendheight + numberheight<< "\n";
 	cout << "255\n";
 
-	int blankcells;
-	int i;
-	int j;
-	const char* color;
-	for (i=0; i<scapeheight; i++) {
-		blankcells = scapeheight - (int)histograms[i].size();
-		for (j=0; j<blankcells; j++) {
-			cout << ' ' << BGCOLOR;
-		}
-		for (j=0; j<(int)histograms[i].size(); j++) {
-			color = colorindex[(int)histograms[i][j][12]];
-			cout << ' ' << color << ' ' << color;
+	string line;
+	int i, j, count;
+	for (i=0; i<scapeheight; i+=blocksize) {
+		count = scapeheight - i < blocksize ? scapeheight - i : blocksize;
+		if (histograms == NULL) {
+			// rows i to i+count-1 have at most i+count cells each
+			keys.resize(2 * count * (i + count));
+			best.resize(count);
+			second.resize(count);
+			for (j=0; j<count; j++) {
+				best[j]   = keys.data() + 2 * j * (i + count);
+				second[j] = best[j] + (i + count);
+			}
+			calculateKeyRows(best, second, i, rows);
 		}
-		for (j=0; j<blankcells; j++) {
-			cout << ' ' << BGCOLOR;
+		for (j=0; j<count; j++) {
+			if (histograms != NULL) {
+				printPPMRow(line, i+j, (*histograms)[i+j].getBest(), rows);
+			} else {
+				printPPMRow(line, i+j, best[j], rows);
+			}
+			cout << line;
 		}
-		cout << "\n";
 	}
 
 	if (numberQ) {
@@ -1334,6 +1389,75 @@ void printPPM(vector<vector<vector<HISTTYPE> > >& histograms,
 
 
 
+//////////////////////////////
+//
+// printPPMRow -- store one row of the PPM image in line.  Each cell
+//    of the keyscape is two pixels wide.
+//
+
+void printPPMRow(string& line, int row, KEYTYPE* best, int rows) {
+	#define BGCOLOR colorindex[25]
+
+	int blankcells = rows - (row + 1);
+	int j;
+	const char* color;
+	line.clear();
+	for (j=0; j<blankcells; j++) {
+		line += ' ';
+		line += BGCOLOR;
+	}
+	for (j=0; j<=row; j++) {
+		color = colorindex[(int)best[j]];
+		line += ' ';
+		line += color;
+		line += ' ';
+		line += color;
+	}
+	for (j=0; j<blankcells; j++) {
+		line += ' ';
+		line += BGCOLOR;
+	}
+	line += '\n';
+}
+
+
+
+//////////////////////////////
+//
+// printKeyName -- print the name of a key (0-23).
+//
+
+void printKeyName(int key) {
+	switch (key) {
+		case  0: cout << "C Major"  << endl;  break;
+		case  1: cout << "D- Major" << endl;  break;
+		case  2: cout << "D Major"  << endl;  break;
+		case  3: cout << "E- Major" << endl;  break;
+		case  4: cout << "E Major"  << endl;  break;
+		case  5: cout << "F Major"  << endl;  break;
+		case  6: cout << "F# Major" << endl;  break;
+		case  7: cout << "G Major"  << endl;  break;
+		case  8: cout << "A- Major" << endl;  break;
+		case  9: cout << "A Major"  << endl;  break;
+		case 10: cout << "B- Major" << endl;  break;
+		case 11: cout << "B Major"  << endl;  break;
+		case 12: cout << "C Minor"  << endl;  break;
+		case 13: cout << "C# Minor" << endl;  break;
+		case 14: cout << "D Minor"  << endl;  break;
+		case 15: cout << "E- Minor" << endl;  break;
+		case 16: cout << "E Minor"  << endl;  break;
+		case 17: cout << "F Minor"  << endl;  break;
+		case 18: cout << "F# Minor" << endl;  break;
+		case 19: cout << "G Minor"  << endl;  break;
+		case 20: cout << "A- Minor" << endl;  break;
+		case 21: cout << "A Minor"  << endl;  break;
+		case 22: cout << "B- Minor" << endl;  break;
+		case 23: cout << "B Minor"  << endl;  break;
+	}
+}
+
+
+
 ///////////////////////////////
 //
 // printNumbers -- print Barline numbers as ticks underneath
@@ -1577,25 +1701,93 @@ void printLegend(int legendheight, int legendwidth) {
 
 //////////////////////////////
 //
-// calculateBestKeys --
+// calculateBestKeys -- calculate the best and second-best keys of
+//    every cell in the keyscape.
 //
 
-void calculateBestKeys(vector<vector<vector<HISTTYPE> > >& histograms) {
-	for (int i=0; i<(int)histograms.size(); i++) {
-		for (int j=0; j<(int)histograms[i].size(); j++) {
-			 identifyKeyDouble(histograms[i][j]);
+void calculateBestKeys(KeyscapeTriangle& histograms) {
+	int rows = (int)histograms.size();
+	vector<KEYTYPE*> best(rows);
+	vector<KEYTYPE*> second(rows);
+	for (int i=0; i<rows; i++) {
+		best[i]   = histograms[i].getBest();
+		second[i] = histograms[i].getSecond();
+	}
+	calculateKeyRows(best, second, 0, rows);
+}
+
+
+
+//////////////////////////////
+//
+// calculateKeyRows -- calculate the best and second-best keys for
+//    the cells of best.size() consecutive keyscape rows, starting at
+//    startrow, and store them in best[i] and second[i].  The rows are
+//    shared between threads, starting with the longest rows.
+//
+
+void calculateKeyRows(vector<KEYTYPE*>& best, vector<KEYTYPE*>& second,
+		int startrow, int rows) {
+	int count = (int)best.size();
+	atomic<int> next(count - 1);
+	auto worker = [&]() {
+		double histogram[12];
+		int i, j, row;
+		while ((i = next--) >= 0) {
+			row = startrow + i;
+			for (j=0; j<=row; j++) {
+				keyengine.getHistogram(histogram, j, rows - row);
+				identifyKeyDouble(histogram, best[i][j], second[i][j]);
+			}
 		}
+	};
+
+	int threads = getThreadCount();
+	if (threads > count) {
+		threads = count;
+	}
+	if (threads <= 1) {
+		worker();
+		return;
+	}
+	vector<thread> pool;
+	pool.reserve(threads);
+	for (int t=0; t<threads; t++) {
+		pool.push_back(thread(worker));
+	}
+	for (int t=0; t<threads; t++) {
+		pool[t].join();
 	}
 }
 
 
 
+//////////////////////////////
+//
+// getThreadCount -- return the number of threads to use when
+//    calculating keys.  A --threads value of 0 (the default) uses one
+//    thread for each processor core.
+//
+
+int getThreadCount(void) {
+	if (threadcount > 0) {
+		return threadcount;
+	}
+	int cores = (int)thread::hardware_concurrency();
+	return cores > 0 ? cores : 1;
+}
+
+
+
 ////////////////////////////////////////
 //
-// identifyKeyDouble --
+// identifyKeyDouble -- find the best and second-best keys for a
+//    12-bin pitch-class histogram.  Called from several threads at once,
+//    so it must only read global variables.
 //
 
-void identifyKeyDouble(vector<HISTTYPE>& histogram) {
+void identifyKeyDouble(const double* histogram, KEYTYPE& best,
+		KEYTYPE& second) {
 	int i;
 
 	double h[24];
@@ -1615,8 +1807,8 @@ void identifyKeyDouble(vector<HISTTYPE>& histogram) {
 	}
 
 	if (testsum == 0.0) {
-		histogram[12] = 24;  // empty histogram, so going to display black
-		histogram[13] = 24;  // empty histogram, so going to display black
+		best   = 24;  // empty histogram, so going to display black
+		second = 24;  // empty histogram, so going to display black
 		return;
 	}
 
@@ -1642,34 +1834,22 @@ void identifyKeyDouble(vector<HISTTYPE>& histogram) {
          keysum[maxi] += 1.0;
       }
    } else if (!averageQ) {
-		for (i=0; i<12; i++) {
-			keysum[i]    = pearsonCorrelation(12, majorweights.data(), h+i);
-			keysum[i+12] = pearsonCorrelation(12, minorweights.data(), h+i);
-		}
+		keyengine.correlate(keysum, histogram);
 	} else {
-		for (i=0; i<12; i++) {
-			keysum[i]    = pearsonCorrelation(12, majorweights.data(), h+i);
-			keysum[i+12] = pearsonCorrelation(12, minorweights.data(), h+i);
-
-/*
-			keysum[i]    = 3 * pearsonCorrelation(12, aamajor.data(), h+i);
-			keysum[i+12] = 3 * pearsonCorrelation(12, aaminor.data(), h+i);
-
-			//keysum[i]    += 2 * pearsonCorrelation(12, bbmajor.data(), h+i);
-			//keysum[i+12] += 2 * pearsonCorrelation(12, bbminor.data(), h+i);
-
-			keysum[i]    += pearsonCorrelation(12, kpmajor.data(), h+i);
-			keysum[i+12] += pearsonCorrelation(12, kpminor.data(), h+i);
-
-			keysum[i]    += 8 * pearsonCorrelation(12, ssmajor.data(), h+i);
-			keysum[i+12] += 8 * pearsonCorrelation(12, ssminor.data(), h+i);
-
-			//keysum[i]    += pearsonCorrelation(12, kkmajor.data(), h+i);
-			//keysum[i+12] += pearsonCorrelation(12, kkminor.data(), h+i);
-
-			keysum[i]    /= 12.0;
-			keysum[i+12] /= 12.0;
-*/
+		// weighted average of the correlations for several profiles
+		double scores[24];
+		aaengine.correlate(scores, histogram);
+		for (i=0; i<24; i++) {
+			keysum[i] = 3 * scores[i];
+		}
+		kpengine.correlate(scores, histogram);
+		for (i=0; i<24; i++) {
+			keysum[i] += scores[i];
+		}
+		ssengine.correlate(scores, histogram);
+		for (i=0; i<24; i++) {
+			keysum[i] += 8 * scores[i];
+			keysum[i] /= 12.0;
 		}
 	}
 
@@ -1696,15 +1876,13 @@ void identifyKeyDouble(vector<HISTTYPE>& histogram) {
 		}
 	}
 
-	histogram[12] = besti;
-	histogram[13] = secondbesti;
+	best   = besti;
+	second = secondbesti;
 
 	// if second-best key being displayed, switch order of values:
 	if (secondQ) {
-		int temp;
-		temp = histogram[12];
-		histogram[12] = histogram[13];
-		histogram[13] = temp;
+		best   = secondbesti;
+		second = besti;
 	}
 
 }
@@ -1782,32 +1960,12 @@ void identifyKey(vector<HISTTYPE>& histogram) {
 
 
 
-//////////////////////////////
-//
-// fillAllHistograms --
-//
-
-void fillAllHistograms(vector<vector<vector<HISTTYPE> > >& histograms) {
-	int size = (int)histograms.size();
-	int i, j, k;
-	for (i=size-2; i>=0; i--) {
-		for (j=0; j<(int)histograms[i].size(); j++) {
-			for (k=0; k<12; k++) {
-				histograms[i][j][k] = histograms[i+1][j][k] +
-									       histograms[size-1][size-1-i+j][k];
-			}
-		}
-	}
-}
-
-
-
 //////////////////////////////
 //
 // displayAnalysisHistogram --
 //
 
-void displayAnalysisHistogram(vector<vector<vector<HISTTYPE> > >& histograms) {
+void displayAnalysisHistogram(KeyscapeTriangle& histograms) {
 	int i, j;
 	int key = 0;
 	int size = (int)histograms.size();
@@ -1894,7 +2052,7 @@ int ranksort(const void* A, const void* B) {
 // displayRawAnalysis --
 //
 
-void displayRawAnalysis(vector<vector<vector<HISTTYPE> > >& histogram) {
+void displayRawAnalysis(KeyscapeTriangle& histogram) {
 	int i, j;
 	int key;
 	for (i=0; i<(int)histogram.size(); i++) {
@@ -1993,7 +2151,7 @@ void printNormalizedHistogram(vector<vector<HISTTYPE> >& histogram) {
 // printBest --
 //
 
-void printBest(vector<vector<vector<HISTTYPE> > >& histogram) {
+void printBest(KeyscapeTriangle& histogram) {
 	int i;
 	int j;
 	for (i=0; i<(int)histogram.size(); i++) {
@@ -2220,43 +2378,6 @@ double loadHistogramFromMidiFile(vector<vector<HISTTYPE> >& histogram,
 
 
 
-//////////////////////////////
-//
-// pearsonCorrelation --
-//
-
-double pearsonCorrelation(int size, double* x, double* y) {
-
-	double sumx  = 0.0;
-	double sumy  = 0.0;
-	double sumco = 0.0;
-	double meanx = x[0];
-	double meany = y[0];
-	double sweep;
-	double deltax;
-	double deltay;
-
-	int i;
-	for (i=2; i<=size; i++) {
-		sweep = (i-1.0) / i;
-		deltax = x[i-1] - meanx;
-		deltay = y[i-1] - meany;
-		sumx  += deltax * deltax * sweep;
-		sumy  += deltay * deltay * sweep;
-		sumco += deltax * deltay * sweep;
-		meanx += deltax / i;
-		meany += deltay / i;
-	}
-
-	double popsdx = sqrt(sumx / size);
-	double popsdy = sqrt(sumy / size);
-	double covxy  = sumco / size;
-
-	return covxy / (popsdx * popsdy);
-}
-
-
-
 //////////////////////////////
 //
 // checkOptions --
@@ -2295,6 +2416,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("ss|simple|sapp=b",   "load Simple weights");
 
 	opts.define("khist=b", "display the analysis key histogram");
+	opts.define("threads=i:0", "number of threads (0 = one per core)");
 	opts.define("author=b",  "author of program");
 	opts.define("version=b", "compilation info");
 	opts.define("example=b", "example usages");
@@ -2323,7 +2445,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	numberQ   =  opts.getBoolean("number");
 	blankQ    =  opts.getBoolean("blank");
 	fillQ     =  opts.getBoolean("fill");
-	averageQ  = !opts.getBoolean("average");
+	averageQ  =  opts.getBoolean("average");
    maxQ      =  opts.getBoolean("max");
 	secondQ   =  opts.getBoolean("second");
 	keyQ      =  opts.getBoolean("key");
@@ -2399,6 +2521,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 
 	corQ     = opts.getBoolean("cor");
 	corlevel = opts.getInteger("cor");
+	threadcount = opts.getInteger("threads");
 
 	if (opts.getBoolean("mapping")) {
 		changeColorMapping(colorindex, opts.getString("mapping").c_str());
@@ -8,6 +8,7 @@
 // Last Modified: Sun Oct 20 17:41:10 PDT 2013 Fixed tie problem
 // Last Modified: Tue Nov 12 14:37:11 PST 2013 Added column for measure duration
 // Last Modified: Sat Mar 12 20:41:25 PST 2016 Switched to STL
+// Last Modified: Mon Oct 19 02:58:20 PDT 2026 Fixed dangling option strings
 // Filename:      ...sig/examples/all/notearray.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/notearray.cpp
 // Syntax:        C++; museinfo
@@ -128,8 +129,8 @@ RationalNumber Absoffset;      // used with --sa option
 
 const char* commentStart = "%";
 const char* commentStop  = "";
-const char* mathvar  = "data"; // used with --mathematica option
-const char* beatbase = "";     // used with -t option
+string      mathvar  = "data"; // used with --mathematica option
+string      beatbase = "";     // used with -t option
 
 
 ///////////////////////////////////////////////////////////////////////////
@@ -167,7 +168,7 @@ int main(int argc, char** argv) {
          infile.read(options.getArg(i+1));
       }
       // analyze the input file according to command-line options
-      infile.analyzeRhythm(beatbase);
+      infile.analyzeRhythm(beatbase.c_str());
       getMeasureDurations(bardur, infile);
       getBeatDurations(beatdur, infile);
 
@@ -1421,7 +1422,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
       // beatbase  = "1";  // beat is the whole note.
       doubleQ   = 1;
    } else {
-      beatbase  = opts.getString("beat").c_str();
+      beatbase  = opts.getString("beat");
       doubleQ   = opts.getBoolean("double");
    }
 
@@ -1451,7 +1452,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    }
 
    mathQ     =  opts.getBoolean("mathematica");
-   mathvar   =  opts.getString("mathematica").c_str();
+   mathvar   =  opts.getString("mathematica");
    commentStart = "(* ";
    commentStop  = " *)";
 
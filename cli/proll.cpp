@@ -139,6 +139,7 @@ int main(int argc, char* argv[]) {
 
 void createJsonProll(HumdrumFile& infile) {
 	infile.analyzeRhythm("4");
+	infile.analyzeTies();
 	vector<int> ktracks;
 	infile.getTracksByExInterp(ktracks, "**kern");
 	vector<int> rktracks(infile.getMaxTracks()+1, -1);
@@ -955,6 +956,7 @@ int generatePicture(HumdrumFile& infile, vector<PixelRow>& picture, int
 	PixelColor matchcolor(255,255,255);
 
 	infile.analyzeRhythm("4");
+	infile.analyzeTies();
 	int min = infile.getMinTimeBase();
 	double totaldur = infile.getTotalDuration();
 	
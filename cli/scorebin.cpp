@@ -0,0 +1,143 @@
+//
+// Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
+// Creation Date: Mon Oct 19 03:29:12 PDT 2026
+// Last Modified: Mon Oct 19 03:29:15 PDT 2026
+// Filename:      ...sig/examples/all/scorebin.cpp
+// Web Address:   http://sig.sapp.org/examples/museinfo/score/scorebin.cpp
+// Syntax:        C++; museinfo
+//
+// Description:   Convert a SCORE page between the PMX text format and
+//                the binary file format.  The input may be in either
+//                format.
+//
+
+#include "humdrum.h"
+#include "ScorePageBase.h"
+
+#include <stdlib.h>
+
+#ifndef OLDCPP
+   #include <iostream>
+#else
+   #include <iostream.h>
+#endif
+
+// function declarations:
+void      checkOptions      (Options& opts, int argc, char** argv);
+void      example           (void);
+void      usage             (const char* command);
+
+// user interface variables:
+Options     options;
+int         asciiQ    = 0;    // used with -a option
+int         winscoreQ = 0;    // used with -w option
+int         outputQ   = 0;    // used with -o option
+string      outfile   = "";   // used with -o option
+int         verboseQ  = 0;    // used with -v option
+
+//////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   checkOptions(options, argc, argv);
+
+   ScorePageBase score;
+   score.readFile(options.getArg(1).c_str(), verboseQ);
+
+   if (asciiQ) {
+      score.printAscii(cout, 1, verboseQ);
+      return 0;
+   }
+
+   if (winscoreQ) {
+      score.setVersionWinScore();
+   } else {
+      score.setVersion(3.0);
+   }
+
+   if (outputQ) {
+      score.writeBinary(outfile.c_str());
+   } else {
+      score.writeBinary(cout);
+   }
+
+   return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+
+
+//////////////////////////////
+//
+// checkOptions --
+//
+
+void checkOptions(Options& opts, int argc, char* argv[]) {
+   opts.define("a|ascii|pmx=b",  "print the data in the PMX text format");
+   opts.define("w|winscore=b",   "write a four-byte number count");
+   opts.define("o|output=s",     "write binary data to the given file");
+   opts.define("v|verbose=b",    "print the data while reading it");
+
+   opts.define("author=b",  "author of program");
+   opts.define("version=b", "compilation info");
+   opts.define("example=b", "example usages");
+   opts.define("h|help=b",  "short description");
+   opts.process(argc, argv);
+
+   // handle basic options:
+   if (opts.getBoolean("author")) {
+      cout << "Written by Craig Stuart Sapp, "
+           << "craig@ccrma.stanford.edu, 19 October 2026" << endl;
+      exit(0);
+   } else if (opts.getBoolean("version")) {
+      cout << argv[0] << ", version: 19 October 2026" << endl;
+      cout << "compiled: " << __DATE__ << endl;
+      exit(0);
+   } else if (opts.getBoolean("help")) {
+      usage(opts.getCommand().c_str());
+      exit(0);
+   } else if (opts.getBoolean("example")) {
+      example();
+      exit(0);
+   }
+
+   if (opts.getArgCount() != 1) {
+      cerr << "Usage: " << opts.getCommand() << " input.mus" << endl;
+      exit(1);
+   }
+
+   asciiQ    = opts.getBoolean("ascii");
+   winscoreQ = opts.getBoolean("winscore");
+   outputQ   = opts.getBoolean("output");
+   outfile   = opts.getString("output");
+   verboseQ  = opts.getBoolean("verbose");
+}
+
+
+
+//////////////////////////////
+//
+// example --
+//
+
+void example(void) {
+   cout << "# convert PMX data into a binary file:\n"
+        << "   scorebin input.pmx > output.mus\n"
+        << "# print a binary file as PMX data:\n"
+        << "   scorebin -a input.mus\n"
+        << endl;
+}
+
+
+
+//////////////////////////////
+//
+// usage --
+//
+
+void usage(const char* command) {
+   cout << "Usage: " << command << " [-a|-w] [-o output.mus] input" << endl;
+}
+
+
+
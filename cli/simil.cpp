@@ -4,6 +4,8 @@
 //                   Waterloo, Ontario.
 // Creation Date: Tue Nov 17 14:35:26 PST 2009
 // Last Modified: Tue Dec  8 20:06:25 PST 2009
+// Last Modified: Sun Oct 18 19:36:50 PDT 2026 interned tokens, bit-parallel
+//                                             distances, threads, file lists
 // Filename:      ...sig/examples/all/simil.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/simil.cpp
 // Syntax:        C++; museinfo
@@ -17,6 +19,7 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <math.h>
 
 #ifndef OLDCPP
@@ -27,6 +30,29 @@
    #include <fstream.h>
 #endif
 
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+// SimilSequence -- a sequence of tokens for the edit-distance
+// calculations.  The tokens are interned as integers so that they
+// can be compared without strcmp, and the comparison with the previous
+// token (used for the repeated-element weights) is done once.
+class SimilSequence {
+   public:
+      string                filename;
+      Array<Array<char> >   data;      // original token strings
+      vector<int>           tokens;    // interned tokens
+      vector<char>          repeats;   // token is same as previous one
+      Array<double>         sresults;  // results from usual_thing
+      Array<Array<double> > mresults;  // results from unusual_thing
+};
+
 
 // function declarations:
 void      checkOptions          (Options& opts, int argc, char** argv);
@@ -41,30 +67,39 @@ int       chooseSpine           (const char* interp, HumdrumFile& infile);
 void      fillSourceData        (Array<Array<char> >& sourcedata, 
                                  Array<int>& datalines, 
 		                 HumdrumFile& infile, int spine, int nulltest);
-void      usual_thing           (Array<double>& results, 
-                                 Array<Array<char> >& sourcedata, 
-                                 Array<Array<char> >& templatedata);
-void      unusual_thing         (Array<Array<double> >& results, 
-                                 Array<Array<char> >& sourcedata, 
-				 Array<Array<char> >& templatedata, 
-                                 int sublen);
+void      internSequence        (SimilSequence& sequence, 
+                                 map<string, int>& dictionary);
+void      makeMatchMasks        (vector<uint64_t>& masks, 
+                                 SimilSequence& templatedata, int sublen,
+                                 int symbols);
+void      prepareResults        (SimilSequence& source, 
+                                 SimilSequence& templatedata, int sublen);
+int       getResultCount        (SimilSequence& source);
+void      usual_thing           (SimilSequence& source, 
+                                 SimilSequence& templatedata, 
+                                 const uint64_t* masks, int symbols,
+                                 int start, int stop, double* scratch);
+void      unusual_thing         (SimilSequence& source, 
+                                 SimilSequence& templatedata, int sublen,
+                                 const uint64_t* masks, int symbols,
+                                 int start, int stop, double* scratch);
+void      calculateDistances    (vector<SimilSequence>& sources, 
+                                 SimilSequence& templatedata);
+int       getThreadCount        (void);
 void      printResults          (Array<double>& results, 
                                  Array<Array<char> >& sourcedata,
                                  Array<Array<char> >& templatedata);
 void      printResultsSubString (Array<Array<double> >& results, 
                                  Array<Array<char> >& sourcedata, 
                                  Array<Array<char> >& templatedata);
-double    dlv                   (Array<Array<char> >& s1, int offset1, 
-                                 Array<Array<char> >& s2, int offset2);
-void      doDamerauLevenshteinAnalysis(Array<Array<char> >& sourcedata, 
-                                 Array<Array<char> >& templatedata);
-double    dlvcharstar           (char** set1, int len1, char** set2, int len2);
-double    dlvstring             (Array<Array<char> >& set1, int offset1, 
-                                 Array<Array<char> >& set2, int offset2,
-                                 int temlen);
+void      doDamerauLevenshteinAnalysis(vector<SimilSequence>& sources, 
+                                 SimilSequence& templatedata);
+double    dlvtokens             (const int* s1, const char* rep1, 
+                                 const int* s2, const char* rep2, int len,
+                                 int firstrep, double* scratch);
+double    dlvbits               (const uint64_t* masks, int symbols,
+                                 const int* s1, int len);
 double    dlvint                (int *s1, int len1, int *s2, int len2);
-double    dlv                   (Array<Array<char> >& set1, int offset1, 
-                                 Array<Array<char> >& set2, int offset2);
 int       getMinIndex           (Array<double>& list);
 void      printSubStringInfo    (Array<double>& list, double target);
 void      printWeights          (void);
@@ -87,6 +122,8 @@ int         prependQ  = 0;   // used with -p option (not implemented)
 int         sequenceQ = 0;   // used with -s option
 int         spacesQ   = 1;   // used with -S option
 double      threshold = 0.0; // used with -t option
+int         threadcount = 0; // used with --threads option
+int         unitQ     = 1;   // all edit weights are 1.0
 
 double      weight_R1 = 1.0; // --R1: deleting a repeated element of S1
 double      weight_R2 = 1.0; // --R2: deleting a repeated element of S2
@@ -104,50 +141,68 @@ int main(int argc, char** argv) {
    // process the command-line options
    checkOptions(options, argc, argv);
    HumdrumFile infile;
-   Array<Array<char> > templatedata;
-   Array<Array<char> > sourcedata;
+   SimilSequence templatedata;
    Array<int> datalines;
+   int argcount = options.getArgCount();
 
-   if ((options.getArgCount() < 1) || (options.getArgCount() > 2)) {
+   if (argcount < 1) {
       usage(options.getCommand().c_str());
       exit(1);
    }
+   vector<SimilSequence> sources(argcount >= 2 ? argcount - 1 : 1);
 
-   int sourcearg   = 1;
-   int templatearg = 2;
+   // With more than two files, the template is the last file (or the
+   // first file with -r), and the other files are the sources.
+   int templatearg = argcount;
+   int firstsource = 1;
    if (reverseQ) {
-      sourcearg   = 2;
       templatearg = 1;
+      firstsource = 2;
    }
    
-   if (options.getArgCount() == 2) {
-      infile.read(options.getArg(sourcearg));
-      readTemplateContents(templatedata, options.getArg(templatearg).c_str());
-
+   if (argcount >= 2) {
+      readTemplateContents(templatedata.data, 
+            options.getArg(templatearg).c_str());
+      for (int i=0; i<(int)sources.size(); i++) {
+         sources[i].filename = options.getArg(firstsource + i);
+      }
    } else {
       // read second file from standard input
-      if (sourcearg == 1) {
-         infile.read(options.getArg(1));
-	 readTemplateContents(templatedata, cin);
+      if (!reverseQ) {
+         sources[0].filename = options.getArg(1);
+	 readTemplateContents(templatedata.data, cin);
       } else {
-         infile.read(cin);
-	 readTemplateContents(templatedata, options.getArg(1).c_str());
+	 readTemplateContents(templatedata.data, options.getArg(1).c_str());
       }
    }
 
-   int spine = chooseSpine(interp, infile);
+   // Template tokens are interned first, so that source tokens which
+   // are not in the template have numbers >= the template symbol count.
+   map<string, int> dictionary;
+   internSequence(templatedata, dictionary);
 
-   fillSourceData(sourcedata, datalines, infile, spine, nullQ);
+   for (int i=0; i<(int)sources.size(); i++) {
+      if (sources[i].filename.empty()) {
+         infile.read(cin);
+      } else {
+         infile.read(sources[i].filename);
+      }
+      int spine = chooseSpine(interp, infile);
+      fillSourceData(sources[i].data, datalines, infile, spine, nullQ);
+      internSequence(sources[i], dictionary);
+   }
 
    if (debugQ) {
-      cout << "SOURCE DATA: " << endl;
-      printTemplate(sourcedata);
+      for (int i=0; i<(int)sources.size(); i++) {
+         cout << "SOURCE DATA: " << endl;
+         printTemplate(sources[i].data);
+      }
       cout << "TEMPLATE DATA: " << endl;
-      printTemplate(templatedata);
+      printTemplate(templatedata.data);
    }
         
 
-   doDamerauLevenshteinAnalysis(sourcedata, templatedata);
+   doDamerauLevenshteinAnalysis(sources, templatedata);
 
    if (pweightQ) {
       printWeights();
@@ -372,6 +427,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    options.define("s|sequence=b",      "print search sequences");
    options.define("S|no-spaces=b",     "print search sequences without spaces");
    options.define("t|threshold=d:0.0", "similarity threshold for output");
+   options.define("threads=i:0",       "number of threads (0 = one per core)");
 
    options.define("R1|r1=d:1.0", "scr for deleting a repeated element of S1");
    options.define("R2|r2=d:1.0", "scr for deleting a repeated element of S2");
@@ -436,6 +492,11 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    if (options.getBoolean("S1")) { weight_S1 = options.getDouble("S1"); }
    if (options.getBoolean("S2")) { weight_S2 = options.getDouble("S2"); }
    if (options.getBoolean("S3")) { weight_S3 = options.getDouble("S3"); }
+
+   threadcount = options.getInteger("threads");
+   unitQ = (weight_R1 == 1.0) && (weight_R2 == 1.0) && (weight_D1 == 1.0) &&
+           (weight_D2 == 1.0) && (weight_S0 == 1.0) && (weight_S1 == 1.0) &&
+           (weight_S2 == 1.0) && (weight_S3 == 1.0);
 }
 
 
@@ -471,17 +532,22 @@ void usage(const char* command) {
 // doDamerauLevenshteinAnalysis --
 //
 
-void doDamerauLevenshteinAnalysis(Array<Array<char> >& sourcedata, 
-      Array<Array<char> >& templatedata) {
+void doDamerauLevenshteinAnalysis(vector<SimilSequence>& sources, 
+      SimilSequence& templatedata) {
    
-   if (xlen <= 0) {
-      Array<double> sresults;
-      usual_thing(sresults, sourcedata, templatedata);
-      printResults(sresults, sourcedata, templatedata);
-   } else {
-      Array<Array<double> > mresults;
-      unusual_thing(mresults, sourcedata, templatedata, xlen);
-      printResultsSubString(mresults, sourcedata, templatedata);
+   calculateDistances(sources, templatedata);
+
+   for (int i=0; i<(int)sources.size(); i++) {
+      if (sources.size() > 1) {
+         cout << "!!!!SEGMENT: " << sources[i].filename << "\n";
+      }
+      if (xlen <= 0) {
+         printResults(sources[i].sresults, sources[i].data, 
+               templatedata.data);
+      } else {
+         printResultsSubString(sources[i].mresults, sources[i].data, 
+               templatedata.data);
+      }
    }
 }
 
@@ -499,30 +565,241 @@ double normalize2(double d, int len) {
 
 //////////////////////////////
 //
-// unusual_thing -- Do sub-string matching
+// calculateDistances -- Calculate the edit distances for all sources.
+//    The work is split into blocks of source offsets which are
+//    processed by a pool of threads.
 //
 
-void unusual_thing(Array<Array<double> >& results, 
-      Array<Array<char> >& sourcedata, Array<Array<char> >& templatedata, 
-      int sublen) {
+void calculateDistances(vector<SimilSequence>& sources, 
+      SimilSequence& templatedata) {
 
-   int i, j;
-   int len = (int)fabs(sourcedata.getSize() - sublen + 1);
-   int subcount = templatedata.getSize() - sublen + 1;
+   int symbols = 0;
+   int i;
+   for (i=0; i<(int)templatedata.tokens.size(); i++) {
+      if (templatedata.tokens[i] >= symbols) {
+         symbols = templatedata.tokens[i] + 1;
+      }
+   }
 
-   results.setSize(0);
-   if (len <= 0) {
+   // bit masks of the template tokens are used when all weights are
+   // 1.0 and the compared sequences fit into 64 bits.
+   int sublen = xlen > 0 ? xlen : templatedata.data.getSize();
+   vector<uint64_t> masks;
+   if (unitQ && (sublen <= 64)) {
+      makeMatchMasks(masks, templatedata, sublen, symbols);
+   }
+   const uint64_t* maskdata = masks.empty() ? NULL : masks.data();
+
+   // list of (source, starting offset) work blocks
+   int blocksize = 64;
+   vector<int> worksource;
+   vector<int> workstart;
+   int count;
+   int j;
+   for (i=0; i<(int)sources.size(); i++) {
+      prepareResults(sources[i], templatedata, xlen);
+      count = getResultCount(sources[i]);
+      for (j=0; j<count; j+=blocksize) {
+         worksource.push_back(i);
+         workstart.push_back(j);
+      }
+   }
+
+   atomic<int> next(0);
+   auto worker = [&]() {
+      vector<double> scratch(templatedata.data.getSize() + 
+            (xlen > 0 ? xlen : 0) + 1);
+      int w, stop;
+      while ((w = next++) < (int)worksource.size()) {
+         SimilSequence& source = sources[worksource[w]];
+         stop = workstart[w] + blocksize;
+         if (stop > getResultCount(source)) {
+            stop = getResultCount(source);
+         }
+         if (xlen <= 0) {
+            usual_thing(source, templatedata, maskdata, symbols, 
+                  workstart[w], stop, scratch.data());
+         } else {
+            unusual_thing(source, templatedata, xlen, maskdata, symbols, 
+                  workstart[w], stop, scratch.data());
+         }
+      }
+   };
+
+   int threads = getThreadCount();
+   if (threads > (int)worksource.size()) {
+      threads = (int)worksource.size();
+   }
+   if (threads <= 1) {
+      worker();
       return;
    }
-   results.setSize(len);
+   vector<thread> pool;
+   for (i=0; i<threads; i++) {
+      pool.push_back(thread(worker));
+   }
+   for (i=0; i<threads; i++) {
+      pool[i].join();
+   }
+}
 
-   for (i=0; i<results.getSize(); i++) {
-      results[i].setSize(subcount);
+
+
+//////////////////////////////
+//
+// getThreadCount -- Number of threads to use for the calculations
+//     (one per processor core if --threads is not given).
+//
+
+int getThreadCount(void) {
+   if (threadcount > 0) {
+      return threadcount;
    }
+   int cores = (int)thread::hardware_concurrency();
+   return cores > 0 ? cores : 1;
+}
 
-   for (i=0; i<len; i++) {
+
+
+//////////////////////////////
+//
+// internSequence -- Convert the token strings of a sequence into
+//     integers.  Tokens not yet in the dictionary are added to it.
+//
+
+void internSequence(SimilSequence& sequence, map<string, int>& dictionary) {
+   int size = sequence.data.getSize();
+   sequence.tokens.resize(size);
+   sequence.repeats.resize(size);
+   int i;
+   for (i=0; i<size; i++) {
+      string token = sequence.data[i].getBase();
+      auto entry = dictionary.find(token);
+      if (entry == dictionary.end()) {
+         int value = (int)dictionary.size();
+         dictionary[token] = value;
+         sequence.tokens[i] = value;
+      } else {
+         sequence.tokens[i] = entry->second;
+      }
+      sequence.repeats[i] = (i > 0) && 
+            (sequence.tokens[i] == sequence.tokens[i-1]);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// makeMatchMasks -- For each starting position in the template, store
+//     a bit mask for each template symbol, with bit k set if the
+//     token at k positions after the start is that symbol.
+//
+
+void makeMatchMasks(vector<uint64_t>& masks, SimilSequence& templatedata,
+      int sublen, int symbols) {
+   int size = (int)templatedata.tokens.size();
+   int starts = xlen > 0 ? size - sublen + 1 : 1;
+   if (starts < 1) {
+      starts = 1;
+   }
+   masks.assign((size_t)starts * symbols + 1, 0);
+   int i, k;
+   for (i=0; i<starts; i++) {
+      for (k=0; (k<sublen) && (i+k<size); k++) {
+         masks[(size_t)i * symbols + templatedata.tokens[i+k]] |= 
+               (uint64_t)1 << k;
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// prepareResults -- Allocate the result storage for a source so that
+//     the threads only have to fill in the values.
+//
+
+void prepareResults(SimilSequence& source, SimilSequence& templatedata,
+      int sublen) {
+   int sourcesize = source.data.getSize();
+   int templatesize = templatedata.data.getSize();
+   int len;
+   int i;
+   if (sublen <= 0) {
+      len = (int)fabs(sourcesize - templatesize + 1);
+      source.sresults.setSize(len > 0 ? len : 0);
+      source.sresults.setAll(0.0);
+      if (len - 1 > sourcesize) {
+         // first source offset past the end of the source
+         cerr << "Error in offset values: " << -1 << ", " 
+              << templatesize << endl;
+         exit(1);
+      }
+   } else {
+      len = (int)fabs(sourcesize - sublen + 1);
+      int subcount = templatesize - sublen + 1;
+      source.mresults.setSize(len > 0 ? len : 0);
+      for (i=0; i<source.mresults.getSize(); i++) {
+         source.mresults[i].setSize(subcount);
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// getResultCount -- Return the number of source offsets to calculate.
+//
+
+int getResultCount(SimilSequence& source) {
+   if (xlen <= 0) {
+      return source.sresults.getSize();
+   } else {
+      return source.mresults.getSize();
+   }
+}
+
+
+
+//////////////////////////////
+//
+// unusual_thing -- Do sub-string matching for source offsets from
+//     start to stop-1.
+//
+
+void unusual_thing(SimilSequence& source, SimilSequence& templatedata, 
+      int sublen, const uint64_t* masks, int symbols, int start, int stop,
+      double* scratch) {
+
+   int i, j;
+   int len;
+   int sourcesize   = (int)source.tokens.size();
+   int templatesize = (int)templatedata.tokens.size();
+   int subcount;
+
+   for (i=start; i<stop; i++) {
+      subcount = source.mresults[i].getSize();
       for (j=0; j<subcount; j++) {
-         results[i][j] = dlvstring(sourcedata, i, templatedata, j, sublen);
+         len = sourcesize - i;
+         if (templatesize - j < len) {
+            len = templatesize - j;
+         }
+         if (sublen < len) {
+            len = sublen;
+         }
+         if (len <= 0) {
+            source.mresults[i][j] = 0.0;
+         } else if (masks != NULL) {
+            source.mresults[i][j] = dlvbits(masks + (size_t)j * symbols, 
+                  symbols, source.tokens.data() + i, len);
+         } else {
+            source.mresults[i][j] = dlvtokens(source.tokens.data() + i, 
+                  source.repeats.data() + i, templatedata.tokens.data() + j,
+                  templatedata.repeats.data() + j, len, 1, scratch);
+         }
       }
    }
 }
@@ -722,23 +999,33 @@ void printSequence(Array<Array<char> >& sourcedata, int index, int size,
 
 //////////////////////////////
 //
-// usual_thing --
+// usual_thing -- Compare the template with the source starting at
+//     source offsets from start to stop-1.
 //
 
-void usual_thing(Array<double>& results, Array<Array<char> >& sourcedata, 
-      Array<Array<char> >& templatedata) {
+void usual_thing(SimilSequence& source, SimilSequence& templatedata, 
+      const uint64_t* masks, int symbols, int start, int stop, 
+      double* scratch) {
 
-   int len = (int)fabs(sourcedata.getSize() - templatedata.getSize() + 1);
+   int sourcesize   = (int)source.tokens.size();
+   int templatesize = (int)templatedata.tokens.size();
+   int len;
 
-   results.setSize(0);
-   if (len <= 0) {
-      return;
-   }
-   results.setSize(len);
-   results.setAll(0.0);
-
-   for (int i=0; i<len; i++) {
-      results[i] = dlv(sourcedata, i, templatedata, 0);
+   for (int i=start; i<stop; i++) {
+      len = sourcesize - i;
+      if (templatesize < len) {
+         len = templatesize;
+      }
+      if (len <= 0) {
+         source.sresults[i] = 0.0;
+      } else if (masks != NULL) {
+         source.sresults[i] = dlvbits(masks, symbols, 
+               source.tokens.data() + i, len);
+      } else {
+         source.sresults[i] = dlvtokens(source.tokens.data() + i, 
+               source.repeats.data() + i, templatedata.tokens.data(),
+               templatedata.repeats.data(), len, 0, scratch);
+      }
    }
 }
 
@@ -763,140 +1050,109 @@ void printWeights(void) {
 
 //////////////////////////////
 //
-// dlv -- Compute the Damerau-Levenshtein distance of two arrays of 
-//      integers,  subject to specified weights.           
-//      
-//      dlv         = DLV raw value from Array<char> using dlvcharstar.
-//      dlvstring   = DLV raw value from Array<char> data.
-//      dlvcharstar = DLV raw value from char* data.
+// dlvtokens -- Compute the Damerau-Levenshtein distance of two
+//      sequences of interned tokens of the same length, subject to
+//      the specified weights.  rep1 and rep2 indicate if a token is
+//      the same as the one before it.  If firstrep is 0, then the
+//      first token of s1 is never considered repeated.  scratch must
+//      have space for len+1 values.
+//
+//      dlvtokens   = DLV raw value from interned tokens.
+//      dlvbits     = DLV raw value for unit weights (bit-parallel).
 //      dlvint      = DLV raw value from int data. (original function)
 //
 
-double dlv(Array<Array<char> >& set1, int offset1, 
-      Array<Array<char> >& set2, int offset2) {
-
-   Array<char*> list1;
-   Array<char*> list2;
-   if (offset1 < 0) { offset1 = 0; }
-   if (offset2 < 0) { offset2 = 0; }
-   
-   int size1 = set1.getSize() - offset1;
-   int size2 = set2.getSize() - offset2;
-
-   if ((size1 < 0) || (size2 < 0)) {
-      cerr << "Error in offset values: " << size1 << ", " << size2 << endl;
-      exit(1);
-   }
-
-   list1.setSize(size1);
-   list2.setSize(size2);
-
-   int i;
-   for (i=0; i<size1; i++) {
-      list1[i] = set1[i+offset1].getBase();
-   }
-   for (i=0; i<size2; i++) {
-      list2[i] = set2[i+offset2].getBase();
-   }
-
-   return dlvcharstar(list1.getBase(), size1, list2.getBase(), size2);
-}
-
-
-
-double dlvstring(Array<Array<char> >& set1, int offset1, 
-      Array<Array<char> >& set2, int offset2, int temlen = -1) {
-
-   int len1 = set1.getSize() - offset1;
-   int len2 = set2.getSize() - offset2;
-
-   if (temlen == -1) {
-      // tem len is the length of the substring to consider
-      temlen = set2.getSize();
-   }
-
-   int len = len1;   // the length of the sequences to compare
-
-   if (len1 > len2) {
-      len = len2;
-   } 
-
-   if (temlen < len) {
-      len = temlen;
-   }
+double dlvtokens(const int* s1, const char* rep1, const int* s2, 
+      const char* rep2, int len, int firstrep, double* scratch) {
 
    double cost, val, m;
+   double* min = scratch;
    int i, j;
-   int mindex;
-   int s1index, s2index;
-   int n = 0;
-
-   if (len+1 > n)  {
-      n   = len + 1;
-   }
-
-   double min[n];
-   int rep1;
-   int rep2;
+   int r1, r2;
 
-   mindex = 0;
-   s1index = offset1;
    m = 0.0;
-   min[mindex] = 0.0;
-
-   for (i=0; i<len; i++, s1index++)  {
-      m = min[mindex++];
-      if ((s1index>0) && 
-          (strcmp(set1[s1index].getBase(), set1[s1index-1].getBase()) == 0)) {
-         m += weight_R1;
-      } else {
-         m += weight_D1;
-      }
-      min[mindex] = m;
+   min[0] = 0.0;
+   for (i=0; i<len; i++)  {
+      m = min[i];
+      r1 = (i > 0 || firstrep) ? rep1[i] : 0;
+      m += r1 ? weight_R1 : weight_D1;
+      min[i+1] = m;
    }
    
-   s2index = offset2;
-   for (j=0; j<len; j++, s2index++)  {
-      rep2 = (s2index>0 && (strcmp(set2[s2index].getBase(), 
-				   set2[s2index-1].getBase()) == 0));
-      mindex = 0;
-      cost = min[mindex];
-      m = cost + (rep2 ? weight_R2 : weight_D2);
+   for (j=0; j<len; j++)  {
+      r2 = rep2[j];
+      cost = min[0];
+      m = cost + (r2 ? weight_R2 : weight_D2);
+      min[0] = m;
    
-      min[mindex++] = m;
+      for (i=0; i<len; i++)  {
+         r1 = (i > 0 || firstrep) ? rep1[i] : 0;
+         m += r1 ? weight_R1 : weight_D1;
    
-      s1index = offset1;
-      for (i=0; i<len; i++, s1index++)  {
-         rep1 = (s1index>0) && 
-             (strcmp(set1[s1index].getBase(), 
-                     set1[s1index-1].getBase()) == 0);
-	       
-         m += rep1 ? weight_R1 : weight_D1;
-   
-         if (strcmp(set1[s1index].getBase(),set2[s2index].getBase()) == 0) {
+         if (s1[i] == s2[j]) {
             val = cost;
          } else  {
-            if (rep1) {
-               val = cost + (rep2? weight_S3:weight_S1);
+            if (r1) {
+               val = cost + (r2 ? weight_S3 : weight_S1);
             } else { 
-               val = cost + (rep2? weight_S2:weight_S0);
+               val = cost + (r2 ? weight_S2 : weight_S0);
             }
          }
          if (val < m) {
             m = val;
          }
    
-	 cost = min[mindex];
-         val = cost + (rep2 ? weight_R2 : weight_D2);
+         cost = min[i+1];
+         val = cost + (r2 ? weight_R2 : weight_D2);
          if (val < m) {
             m = val;
          }
    
-	 min[mindex++] = m;
+         min[i+1] = m;
       }
    }
 
-   return (double)m;
+   return m;
+}
+
+
+
+//////////////////////////////
+//
+// dlvbits -- Edit distance with all weights equal to 1.0, using the
+//      bit-vector algorithm of Myers (1999) in the form for global
+//      distances given by Hyyro (2001).  masks contains a bit mask for
+//      each template symbol, and s1 is compared with the first len
+//      tokens of the template (len <= 64).  Source tokens numbered at
+//      or above symbols do not occur in the template.
+//
+
+double dlvbits(const uint64_t* masks, int symbols, const int* s1, int len) {
+   uint64_t pv = ~(uint64_t)0;
+   uint64_t mv = 0;
+   uint64_t eq, xv, xh, ph, mh;
+   uint64_t lastbit = (uint64_t)1 << (len - 1);
+   int score = len;
+   int i;
+
+   for (i=0; i<len; i++) {
+      eq = (s1[i] < symbols) ? masks[s1[i]] : 0;
+      xv = eq | mv;
+      xh = (((eq & pv) + pv) ^ pv) | eq;
+      ph = mv | ~(xh | pv);
+      mh = pv & xh;
+      if (ph & lastbit) {
+         score++;
+      } else if (mh & lastbit) {
+         score--;
+      }
+      ph = (ph << 1) | 1;
+      mh = mh << 1;
+      pv = mh | ~(xv | ph);
+      mv = ph & xv;
+   }
+
+   return (double)score;
 }
 
 
@@ -968,87 +1224,3 @@ double dlvint(int *s1, int len1, int *s2, int len2) {
 
 
 
-double dlvcharstar(char** set1, int len1, char** set2, int len2) {
-
-   int len = len1;   // the length of the sequences to compare
-
-   if (len1 > len2) {
-      len = len2;
-   } 
-
-   double cost, val, m;
-   int i, j;
-   int mindex;
-   int s1index, s2index;
-   int n = 0;
-
-   if (len+1 > n)  {
-      n   = len + 1;
-   }
-
-   double min[n];
-   int rep1;
-   int rep2;
-
-   mindex = 0;
-   s1index = 0;
-   m = 0.0;
-   min[mindex] = 0.0;
-
-   for (i=0; i<len; i++, s1index++)  {
-      m = min[mindex++];
-      if ((s1index>0) && 
-          (strcmp(set1[s1index], set1[s1index-1]) == 0)) {
-         m += weight_R1;
-      } else {
-         m += weight_D1;
-      }
-      min[mindex] = m;
-   }
-   
-   s2index = 0;
-   for (j=0; j<len; j++, s2index++)  {
-      rep2 = (s2index>0 && (strcmp(set2[s2index], 
-				   set2[s2index-1]) == 0));
-      mindex = 0;
-      cost = min[mindex];
-      m = cost + (rep2 ? weight_R2 : weight_D2);
-   
-      min[mindex++] = m;
-   
-      s1index = 0;
-      for (i=0; i<len; i++, s1index++)  {
-         rep1 = (s1index>0) && 
-             (strcmp(set1[s1index], 
-                     set1[s1index-1]) == 0);
-	       
-         m += rep1 ? weight_R1 : weight_D1;
-   
-         if (strcmp(set1[s1index],set2[s2index]) == 0) {
-            val = cost;
-         } else  {
-            if (rep1) {
-               val = cost + (rep2? weight_S3:weight_S1);
-            } else { 
-               val = cost + (rep2? weight_S2:weight_S0);
-            }
-         }
-         if (val < m) {
-            m = val;
-         }
-   
-	 cost = min[mindex];
-         val = cost + (rep2 ? weight_R2 : weight_D2);
-         if (val < m) {
-            m = val;
-         }
-   
-	 min[mindex++] = m;
-      }
-   }
-
-   return (double)m;
-}
-
-
-
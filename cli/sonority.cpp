@@ -9,7 +9,7 @@
 // Last Modified: Mon Apr 26 06:21:58 PDT 2010 -n, -s options added
 // Last Modified: Thu Mar 10 15:06:00 PST 2011 -i option added
 // Last Modified: Wed Mar 16 14:16:01 PDT 2011 added --iv option
-// Last Modified: Wed Mar 16 14:16:01 PDT 2011 added --iv option
+// Last Modified: Mon Oct 19 02:05:37 PDT 2026 added --cliche option
 // Filename:      ...sig/examples/all/sonority2.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/sonority2.cpp
 // Syntax:        C++; museinfo
@@ -46,6 +46,8 @@ void    printLegend         (int legendheight, int legendwidth);
 void    printAttackMarker   (HumdrumFile& infile, int line);
 void    printAttackMarker   (HumdrumFile& infile, int line);
 void    printFinalis        (HumdrumFile& infile);
+void    printCliches        (HumdrumFileSet& infiles);
+void    printClicheAnalysis (HumdrumFile& infile, Array<int>& cliche);
 
 
 // global variables
@@ -72,6 +74,9 @@ int          barlinesQ = 0;      // used with -b option
 int          legendQ   = 0;      // used with -l option
 int          outlineQ  = 1;      // 
 int          filenameQ = 0;      // used with --filename option
+int          clicheQ   = 0;      // used with --cliche option
+double       clichedur = 4.0;    // used with --cliche option
+int          clichecount = 1;    // used with --repeat option
 string       notesep;            // used with -N option
 const char* colorindex[26];
 
@@ -81,6 +86,12 @@ const char* colorindex[26];
 
 int main(int argc, char* argv[]) {
 	checkOptions(options, argc, argv);
+	if (clicheQ) {
+		HumdrumFileSet infiles;
+		infiles.read(options);
+		printCliches(infiles);
+		return 0;
+	}
 	HumdrumStream streamer(options);
 	HumdrumFile infile;
 	while (streamer.read(infile)) {
@@ -100,6 +111,91 @@ int main(int argc, char* argv[]) {
 ///////////////////////////////////////////////////////////////////////////
 
 
+//////////////////////////////
+//
+// printCliches -- Mark repeated sonority sequences lasting at least
+//     clichedur beats in a **cliche spine.  The first occurrence of
+//     cliche n is marked with -n and its repetitions with n.  Cliches
+//     are numbered across all of the input files.
+//
+
+void printCliches(HumdrumFileSet& infiles) {
+	int i;
+	for (i=0; i<infiles.getCount(); i++) {
+		infiles[i].analyzeRhythm("4");
+	}
+	Array<Array<int> > cliche;
+	if (infiles.getCount() == 1) {
+		cliche.setSize(1);
+		infiles[0].analyzeCliche(cliche[0], clichedur, clichecount);
+	} else {
+		infiles.analyzeCliche(cliche, clichedur, clichecount);
+	}
+	for (i=0; i<infiles.getCount(); i++) {
+		if (infiles.getCount() > 1) {
+			cout << "!!!!SEGMENT: " << infiles[i].getFilename() << endl;
+		}
+		printClicheAnalysis(infiles[i], cliche[i]);
+	}
+}
+
+
+
+//////////////////////////////
+//
+// printClicheAnalysis -- print the **cliche spine for one file.
+//
+
+void printClicheAnalysis(HumdrumFile& infile, Array<int>& cliche) {
+	int foundstart = 0;
+	for (int i=0; i<infile.getNumLines(); i++) {
+		switch (infile[i].getType()) {
+			case E_humrec_data_comment:
+				if (appendQ) {
+					cout << infile[i] << "\t";
+				}
+				cout << "!" << endl;
+				break;
+			case E_humrec_data_interpretation:
+				if (appendQ) {
+					cout << infile[i] << "\t";
+				}
+				if (!foundstart && infile[i].hasExclusiveQ()) {
+					foundstart = 1;
+					cout << "**cliche";
+				} else if (strcmp(infile[i][0], "*-") == 0) {
+					cout << "*-";
+				} else {
+					cout << "*";
+				}
+				cout << endl;
+				break;
+			case E_humrec_data_kern_measure:
+				if (appendQ) {
+					cout << infile[i] << "\t";
+				}
+				cout << infile[i][0] << endl;
+				break;
+			case E_humrec_data:
+				if (appendQ) {
+					cout << infile[i] << "\t";
+				}
+				if (cliche[i] == 0) {
+					cout << ".";
+				} else {
+					cout << cliche[i];
+				}
+				cout << endl;
+				break;
+			default:
+				cout << infile[i] << endl;
+				break;
+		}
+	}
+}
+
+
+
 //////////////////////////////
 //
 // printFinalis --
@@ -554,6 +650,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("b|barlines=b",      "display barlines at bottom of image");
 	opts.define("l|legend=b",        "display color mapping");
 	opts.define("filename=b",        "display filename for finalis output");
+	opts.define("cliche=d:4.0",      "mark repeated sonority sequences");
+	opts.define("repeat=i:1",        "minimum repetitions of a cliche");
 
 	opts.define("author=b",          "author of program");
 	opts.define("version=b",         "compilation info");
@@ -628,6 +726,9 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	appendQ   =  opts.getBoolean("append");
 	barlinesQ =  opts.getBoolean("barlines");
 	legendQ   =  opts.getBoolean("legend");
+	clicheQ   =  opts.getBoolean("cliche");
+	clichedur =  opts.getDouble("cliche");
+	clichecount = opts.getInteger("repeat");
 	if (opts.getBoolean("separator")) {
 		notesep   =  opts.getString("separator").c_str();
 	}
@@ -1070,6 +1171,8 @@ void usage(const string& command) {
 	"   -i = displays the **qual chord inversion only                         \n"
 	"   -r = displays the **qual chord root only                              \n"
 	"   -t = displays the **qual chord type only                              \n"
+	"   --cliche dur = mark sonority sequences of dur beats which repeat      \n"
+	"   --repeat n = minimum number of repetitions for --cliche (default 1)   \n"
 	"   --options = list of all options, aliases and default values           \n"
 	"                                                                         \n"
 	<< endl;
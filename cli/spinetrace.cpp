@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Oct 16 21:44:03 PDT 2000
 // Last Modified: Mon Oct 16 21:55:02 PDT 2000
+// Last Modified: Mon Oct 19 01:48:30 PDT 2026 Added -l and -n options
 // Filename:      ...sig/examples/all/spinetrace.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/spinetrace.cpp
 // Syntax:        C++; museinfo
@@ -21,10 +22,13 @@ using namespace std;
 void      checkOptions       (Options& opts, int argc, char* argv[]);
 void      example            (void);
 void      printSpineAnalysis (HumdrumFile& infile);
+void      printDatumAnalysis (HumdrumFile& infile);
 void      usage              (const string& command);
 
 // global variables
 Options   options;            // database for command-line arguments
+int       lastQ = 0;          // used with -l option
+int       nextQ = 0;          // used with -n option
 
 ///////////////////////////////////////////////////////////////////////////
 
@@ -35,7 +39,11 @@ int main(int argc, char* argv[]) {
 
 	while (streamer.read(infile)) {
 		infile.analyzeSpines();
-		printSpineAnalysis(infile);
+		if (lastQ || nextQ) {
+			printDatumAnalysis(infile);
+		} else {
+			printSpineAnalysis(infile);
+		}
 	}
 
 	return 0;
@@ -51,6 +59,8 @@ int main(int argc, char* argv[]) {
 //
 
 void checkOptions(Options& opts, int argc, char* argv[]) {
+	opts.define("l|last=b", "display location of previous data token");
+	opts.define("n|next=b", "display location of next data token");
 	opts.define("debug=b");                // determine bad input line num
 	opts.define("author=b");               // author of program
 	opts.define("version=b");              // compilation info
@@ -76,6 +86,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 		exit(0);
 	}
 
+	lastQ = opts.getBoolean("last");
+	nextQ = opts.getBoolean("next");
 }
   
 
@@ -122,6 +134,52 @@ void printSpineAnalysis(HumdrumFile& infile) {
 
 
 
+//////////////////////////////
+//
+// printDatumAnalysis -- Replace each data token with the line and field
+//     index of the previous (-l) and/or next (-n) non-null data token
+//     in its spine, as given by HumdrumFile::getLastDatumLine and
+//     HumdrumFile::getNextDatumLine.  A "." means that there is none.
+//
+
+void printDatumAnalysis(HumdrumFile& infile) {
+	int line;
+	int field;
+	for (int i=0; i<infile.getNumLines(); i++) {
+		if (infile[i].getType() != E_humrec_data) {
+			cout << infile[i] << '\n';
+			continue;
+		}
+		for (int j=0; j<infile[i].getFieldCount(); j++) {
+			if (lastQ) {
+				line = infile.getLastDatumLine(field, i, j, 0);
+				if (line < 0) {
+					cout << ".";
+				} else {
+					cout << line << ":" << field;
+				}
+			}
+			if (lastQ && nextQ) {
+				cout << ' ';
+			}
+			if (nextQ) {
+				line = infile.getNextDatumLine(field, i, j, 0);
+				if (line < 0) {
+					cout << ".";
+				} else {
+					cout << line << ":" << field;
+				}
+			}
+			if (j < infile[i].getFieldCount() - 1) {
+				cout << '\t';
+			}
+		}
+		cout << '\n';
+	}
+}
+
+
+
 //////////////////////////////
 //
 // usage -- gives the usage statement for the meter program
@@ -135,6 +193,8 @@ void usage(const string& command) {
 	"Usage: " << command << " [input1 [input2 ...]]\n"
 	"                                                                         \n"
 	"Options:                                                                 \n"
+	"   -l = display line:field of the previous data token in each spine.     \n"
+	"   -n = display line:field of the next data token in each spine.         \n"
 	"   --options = list of all options, aliases and default values           \n"
 	"                                                                         \n"
 	<< endl;
@@ -19,6 +19,7 @@
 // Last Midified: Mon Nov  7 10:40:00 PST 2011 added + == # for pitch search
 // Last Midified: Mon Nov 12 17:09:30 PST 2012 added note offsets
 // Last Midified: Thu Nov 14 02:31:24 WET 2019 convert to STL
+// Last Modified: Sun Oct 18 18:41:27 PDT 2026 added --index option
 // Filename:      ...museinfo/examples/all/themax.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/themax.cpp
 // Syntax:        C++; museinfo
@@ -88,6 +89,7 @@
 
 #include "humdrum.h"
 #include "PerlRegularExpression.h"
+#include "ThemeIndex.h"
 
 #include <cstdlib>
 #include <fstream>
@@ -127,6 +129,8 @@ int       searchForMatches       (const string& filename, string& ss,
                                   PerlRegularExpression& re, int mcount);
 int       searchForMatches       (istream& inputfile, string& ss,
                                   PerlRegularExpression& re, int mcount);
+int       searchIndex            (const string& indexname, string& ss,
+                                  PerlRegularExpression& re, int mcount);
 void      prepareInterval        (string& data);
 int       checkLink              (string& line, int offset);
 void      getSimpleLocationINT   (vector<int>& positions, string& line,
@@ -221,6 +225,10 @@ string      kernstring   = "";      // used with -k option
 int         limitQ       = 0;       // used with --limit option
 int         limitval     = 0;       // used with --limit option
 string      filetag;                // used with -f option
+int         indexQ       = 0;       // used with --index option
+string      indexname;              // used with --index option
+vector<char>   indexmarkers;        // feature of each literal in query
+vector<string> indexliterals;       // literal text required by query
 int         TOTALCOUNT   = 0;       // used for --total option, hack for some problem where count is
                                     //    returning file count instead of match count.
 
@@ -461,7 +469,9 @@ int main(int argc, char** argv) {
 
 	pre.initializeSearchAndStudy(ss.c_str());
 	int totalcount = 0;
-	if (options.getArgCount() == 0) {
+	if (indexQ) {
+		totalcount += searchIndex(indexname, ss, pre, totalcount);
+	} else if (options.getArgCount() == 0) {
 		// standard input
 		totalcount += searchForMatches(cin, ss, pre, totalcount);
 	} else {
@@ -508,6 +518,53 @@ int searchForMatches(const string& filename, string& ss,
 
 
 
+//////////////////////////////
+//
+// searchIndex -- Search a binary index created with tindex --binary.
+//    Only the records which contain the literal parts of the search
+//    features are checked with the regular expression.
+//
+
+int searchIndex(const string& indexname, string& ss,
+		PerlRegularExpression& pre, int mcount) {
+
+	ThemeIndex index;
+	if (!index.read(indexname)) {
+		cerr << "Error: cannot read index file " << indexname << endl;
+		exit(1);
+	}
+
+	// Inverted searches and removal of boundary markers need all records.
+	vector<int> candidates;
+	int filterQ = 0;
+	if (!notQ && boundaryQ) {
+		filterQ = index.getCandidates(candidates, indexmarkers, indexliterals);
+	}
+
+	stringstream records;
+	string line;
+	int i;
+	for (i=0; i<index.getMessageCount(); i++) {
+		index.getMessage(line, i);
+		records << line << "\n";
+	}
+	if (filterQ) {
+		for (i=0; i<(int)candidates.size(); i++) {
+			index.getRecord(line, candidates[i]);
+			records << line << "\n";
+		}
+	} else {
+		for (i=0; i<index.getRecordCount(); i++) {
+			index.getRecord(line, i);
+			records << line << "\n";
+		}
+	}
+
+	return searchForMatches(records, ss, pre, mcount);
+}
+
+
+
 //////////////////////////////
 //
 // searchForMatches -- Should be merged with above function.
@@ -1910,6 +1967,14 @@ void appendToSearchString(string& ss, const string& astring, char marker, int an
 	}
 	ss += astring;
 
+	// store the literal parts of the feature for index searches
+	vector<string> literals;
+	ThemeIndex::getLiterals(literals, astring);
+	for (int i=0; i<(int)literals.size(); i++) {
+		indexmarkers.push_back(marker);
+		indexliterals.push_back(literals[i]);
+	}
+
 	// Moved to cleanPpitchClass:
 	// // for pitch-class names, the next character after the search
 	// // string must be a space or a tab to prevent accidentals
@@ -1991,6 +2056,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("unlink=b",           "unlink search features");
 	opts.define("smart=b",            "do a smart search");
 	opts.define("Q|no-messages=b",    "do not echo control messages from input data");
+	opts.define("index=s",            "search a binary index created by tindex");
 
 	opts.define("author=b",           "author of program");
 	opts.define("version=b",          "compilation info");
@@ -2052,6 +2118,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	kernstring             = opts.getString("kern");
 	limitQ                 = opts.getBoolean("limit");
 	limitval               = opts.getInteger("limit");
+	indexQ                 = opts.getBoolean("index");
+	indexname              = opts.getString("index");
 
 	keyfilterQ             = majorQ || minorQ || tonicQ;
 	meterQ                 =  opts.getBoolean("meter");
@@ -21,6 +21,7 @@
 // Last Modified: Thu May 24 12:28:08 PDT 2012 added -u and -I options
 // Last Modified: Mon Nov 12 13:56:29 PST 2012 added !noff: processing
 // Last Modified: Sun Apr  7 00:38:49 PDT 2013 Enabled multiple segment input
+// Last Modified: Sun Oct 18 18:41:27 PDT 2026 added --binary option
 // Filename:      ...museinfo/examples/all/tindex.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/tindex.cpp
 // Syntax:        C++; museinfo
@@ -65,6 +66,7 @@
 
 #include "humdrum.h"
 #include "PerlRegularExpression.h"
+#include "ThemeIndex.h"
 
 using namespace std;
 
@@ -88,6 +90,49 @@ using namespace std;
 #define RESTDUR -1000
 
 
+//////////////////////////////
+//
+// TeeBuffer -- send output to two stream buffers, used to print the
+//     text index to standard output while also collecting it for the
+//     --binary index file.
+//
+
+class TeeBuffer : public streambuf {
+	public:
+		TeeBuffer(streambuf* aFirst, streambuf* aSecond) {
+			first  = aFirst;
+			second = aSecond;
+		}
+
+	protected:
+		streambuf* first;
+		streambuf* second;
+
+		virtual int overflow(int c) {
+			if (c == EOF) {
+				return !EOF;
+			}
+			if ((first->sputc((char)c) == EOF) ||
+					(second->sputc((char)c) == EOF)) {
+				return EOF;
+			}
+			return c;
+		}
+
+		virtual streamsize xsputn(const char* s, streamsize n) {
+			streamsize count = first->sputn(s, n);
+			second->sputn(s, n);
+			return count;
+		}
+
+		virtual int sync(void) {
+			int status1 = first->pubsync();
+			int status2 = second->pubsync();
+			return ((status1 == 0) && (status2 == 0)) ? 0 : -1;
+		}
+};
+
+
 class ISTN {
 	protected:
 		string istn;
@@ -224,6 +269,8 @@ int         instrumentQ = 0;   // used with -i option
 int         dirprefixQ = 0;    // used with -d option
 string dirprefix;         // used with -d option
 int         allQ       = 0;    // used with --all option
+int         binaryQ    = 0;    // used with --binary option
+string      binaryfile;        // used with --binary option
 
 const char* bibfilter = "";    // used with -B option
 const char* istnfile= "";      // used with --istn option
@@ -258,6 +305,15 @@ int main(int argc, char** argv) {
 	int numinputs = options.getArgCount();
 	HumdrumFileSet infiles;
 
+	// The binary index is created from the text index, so also collect
+	// the text output in a buffer when --binary is used.
+	stringstream textindex;
+	streambuf* coutbuf = cout.rdbuf();
+	TeeBuffer teebuf(coutbuf, textindex.rdbuf());
+	if (binaryQ) {
+		cout.rdbuf(&teebuf);
+	}
+
 	// use --verbose to print default settings.
 	if (!quietQ) {
 		if (!graceQ) {
@@ -303,6 +359,17 @@ int main(int argc, char** argv) {
 		}
 	}
 
+	if (binaryQ) {
+		cout.flush();
+		cout.rdbuf(coutbuf);
+		ThemeIndex index;
+		index.addLines(textindex);
+		if (!index.write(binaryfile)) {
+			cerr << "Error: cannot write index file " << binaryfile << endl;
+			exit(1);
+		}
+	}
+
 	return 0;
 }
 
@@ -2064,6 +2131,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("file=s",         "filename to use for standard input data");
 	opts.define("t|istn|translate=s", "translation file which contains istn values");
 	opts.define("l|limit=i:20",   "limit the number of extracted features");
+	opts.define("binary=s",       "write a binary search index for themax");
 
 	opts.define("author=b",  "author of program");
 	opts.define("version=b", "compilation info");
@@ -2130,6 +2198,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	istnfile    = opts.getString("istn").c_str();
 	dirprefixQ  = opts.getBoolean("dir-prefix");
 	verboseQ    = opts.getBoolean("verbose");
+	binaryQ     = opts.getBoolean("binary");
+	binaryfile  = opts.getString("binary");
 
 	if (dirprefixQ) {
 		dirprefix = opts.getString("dir-prefix");
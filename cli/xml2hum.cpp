@@ -6,6 +6,7 @@
 // Last Modified: Thu Jun  3 18:01:43 PDT 2004 added -p option
 // Last Modified: Sat Jun 26 16:49:06 PDT 2010 added middle syllable markers
 // Last Modified: Thu Mar  5 21:19:58 PST 2015 Added --split option
+// Last Modified: Mon Oct 19 03:24:16 PDT 2026 Added --items and --elements
 // Filename:      ...sig/examples/all/xml2hum.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/xml2hum.cpp
 // Syntax:        C++; museinfo
@@ -15,6 +16,7 @@
 
 #include "humdrum.h"
 #include "MusicXmlFile.h"
+#include "XmlFile.h"
 #include "Options.h"
 #include "PerlRegularExpression.h"
 
@@ -35,6 +37,8 @@ int         printQ   = 0;    // used with -p option
 int         textQ    = 1;    // used with -T option
 int         splitQ   = 0;    // used with --parts
 const char* SplitBase= "s";  // used with --parts
+int         itemsQ   = 0;    // used with --items
+int         elementsQ= 0;    // used with --elements
 
 // function declarations:
 void      checkOptions      (Options& opts, int argc, char** argv);
@@ -49,6 +53,18 @@ void      printHumdrumPart  (HumdrumFile& hfile, const char* filebase,
 int main(int argc, char* argv[]) {
    checkOptions(options, argc, argv);
 
+   if (itemsQ || elementsQ) {
+      XmlFile rawfile;
+      rawfile.read(options.getArg(1).c_str());
+      if (itemsQ) {
+         rawfile.printItemList(cout);
+      }
+      if (elementsQ) {
+         rawfile.printElementList(cout);
+      }
+      exit(0);
+   }
+
    MusicXmlFile xmlfile(options.getArg(1).c_str());
 
    if (printQ) {
@@ -242,6 +258,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    opts.define("M|no-measure-number-fix=b", "do not renumber measures");
    opts.define("T|no-text=b", "do not convert lyrics to humdrum spines");
    opts.define("parts|part=s:p", "Extract parts into files based on pattern");
+   opts.define("items=b", "print the XML items of the file and exit");
+   opts.define("elements=b", "print the XML elements of the file and exit");
 
    opts.define("author=b",  "author of program");
    opts.define("version=b", "compilation info");
@@ -283,6 +301,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    textQ     = !opts.getBoolean("no-text");
    splitQ    =  opts.getBoolean("parts");
    SplitBase =  opts.getString("parts").c_str();
+   itemsQ    =  opts.getBoolean("items");
+   elementsQ =  opts.getBoolean("elements");
    if (opts.getBoolean("no-notation")) {
       stemQ     = 0;
       beamQ     = 0;
@@ -222,6 +222,7 @@ protected:
 
 private:
 	CXMLObject* m_pFirstChild;
+	CXMLObject* m_pLastChild;  // for appending children in constant time
 };
 	
 
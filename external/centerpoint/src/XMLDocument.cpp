@@ -248,6 +248,7 @@ void CXMLFilteringIterator::ZoomOut()
 CXMLContainer::CXMLContainer()
 {
 	m_pFirstChild = NULL;
+	m_pLastChild  = NULL;
 }
 
 
@@ -258,14 +259,13 @@ void CXMLContainer::InsertChild(CXMLObject* pObj)
 
 	if (m_pFirstChild)
 	{
-		CXMLObject* pCur = m_pFirstChild;
-		while (pCur->m_pNext) pCur = pCur->m_pNext;
-		pCur->m_pNext = pObj;
+		m_pLastChild->m_pNext = pObj;
 	}
 	else
 	{
 		m_pFirstChild = pObj;
 	}
+	m_pLastChild = pObj;
 	pObj->m_pNext = NULL;
 	pObj->m_pParent = this;
 }
@@ -303,6 +303,7 @@ void CXMLContainer::RemoveChild(CXMLObject* pObj)
 	if (pObj == m_pFirstChild)
 	{
 		m_pFirstChild = m_pFirstChild->m_pNext;
+		if (pObj == m_pLastChild) m_pLastChild = NULL;
 		pObj->m_pNext = NULL;
 		pObj->m_pParent = NULL;
 	}
@@ -313,6 +314,7 @@ void CXMLContainer::RemoveChild(CXMLObject* pObj)
 		if (pCur) 
 		{
 			pCur->m_pNext = pCur->m_pNext->m_pNext;
+			if (pObj == m_pLastChild) m_pLastChild = pCur;
 			pObj->m_pNext = NULL;
 			pObj->m_pParent = NULL;
 		}
@@ -323,6 +325,8 @@ void CXMLContainer::RemoveChild(CXMLObject* pObj)
 void CXMLContainer::Empty()
 {
 	if (m_pFirstChild) m_pFirstChild->DeleteAll();
+	m_pFirstChild = NULL;
+	m_pLastChild  = NULL;
 }
 
 
@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun  8 20:19:26 PDT 1998
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 (renamed SigCollection class)
+// Last Modified: Sun Oct 18 11:20:05 PDT 2026 (made thread-safe)
+// Last Modified: Sun Oct 18 23:44:19 PDT 2026 (use std::mutex)
 // Filename:      ...sig/include/sigInfo/Enumeration.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/Enumeration.h
 // Syntax:        C++ 
@@ -18,6 +20,8 @@
 #include "EnumerationData.h"
 #include "SigCollection.h"
 
+#include <mutex>
+
 #ifndef OLDCPP
    #include <iostream>
    using namespace std;
@@ -32,6 +36,8 @@ class Enumeration {
                   Enumeration            (const Enumeration& anEnumeration);
                  ~Enumeration            ();
 
+      Enumeration& operator=             (const Enumeration& anEnumeration);
+
       void        add                    (int aValue, const char* aString, int 
                                             allocType = ENUM_TRANSIENT_ALLOC);
       void        add                    (const EnumerationData& aDatum);
@@ -53,14 +59,23 @@ class Enumeration {
 
       
    protected:
-      SigCollection<EnumerationData>  associations;
+      SigCollection<EnumerationData*> associations;  // owned entries
+      SigCollection<EnumerationData*> retired;       // replaced entries
       SigCollection<EnumerationData*> sortByValue;
       SigCollection<EnumerationData*> sortByName;
       int sortQ;
+      mutable mutex lock;                 // serialize access from threads
 
    // protected functions:
       void        checksort              (void);
       void        sort                   (void);
+      void        privateAdd             (const EnumerationData& aDatum);
+      void        insertSorted           (SigCollection<EnumerationData*>& 
+                                            list, EnumerationData* pointer,
+                                            int (*compare)(const void*, 
+                                            const void*));
+      int         privateGetValue        (const char* aName);
+      int         privateGetFreeValue    (void);
 
       static int data_compare(const void* a, const void* b);
       static int data_compare_by_value(const void* a, const void* b);
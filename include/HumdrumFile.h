@@ -19,6 +19,15 @@
 // Last Modified: Sat Sep  5 22:03:28 PDT 2009 ArrayInt to Array<int>
 // Last Modified: Sun Jun 20 13:42:12 PDT 2010 Added rhythm list)
 // Last Modified: Mon Sep 16 20:26:17 PDT 2013 Added getMeasureNumber()
+// Last Modified: Sun Oct 18 13:05:11 PDT 2026 Added analyzeKernTokens()
+// Last Modified: Sun Oct 18 14:12:40 PDT 2026 Indexed getLast/NextDatum
+// Last Modified: Sun Oct 18 15:02:17 PDT 2026 Added analyzeTies()
+// Last Modified: Sun Oct 18 15:48:33 PDT 2026 Integer rhythm accumulation
+// Last Modified: Sun Oct 18 16:58:42 PDT 2026 Added binary cache functions
+// Last Modified: Sun Oct 18 19:36:05 PDT 2026 Hashed analyzeCliche()
+// Last Modified: Sun Oct 18 20:24:51 PDT 2026 Binary search time index
+// Last Modified: Sun Oct 18 21:10:37 PDT 2026 Added measureChordRoots()
+// Last Modified: Sun Oct 18 23:58:02 PDT 2026 Added getLastIndex()
 // Filename:      ...sig/include/sigInfo/HumdrumFile.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumFile.h
 // Syntax:        C++ 
@@ -32,11 +41,14 @@
 #define _HUMDRUMFILE_H_INCLUDED
 
 #include <iostream>
+#include <map>
+#include <string>
 #include <vector>
 
 #include "HumdrumFileBasic.h"
 #include "NoteList.h"
 #include "ChordQuality.h"
+#include "KernToken.h"
 
 using namespace std;
 
@@ -110,6 +122,16 @@ class HumdrumFile : public HumdrumFileBasic {
       int                    getStartIndex    (RationalNumber startbeat);
       int                    getStopIndex     (double stopbeat);
       int                    getStopIndex     (RationalNumber startbeat);
+      int                    getLastIndex     (double beat);
+      int                    getLastIndex     (RationalNumber beat);
+      void                   getIndexRanges   (Array<int>& startindex,
+                                               Array<int>& stopindex,
+                                               Array<RationalNumber>& startbeats,
+                                               Array<RationalNumber>& stopbeats);
+      void                   getIndexRanges   (Array<int>& startindex,
+                                               Array<int>& stopindex,
+                                               Array<double>& startbeats,
+                                               Array<double>& stopbeats);
       double                 getAbsBeat       (int index);
       RationalNumber         getAbsBeatR      (int index);
       double                 getBeat          (int index);
@@ -166,6 +188,21 @@ class HumdrumFile : public HumdrumFileBasic {
       void                   read             (const char* filename);
       void                   read             (const string& filename);
       void                   read             (istream& inStream);
+      void                   readMemory       (const char* text, int length);
+
+      // binary cache of analyzed data (HumdrumFile-binary.cpp)
+      void                   writeBinary      (const char* filename);
+      void                   writeBinary      (const string& filename);
+      void                   writeBinary      (ostream& out);
+      int                    readBinary       (const char* filename);
+      int                    readBinary       (const string& filename);
+      int                    readBinary       (const char* data, long size);
+      int                    readCached       (const char* filename,
+                                               const char* cachename,
+                                               const char* base = "");
+      int                    readCached       (const string& filename,
+                                               const string& cachename,
+                                               const char* base = "");
 
       // analyses that generate internal data
       void                   analyzeRhythm    (const char* base = "", 
@@ -176,6 +213,16 @@ class HumdrumFile : public HumdrumFileBasic {
       int                    rhythmQ          (void);
       void                   getRhythms       (Array<RationalNumber>& rhys);
 
+      // pre-parsed **kern subtokens
+      void                   analyzeKernTokens(void);
+      int                    kernTokensQ      (void);
+      int                    getKernTokenCount(int line, int field);
+      int                    getKernFieldFlags(int line, int field);
+      const KernToken&       getKernToken     (int line, int field, 
+                                               int subtoken = 0);
+      void                   analyzeTies      (void);
+      int                    tiesQ            (void);
+
       //
       // analyses that generate external data
       //
@@ -214,6 +261,12 @@ class HumdrumFile : public HumdrumFileBasic {
       // form analyses
       int  analyzeCliche(Array<int>& cliche, double duration, 
             int minimumcount, double start = -1.0, double stop = -1.0);
+      void getClicheSequence(Array<int>& lines, Array<int>& symbols,
+            Array<int>& spans, map<string, int>& dictionary, 
+            double duration, double start = -1.0, double stop = -1.0);
+      static int markCliches(Array<Array<int> >& cliche, 
+            Array<Array<int> >& lines, Array<Array<int> >& symbols,
+            Array<Array<int> >& spans, int minimumcount);
 
       // metrical analyses 
       void analyzeTempoMarkings(Array<double>& tempo, double tdefault = 60.0);
@@ -241,16 +294,58 @@ class HumdrumFile : public HumdrumFileBasic {
 
    protected:
       int rhythmcheck;          // 1 = rhythm analysis has been done
+      string rhythmbase;        // base given to analyzeRhythm()
       int minrhythm;            // the least common multiple of all rhythms
       RationalNumber minrhythmR;  // the least common multiple of all rhythms
       Array<RationalNumber> localrhythms;  // used with rhythmanalysis
       RationalNumber pickupdur; // duration of a pickup measure
 
+      int kerntokencheck;       // 1 = kern token analysis has been done
+      vector<KernToken> kerntokens; // parsed subtokens of **kern fields
+      vector<int> kernlineindex;    // kernfieldindex entry of first field 
+      vector<int> kernfieldindex;   // kerntokens entry of first subtoken
+
+      int tiecheck;             // 1 = tie analysis has been done
+      vector<int> tieline;          // line of first note in tie group
+      vector<int> tiefield;         // field of first note in tie group
+      vector<int> tietoken;         // subtoken of first note in tie group
+      vector<RationalNumber> tieduration; // total tied duration from note
+
+      int datumcheck;           // 1 = datum index has been built
+      vector<int> datumlineindex;   // datum entry of first field of line
+      vector<double> datumtrack;    // track number of each data field
+      vector<int> lastdatumline;    // line of previous non-null datum
+      vector<int> lastdatumfield;   // field of previous non-null datum
+      vector<int> nextdatumline;    // line of next non-null datum
+      vector<int> nextdatumfield;   // field of next non-null datum
+      vector<int> lastdataline;     // previous data line of each line
+      vector<int> nextdataline;     // next data line of each line
+
+      int timecheck;            // 1 = time index has been built
+      int timesortQ;            // 1 = absolute beats never decrease
+      vector<RationalNumber> timestamps; // distinct absolute beats
+      vector<double> timebeats;     // timestamps as floating-point values
+      vector<int> timelastline;     // last line at each timestamp
+
    private:
       int            ispoweroftwo            (int value);
       RationalNumber getMinimumRationalRhythm(Array<RationalNumber>& rhythms);
       static int intcompare(const void* a, const void* b);
       void   convertKernStringToArray(Array<int>& array, const char* string);
+      void   clearKernTokens         (void);
+      void   buildDatumIndex         (void);
+      void   clearDatumIndex         (void);
+      void   buildTimeIndex          (void);
+      void   clearTimeIndex          (void);
+      int    getFirstTimeLine        (int index);
+      int    findDatumField          (int line, double track);
+      int    getDatumLine            (int& nspine, int index, int spine,
+                                      int direction);
+      void   getBinaryText           (string& text);
+      void   makeBinaryData          (string& output, unsigned long checksum,
+                                      const string& text);
+      int    readBinaryData          (const char* data, long size,
+                                      unsigned long& checksum);
 
       // spine analysis functions:
       void       privateSpineAnalysis(void);
@@ -271,6 +366,19 @@ class HumdrumFile : public HumdrumFileBasic {
                         int& init, SigCollection<RationalNumber>& lastdurations,
                          SigCollection<RationalNumber>& runningstatus,
                          Array<RationalNumber>& rhythms, Array<int>& ignore);
+      RationalNumber determineDurationTicks(HumdrumRecord& aRecord,
+                         int& init, vector<long long>& lastticks,
+                         vector<long long>& runticks, long long& tpq,
+                         Array<RationalNumber>& rhythms, 
+                         vector<RationalNumber>& rhythmsseen,
+                         Array<int>& ignore);
+      RationalNumber ticksToRational(long long ticks, long long tpq);
+      void       ticksToDurations(SigCollection<RationalNumber>& durations,
+                         vector<long long>& ticks, long long tpq);
+      void       durationsToTicks(vector<long long>& ticks,
+                         SigCollection<RationalNumber>& durations, 
+                         long long tpq);
+      long long  gcdTicks (long long a, long long b);
       void       adjustForSpinePaths(HumdrumRecord& aRecord, 
                          SigCollection<RationalNumber>& lastdurations, 
                          SigCollection<RationalNumber>& runningstatus, 
@@ -302,10 +410,6 @@ class HumdrumFile : public HumdrumFileBasic {
                        HumdrumFile& B, int debug = 0);
       static ostream& printConstantTokenFields(ostream& out, 
                        HumdrumRecord& aRecord, const char* token);
-                          
-      // private function for analyzeCliche:
-      int attemptMatch(Array<Array<int> >& allnotes, Array<int>& di, int
-         starti, int i, int j, double duration);
 
 
    ///////////////////////////////////////////////////////////////////////
@@ -322,6 +426,22 @@ class HumdrumFile : public HumdrumFileBasic {
                                        Array<double>& parameters, 
                                        int startindex, int stopindex, 
                                        int algorithmno = 0, int debug = 0);
+      int measureChordRoot            (Array<double>& scores,
+                                       Array<double>& parameters, 
+                                       NoteListArray& notelist,
+                                       int algorithmno = 0);
+      int measureChordRoots           (Array<int>& roots,
+                                       Array<Array<double> >& scores,
+                                       Array<double>& parameters, 
+                                       Array<int>& startindex, 
+                                       Array<int>& stopindex,
+                                       int algorithmno = 0);
+      int measureChordRoots           (Array<int>& roots,
+                                       Array<Array<double> >& scores,
+                                       Array<double>& parameters, 
+                                       Array<double>& startbeats, 
+                                       Array<double>& stopbeats,
+                                       int algorithmno = 0);
       int  measureChordRoot0          (Array<double>& scores, 
                                        Array<double>& parameters, 
                                        NoteListArray& notelist);
@@ -355,6 +475,17 @@ class HumdrumFile : public HumdrumFileBasic {
       void generateNoteList           (NoteListArray& notelist, 
                                        int startLinst, int endLine);
 
+   protected:
+      void appendChordRootNotes       (NoteListArray& notelist, int line,
+                                       Array<int>& scorelevels, int firstQ);
+      static void getChordRootWeights (double* weights, double alpha);
+      static void getChordRootNoteLogs(vector<int>& pitches, 
+                                       vector<double>& logdurs,
+                                       vector<double>& loglevels, 
+                                       NoteListArray& notelist);
+
+   public:
+
 
    // old functions which should not be used:
   
@@ -9,6 +9,9 @@
 // Last Modified: Tue Apr 24 16:54:50 PDT 2012 added readFromJrpURI()
 // Last Modified: Tue Dec 11 17:23:04 PST 2012 added fileName, segmentLevel
 // Last Modified: Sat Apr 27 13:36:16 PDT 2013 added changeField()
+// Last Modified: Sun Oct 18 09:12:40 PDT 2026 added arena line storage
+// Last Modified: Sun Oct 18 10:02:17 PDT 2026 added readMemory()
+// Last Modified: Sun Oct 18 23:06:45 PDT 2026 direct reading of PDF data
 // Filename:      ...sig/include/sigInfo/HumdrumFileBasic.h
 // Web Address:   http://museinfo.sapp.org/include/sigInfo/HumdrumFileBasic.h
 // Syntax:        C++ 
@@ -105,6 +108,8 @@ class HumdrumFileBasic {
       void                   appendLine       (HumdrumRecord& aRecord);
       void                   appendLine       (HumdrumRecord* aRecord);
       void                   setAllocation    (int allocation);
+      void                   setArenaMode     (int state = 1);
+      int                    getArenaMode     (void);
       void                   changeField      (HumdrumFileAddress& add,
                                                const char* newField);
       void                   clear            (void);
@@ -148,6 +153,7 @@ class HumdrumFileBasic {
       void                   read             (const char* filename);
       void                   read             (const string& filename);
       void                   read             (istream& inStream);
+      void                   readMemory       (const char* text, int length);
       HumdrumFileBasic       removeNullRecords(void);
       HumdrumRecord&         operator[]       (int index);
       const char*            operator[]       (HumdrumFileAddress& add);
@@ -167,6 +173,11 @@ class HumdrumFileBasic {
       int            maxtracks;           // max exclusive interpretation count
       vector<string> trackexinterp;
       static char    empty[1];
+      SigCollection<char*> arenas;        // line text shared by records
+      int            arenaQ;              // boolean for storing text in arenas
+
+      void           appendArenaText  (const char* text, int length);
+      void           clearArenas      (void);
 
    private:
       static int intcompare(const void* a, const void* b);
@@ -185,6 +196,9 @@ class HumdrumFileBasic {
       void       readjustDotArrays(Array<int>& lastline, Array<int>& lastspine, 
                        HumdrumRecord& record, int newsize);
 
+      int        readFromUriLine   (const char* line);
+      void       readEmbeddedPdf   (istream& inStream);
+
 
       // automatic URI downloading of data in read()
       #ifdef USING_URI
@@ -208,6 +222,8 @@ class HumdrumFileBasic {
 
          static void extractEmbeddedDataFromPdf(ostream& outputData, 
                                                 istream& inputData);
+         static void extractEmbeddedDataFromPdf(Array<char>& outputData, 
+                                                istream& inputData);
 };
 
 
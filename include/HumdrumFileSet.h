@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Fri Mar 29 14:49:35 PDT 2013
 // Last Modified: Fri Mar 29 14:49:39 PDT 2013
+// Last Modified: Sun Oct 18 10:02:17 PDT 2026 added readAppendMemory()
+// Last Modified: Sun Oct 18 19:36:05 PDT 2026 added analyzeCliche()
 // Filename:      ...sig/include/sigInfo/HumdrumFileSet.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumFileSet.h
 // Syntax:        C++ 
@@ -49,12 +51,18 @@ class HumdrumFileSet {
       int                    readAppend       (const string& filename);
       int                    readAppend       (istream& inStream, 
                                                const char* filename = "");
+      int                    readAppendMemory (const char* text, int length,
+                                               const char* filename = "");
+
+      int                    analyzeCliche    (Array<Array<int> >& cliche,
+                                               double duration, 
+                                               int minimumcount);
 
    protected:
       Array<HumdrumFile*>    data;
 
       void                   appendHumdrumFileContent(const char* filename, 
-                                               SSTREAM& inbuffer);
+                                               const char* text, int length);
 
       #ifdef USING_URI
       void                   readAppendFromHumdrumURI(SSTREAM& inputstream,
@@ -13,6 +13,7 @@
 // Last Modified: Tue Jun 26 09:51:28 PDT 2012 Added interpretation type funcs.
 // Last Modified: Mon Dec 10 10:14:08 PST 2012 Added Array<char> getToken
 // Last Modified: Sat Apr 20 12:15:42 PDT 2013 Added isNulToken()
+// Last Modified: Sun Oct 18 09:12:40 PDT 2026 Added arena line storage
 // Filename:      ...sig/include/sigInfo/HumdrumRecord.h
 // Webpage:       http://sig.sapp.org/include/sigInfo/HumdrumRecord.h
 // Syntax:        C++ 
@@ -243,6 +244,7 @@ class HumdrumRecord {
       void              setExInterp        (int fieldIndex, 
                                               const char* interpretation);
       void              setLine            (const char* aString); 
+      void              setArenaLine       (char* aLine, int length);
       void              setToken           (int index, const char* aString);
       void              setToken           (int index, const string& aString);
       void              setLineNum         (int aLine);
@@ -257,6 +259,8 @@ class HumdrumRecord {
       char*                recordString;   // record string
       int                  modifiedQ;      // boolen for if need to make Rstring
       SigCollection<char*> recordFields;   // data for humdrum text record
+      char*                arenaStart;     // start of borrowed file text
+      char*                arenaEnd;       // end of borrowed file text
       vector<string>       spineids;       // spine tracing ids
       Array<int>           interpretation; // exclusive interpretation of data
 
@@ -276,8 +280,11 @@ class HumdrumRecord {
       int               determineFieldCount(const char* aLine) const;
       int               determineType      (const char* aLine) const;
       void              makeRecordString   (void);
-      void              storeRecordFields  (void);
-      int               isParticularType   (const char* regexp,
+      void              storeRecordFields  (char* fieldText);
+      int               isArenaString      (const char* aString) const;
+      void              releaseString      (char*& aString);
+      void              releaseStrings     (void);
+      int               isParticularType   (int (*matcher)(const char* token),
                                             const char* exinterp);
 };
    
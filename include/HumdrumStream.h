@@ -3,6 +3,7 @@
 // Creation Date: Tue Dec 11 16:03:43 PST 2012
 // Last Modified: Tue Dec 11 16:03:46 PST 2012
 // Last Modified: Fri Mar 11 21:25:24 PST 2016 Changed to STL
+// Last Modified: Sun Oct 18 11:48:20 PDT 2026 Added getFileText()
 // Filename:      ...sig/include/sigInfo/HumdrumStream.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumStream.h
 // Syntax:        C++ 
@@ -56,6 +57,8 @@ class HumdrumStream {
       int             eof                (void);
    
       int             getFile            (HumdrumFile& infile);
+      int             getFileText        (HumdrumFile& infile,
+                                          stringstream& contents);
       int             read               (HumdrumFile& infile);
 
    protected:
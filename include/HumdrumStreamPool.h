@@ -0,0 +1,80 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 11:52:06 PDT 2026
+// Last Modified: Sun Oct 18 11:52:09 PDT 2026
+// Last Modified: Sun Oct 18 21:48:15 PDT 2026 Added text filter
+// Filename:      ...sig/include/sigInfo/HumdrumStreamPool.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumStreamPool.h
+// Syntax:        C++11
+//
+// Description:   Process the HumdrumFiles from a HumdrumStream with
+//                multiple threads.  Input is read in order by the
+//                calling thread, then parsed and handed to a callback
+//                function by a pool of worker threads.  Output from the
+//                callback is printed in the original input order.
+//
+
+#ifndef _HUMDRUMSTREAMPOOL_H_INCLUDED
+#define _HUMDRUMSTREAMPOOL_H_INCLUDED
+
+#include "HumdrumStream.h"
+#include "HumdrumFile.h"
+#include "Options.h"
+
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// The callback function for processing each file.  The callback is run
+// concurrently in several threads, so it must not write to global
+// variables; print results into the given output stream.
+typedef std::function<void(HumdrumFile& infile, ostream& out)>
+      HumdrumStreamCallback;
+
+// An optional filter which is given the unparsed text of each file.
+// Files for which the filter returns false are skipped without being
+// parsed.  The filter is also run concurrently in several threads.
+typedef std::function<int(const string& text)> HumdrumStreamFilter;
+
+
+class HumdrumStreamPool {
+   public:
+                      HumdrumStreamPool  (void);
+                      HumdrumStreamPool  (const vector<string>& list);
+                      HumdrumStreamPool  (Options& options);
+                     ~HumdrumStreamPool  ();
+
+      int             setFileList        (const vector<string>& list);
+      void            setThreadCount     (int count);
+      int             getThreadCount     (void);
+      void            setRhythmAnalysis  (int state = 1,
+                                          const string& base = "");
+      void            setTextFilter      (HumdrumStreamFilter filter);
+      int             run                (HumdrumStreamCallback callback,
+                                          ostream& out = cout);
+
+   protected:
+      HumdrumStream   streamer;         // source of HumdrumFile content
+      int             threadcount;      // 0 = one thread per cpu core
+      int             rhythmQ;          // do rhythm analysis before callback
+      string          rhythmbase;       // timebase for rhythm analysis
+      HumdrumStreamFilter textfilter;   // skip files before parsing
+
+   private:
+      int             runSerial          (HumdrumStreamCallback& callback,
+                                          ostream& out);
+      int             runParallel        (HumdrumStreamCallback& callback,
+                                          ostream& out, int threads);
+      int             parseText          (HumdrumFile& infile,
+                                          stringstream& contents);
+};
+
+
+#endif /* _HUMDRUMSTREAMPOOL_H_INCLUDED */
+
+
+
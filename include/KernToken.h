@@ -0,0 +1,81 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 13:05:11 PDT 2026
+// Last Modified: Sun Oct 18 13:05:14 PDT 2026
+// Filename:      ...sig/include/sigInfo/KernToken.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/KernToken.h
+// Syntax:        C++
+//
+// Description:   Pre-parsed contents of a single **kern subtoken (one note
+//                of a chord).  Used by HumdrumFile::analyzeKernTokens() so
+//                that analysis loops do not have to re-parse token strings.
+//
+
+#ifndef _KERNTOKEN_H_INCLUDED
+#define _KERNTOKEN_H_INCLUDED
+
+#include "RationalNumber.h"
+
+//
+// KernToken flag bits
+//
+
+#define KT_NULL          (1<<0)   /* null token "."                       */
+#define KT_REST          (1<<1)   /* rest: contains "r"                   */
+#define KT_GRACE         (1<<2)   /* grace note: contains "q" or "Q"      */
+#define KT_TIE_START     (1<<3)   /* contains "["                         */
+#define KT_TIE_CONTINUE  (1<<4)   /* contains "_"                         */
+#define KT_TIE_END       (1<<5)   /* contains "]"                         */
+#define KT_BEAM_START    (1<<6)   /* contains "L"                         */
+#define KT_BEAM_END      (1<<7)   /* contains "J"                         */
+#define KT_STACCATO      (1<<8)   /* contains "'"                         */
+#define KT_ACCENT        (1<<9)   /* contains "^"                         */
+#define KT_TENUTO        (1<<10)  /* contains "~"                         */
+#define KT_FERMATA       (1<<11)  /* contains ";"                         */
+#define KT_SLUR_START    (1<<12)  /* contains "("                         */
+#define KT_SLUR_END      (1<<13)  /* contains ")"                         */
+#define KT_PHRASE_START  (1<<14)  /* contains "{"                         */
+#define KT_PHRASE_END    (1<<15)  /* contains "}"                         */
+
+#define KT_TIE_MASK      (KT_TIE_START | KT_TIE_CONTINUE | KT_TIE_END)
+
+
+class KernToken {
+   public:
+                      KernToken        (void);
+                      KernToken        (const char* subtoken);
+                     ~KernToken        ();
+
+      void            clear            (void);
+      void            parse            (const char* subtoken);
+      void            parse            (const char* subtoken, int length);
+
+      int             getBase40        (void) const { return base40; }
+      int             getMidiNoteNumber(void) const { return midi; }
+      RationalNumber  getDurationR     (void) const { return duration; }
+      double          getDuration      (void) const;
+      int             getFlags         (void) const { return flags; }
+
+      int             isNull           (void) const;
+      int             isRest           (void) const;
+      int             isGrace          (void) const;
+      int             isTieStart       (void) const;
+      int             isTieContinue    (void) const;
+      int             isTieEnd         (void) const;
+      int             isTied           (void) const;
+      int             isNoteAttack     (void) const;
+      int             hasFlag          (int aFlag) const;
+
+   protected:
+      int             base40;     // pitch as from Convert::kernToBase40()
+      int             midi;       // pitch from Convert::kernToMidiNoteNumber()
+      RationalNumber  duration;   // from Convert::kernToDurationR()
+      int             flags;      // KT_* bits found in the token
+
+};
+
+
+#endif  /* _KERNTOKEN_H_INCLUDED */
+
+
+
@@ -0,0 +1,63 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 17:20:44 PDT 2026
+// Last Modified: Sun Oct 18 17:20:48 PDT 2026
+// Filename:      ...sig/include/sigInfo/KeyCorrelation.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/KeyCorrelation.h
+// Syntax:        C++
+//
+// Description:   Krumhansl-Schmuckler style key-finding engine for
+//                sliding-window analyses.  Pitch-class histograms of
+//                consecutive time segments are stored as prefix sums so
+//                that the histogram of any window is calculated in
+//                constant time, and the 24 key profiles are rotated and
+//                mean-centered once so that all Pearson correlations for
+//                a histogram are calculated in one 24x12 product.
+//
+
+#ifndef _KEYCORRELATION_H_INCLUDED
+#define _KEYCORRELATION_H_INCLUDED
+
+#include "Array.h"
+
+#include <vector>
+
+using namespace std;
+
+
+class KeyCorrelation {
+   public:
+                     KeyCorrelation   (void);
+                     KeyCorrelation   (const double* major, 
+                                       const double* minor);
+                    ~KeyCorrelation   ();
+
+      void           setProfiles      (const double* major, 
+                                       const double* minor);
+
+      // pitch-class histograms of consecutive time segments
+      void           clearSegments    (void);
+      void           appendSegment    (const double* histogram);
+      void           setSegments      (Array<Array<double> >& segments);
+      void           setSegments      (vector<vector<double> >& segments);
+      int            getSegmentCount  (void) const;
+      void           getHistogram     (double* histogram, int start,
+                                       int count) const;
+
+      // key correlations: scores must have space for 24 values.
+      int            correlate        (double* scores, 
+                                       const double* histogram) const;
+      int            correlateWindow  (double* scores, int start, 
+                                       int count) const;
+
+   protected:
+      double         profiles[24][12];  // rotated, centered, unit-length
+      vector<double> prefix;            // 12 running totals per segment
+
+};
+
+
+#endif  /* _KEYCORRELATION_H_INCLUDED */
+
+
+
@@ -0,0 +1,44 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 10:02:17 PDT 2026
+// Last Modified: Sun Oct 18 10:02:17 PDT 2026
+// Filename:      ...sig/include/sigInfo/MappedFile.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/MappedFile.h
+// Syntax:        C++ 
+//
+// Description:   Read-only view of the complete contents of a file.  The
+//                file is memory-mapped when possible; otherwise it is
+//                read into a single buffer.
+//
+
+#ifndef _MAPPEDFILE_H_INCLUDED
+#define _MAPPEDFILE_H_INCLUDED
+
+class MappedFile {
+   public:
+                    MappedFile        (void);
+                    MappedFile        (const char* filename);
+                   ~MappedFile        ();
+
+      int           open              (const char* filename);
+      void          close             (void);
+      int           isOpen            (void) const;
+      const char*   getData           (void) const;
+      long          getSize           (void) const;
+
+   protected:
+      const char*   data;             // start of the file contents
+      long          size;             // number of bytes in the file
+      int           mappedQ;          // true if data is memory-mapped
+      int           openQ;            // true if a file is open
+
+   private:
+                    MappedFile        (const MappedFile& aFile);
+      MappedFile&   operator=         (const MappedFile& aFile);
+};
+
+
+#endif  /* _MAPPEDFILE_H_INCLUDED */
+
+
+
@@ -3,6 +3,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Thu Jun  3 00:00:21 PDT 2010
 // Last Modified: Wed Jun  9 12:24:37 PDT 2010
+// Last Modified: Sun Oct 18 22:14:31 PDT 2026 (removed insertEventBackwards)
 // Filename:      ...sig/include/SigInfo/MuseData.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/MuseData.h
 // Syntax:        C++ 
@@ -127,8 +128,6 @@ class MuseData {
       int               getNextEventIndex   (int startindex, 
 		                             RationalNumber target);
       void              constructTimeSequence(void);
-      void              insertEventBackwards (RationalNumber atime, 
-		                              MuseRecord* arecord);
       int               getPartNameIndex    (void);
 };
    
@@ -3,12 +3,15 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Thu Jun 17 13:17:50 PDT 2010
 // Last Modified: Thu Jun 17 13:17:57 PDT 2010
+// Last Modified: Sun Oct 18 22:31:12 PDT 2026 (threaded reading, time index)
 // Filename:      ...sig/include/SigInfo/MuseDataSetSet.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/MuseDataSetSet.h
 // Syntax:        C++ 
 //
 // Description:   A class that stores a collection of MuseDataSet files
-//                representing parts for the same score.
+//                representing parts for the same score.  Parts from
+//                a multi-part file are read and analyzed in parallel,
+//                and a time index merges the event times of all parts.
 //
 
 #ifndef _MUSEDATASET_H_INCLUDED
@@ -32,9 +35,21 @@ class MuseDataSet {
       int               getPartCount        (void);
       void              deletePart          (int index);
       void              cleanLineEndings    (void);
+      void              setThreadCount      (int count);
+      int               getThreadCount      (void);
+
+      // cross-part time index:
+      int               getTimeCount        (void);
+      RationalNumber    getTime             (int tindex);
+      int               getTimeIndex        (int partindex, int eindex);
+      int               getEventIndex       (int tindex, int partindex);
 
    private:
       Array<MuseData*>  part;
+      int               threadcount;   // 0 = one thread per cpu core
+      int               timeindexQ;    // true if time index is current
+      Array<RationalNumber> timelist;  // sorted unique times of all parts
+      Array<Array<int> > timeindex;    // time index of each part event
 
    protected:
       int               appendPart          (MuseData* musedata);
@@ -42,7 +57,11 @@ class MuseDataSet {
                                              Array<string>& lines);
       void              analyzePartSegments (Array<int>& startindex, 
                                              Array<int>& stopindex, 
-                                             Array<string> lines);
+                                             Array<string>& lines);
+      void              readParts           (Array<string>& lines,
+                                             Array<int>& startindex,
+                                             Array<int>& stopindex);
+      void              buildTimeIndex      (void);
 
 };
    
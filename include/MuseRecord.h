@@ -3,6 +3,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue Jun 30 22:36:03 PDT 1998
 // Last Modified: Tue Jun 30 22:36:07 PDT 1998
+// Last Modified: Sun Oct 18 22:47:20 PDT 2026 (column decoding of durations)
 // Filename:      ...sig/include/SigInfo/MuseRecord.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/MuseRecord.h
 // Syntax:        C++ 
@@ -60,6 +61,7 @@ class MuseRecord : public MuseRecordBasic {
       int              getTickDurationField         (void);
       int              getLineTickDuration          (void);
       int              getNoteTickDuration          (void);
+      int              tickDurationQ                (void);
       char*            getTie                       (char* output);
       int              getTie                       (void);
       int              setTie                       (int hidden = 0);
@@ -295,6 +297,7 @@ class MuseRecord : public MuseRecordBasic {
       int              getAddElementIndex           (int& index, char* output,
                                                        char* input);
       char*            zerase                       (char* output, int num);
+      int              decodeTickDuration           (int& digitQ);
 
 };
    
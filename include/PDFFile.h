@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue May 11 21:54:37 PDT 2010
 // Last Modified: Tue May 11 21:54:41 PDT 2010
+// Last Modified: Sun Oct 18 23:06:45 PDT 2026 (bulk stream reads, FlateDecode)
 // Filename:      ...sig/include/sigInfo/PDFFile.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/PDFFile.h
 // Syntax:        C++ 
@@ -58,8 +59,13 @@ class PDFFile {
       void       getEmbeddedFileContents (int embedindex, ostream& out);
       void       getEmbeddedFileContents (int embedindex, Array<char>& out);
       void       getStreamData           (int streamobject, ostream& out);
+      void       getStreamData           (int streamobject, Array<char>& out);
+      int        getIntegerObject        (int objectindex);
       int        isEmbeddedHumdrumFile   (int index);
 
+      static int flateDecode             (Array<char>& output, 
+                                          const char* data, int size);
+
    private:
       istream*           pdfdatastream;
       Array<Array<int> > indirectobjectoffset;
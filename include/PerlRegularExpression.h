@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun 29 14:25:53 PDT 2009
 // Last Modified: Mon Jun 29 14:26:01 PDT 2009
+// Last Modified: Sun Oct 18 12:31:44 PDT 2026 Added compiled pattern cache
 // Filename:      ...sig/src/sig/PerlRegularExpression.h
 // Web Address:   http://sig.sapp.org/src/sig/PerlRegularExpression.h
 // Syntax:        C++; Perl Compatible Regular Expressions (http://www.pcre.org)
@@ -124,6 +125,7 @@ class PerlRegularExpression {
       char  anchorQ;                // true if anchored search
       int   valid;
       int   studyQ;
+      int   cachedQ;                // true if pre/pe are owned by the cache
 
       pcre* pre;                    // Perl-Compatible RegEx compile structure
       pcre_extra* pe;               // Extra data structure for analyzing 
@@ -139,6 +141,10 @@ class PerlRegularExpression {
       Array<char> replace_string;
 
    private:
+      void releasePattern           (void);
+      static int getCachedPattern   (const char* searchstring, int flags,
+                                     pcre*& code, pcre_extra*& study);
+
       void expandList               (Array<char>& expandlist, 
                                      const string& input); 
       void expandList               (vector<char>& expandlist, 
@@ -3,12 +3,15 @@
 // Creation Date: Wed May 19 21:10:47 PDT 2010
 // Last Modified: Thu Jan 27 03:49:20 PST 2011 added invert()
 // Last Modified: Thu Mar 21 12:55:38 PDT 2013 added isInteger()
+// Last Modified: Sun Oct 18 16:20:05 PDT 2026 64-bit storage, binary gcd
 // Filename:      ...sig/maint/code/base/RationalNumber/RationalNumber.h
 // Web Address:   http://sig.sapp.org/src/sigBase/RationalNumber.h
 // Syntax:        C++ 
 //
 // Description:   Rational number class (fraction with an integer
-//                numerator and integer denominator).
+//                numerator and integer denominator).  The numerator and
+//                denominator are stored as 64-bit integers, and an 
+//                error is given if a calculation overflows.
 //
 
 #ifndef _RATIONALNUMBER_H_INCLUDED
@@ -27,21 +30,21 @@ void    _error_msg     (const char *str);
 
 class RationalNumber {
    public:
-                     RationalNumber   (int _a = 0, int _b = 1);
+                     RationalNumber   (long long _a = 0, long long _b = 1);
                     ~RationalNumber   () {};
 
-      RationalNumber operator=   (const RationalNumber &r);
+      RationalNumber& operator=  (const RationalNumber &r);
       RationalNumber operator+   (const RationalNumber &r) const;
       RationalNumber operator-   (const RationalNumber &r) const;
       RationalNumber operator*   (const RationalNumber &r) const;
       RationalNumber operator/   (const RationalNumber &r) const;
-      RationalNumber operator+=  (const RationalNumber &r);
-      RationalNumber operator-=  (const RationalNumber &r);
-      RationalNumber operator*=  (const RationalNumber &r);
-      RationalNumber operator/=  (const RationalNumber &r);
+      RationalNumber& operator+= (const RationalNumber &r);
+      RationalNumber& operator-= (const RationalNumber &r);
+      RationalNumber& operator*= (const RationalNumber &r);
+      RationalNumber& operator/= (const RationalNumber &r);
 
       int            operator==  (const RationalNumber &r) const;
-      int            isEqualTo   (int top, int bot) const;
+      int            isEqualTo   (long long top, long long bot) const;
       int            operator!=  (const RationalNumber &r) const;
       int            operator>   (const RationalNumber &r) const;
       int            operator<   (const RationalNumber &r) const;
@@ -55,11 +58,11 @@ class RationalNumber {
       RationalNumber  operator++ (int n);
       RationalNumber  operator-- (int n);
    
-      void            setValue      (int num, int den);
-      int             getNumerator  (void) const { return _num; }
-      int             getDenominator(void) const { return _den; }
-      void            setNumerator  (int val) { _num = val; }
-      void            setDenominator(int val) { _den = val; }
+      void            setValue      (long long num, long long den);
+      long long       getNumerator  (void) const { return _num; }
+      long long       getDenominator(void) const { return _den; }
+      void            setNumerator  (long long val) { _num = val; }
+      void            setDenominator(long long val) { _den = val; }
       ostream&        printTwoPart  (ostream& out, const char* spacer = "+") 
                                     const;
       ostream&        printRecip    (ostream& out, const char* spacer = "%");
@@ -83,17 +86,21 @@ class RationalNumber {
       double          Log         (const RationalNumber &r);
       double          Log10       (const RationalNumber &r);
       double          Exp         (const RationalNumber &r);
-      static int      lcm         (int _x, int _y);
-      static int      gcd         (int _x, int _y);
+      static long long lcm        (long long _x, long long _y);
+      static long long gcd        (long long _x, long long _y);
       static void     simplify    (RationalNumber &r);
+      static long long multiply   (long long _x, long long _y);
+      static long long add        (long long _x, long long _y);
+      static int      compare     (const RationalNumber &p,
+                                   const RationalNumber &q);
 
 
       static double   getFloat    (const RationalNumber &r);
       static void     verify_number  (char *strNum, int is_fraction);
       static int      isNumber       (char *number);
    private:
-      int     _num;
-      int     _den;
+      long long  _num;
+      long long  _den;
 };
 
 ostream& operator<<(ostream& out, RationalNumber p);
@@ -4,6 +4,7 @@
 // Creation Date: Thu Feb 14 23:40:51 PST 2002
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 Renamed SigCollection class
 // Last Modified: Sat Aug 25 18:20:06 PDT 2012 Renovated
+// Last Modified: Sun Oct 18 23:31:02 PDT 2026 Buffered binary reading/writing
 // Filename:      ...sig/src/sigInfo/ScorePageBase.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/ScorePageBase.h
 // Syntax:        C++ 
@@ -51,6 +52,8 @@ class ScorePageBase {
                                           int verboseQ = 0);
       void           readBinary        (const char* filename, int verboseQ = 0);
       void           readBinary        (istream& infile, int verboseQ = 0);
+      void           readBinaryMemory  (const char* bytes, long size,
+                                        int verboseQ = 0);
       void           writeBinary       (const char* filename);
       ostream&       writeBinary       (ostream& outfile);
       void           writeBinary2Byte  (const char* filename);
@@ -60,11 +63,6 @@ class ScorePageBase {
       void           printAsciiWithExtraParameters(ostream& out, int roundQ, 
                                         int verboseQ);
 
-   private:
-      float          readLittleFloat   (istream& instream);
-      int            readLittleShort   (istream& input);
-      void           writeLittleFloat  (ostream& out, float number);
-
    public:
    // data access/manipulation functions
       int            getSize            (void);
@@ -5,6 +5,7 @@
 // Last Modified: Tue Feb 26 17:29:02 PST 2002
 // Last Modified: Tue Mar 26 09:56:28 PST 2002 Added parameter enums
 // Last Modified: Fri Aug 24 09:52:39 PDT 2012 Renovated
+// Last Modified: Sun Oct 18 23:31:02 PDT 2026 Buffered binary reading/writing
 // Filename:      ...sig/src/sigInfo/ScoreRecord.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/ScoreRecord.h
 // Syntax:        C++ 
@@ -73,8 +74,12 @@ class ScoreRecord : public ScoreParameters {
       ScoreRecord&   operator=	           (ScoreRecord& a);
 
       // Printing functions:
+      int            prepareBinary     (void);
       int            writeBinary       (ostream& out);
+      int            writeBinary       (char* output);
       void           readBinary        (istream& instream, int pcount);
+      void           readBinary        (const float* values, 
+                                        const char* bytes, int pcount);
       void           printAscii        (ostream& out, int roundQ = 1, 
 		                        int verboseQ = 0, 
                                         const char* indent = "");
@@ -288,6 +293,10 @@ class ScoreRecord : public ScoreParameters {
       static int     getMiddleCVpos    (ScoreRecord& arecord);
       static Array<char>& convertScoreTextToHtmlText(Array<char>& astring);
       static Array<char>& convertScoreTextToPlainText(Array<char>& astring);
+      static void    decodeLittleFloats(float* output, const char* input,
+                                        int count);
+      static void    encodeLittleFloats(char* output, const double* input,
+                                        int count);
 
 
    protected:
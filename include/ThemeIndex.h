@@ -0,0 +1,98 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 18:41:27 PDT 2026
+// Last Modified: Sun Oct 18 18:41:27 PDT 2026
+// Filename:      ...sig/include/sigInfo/ThemeIndex.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/ThemeIndex.h
+// Syntax:        C++
+//
+// Description:   Binary inverted index of thematic search records as
+//                created by tindex and searched by themax.  The index
+//                stores the text records together with a posting list
+//                for every three-character sequence (n-gram) of each
+//                feature type, so that a query only needs to verify the
+//                records which contain all of its literal n-grams.
+//
+
+#ifndef _THEMEINDEX_H_INCLUDED
+#define _THEMEINDEX_H_INCLUDED
+
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+// A posting records one index record containing an n-gram, and the note
+// offset of the first occurrence of the n-gram in the feature sequence.
+class ThemeIndexPosting {
+   public:
+      unsigned int record;
+      unsigned int note;
+};
+
+
+class ThemeIndex {
+   public:
+                     ThemeIndex        (void);
+                    ~ThemeIndex        ();
+
+      void           clear             (void);
+
+      // building an index:
+      void           addLine           (const string& line);
+      void           addLines          (istream& input);
+      int            write             (const char* filename);
+      int            write             (const string& filename);
+      void           write             (ostream& out);
+
+      // reading an index:
+      int            read              (const char* filename);
+      int            read              (const string& filename);
+      int            getRecordCount    (void) const;
+      void           getRecord         (string& line, int index) const;
+      int            getMessageCount   (void) const;
+      void           getMessage        (string& line, int index) const;
+      const ThemeIndexPosting* getPostings(int& count, char marker,
+                                       const char* ngram) const;
+      int            getCandidates     (vector<int>& records,
+                                       const vector<char>& markers,
+                                       const vector<string>& literals) const;
+
+      static int     getLiterals       (vector<string>& literals,
+                                       const string& regex);
+      static int     isFeatureMarker   (char marker);
+
+   protected:
+      // data for building an index:
+      vector<string> lines;            // search records
+      vector<string> messages;         // control messages ("#" lines)
+
+      // data for a read index:
+      MappedFile     mapped;
+      int            recordcount;
+      int            messagecount;
+      int            keycount;
+      const unsigned int*      recordoffsets;
+      const unsigned int*      messageoffsets;
+      const unsigned int*      keys;
+      const unsigned int*      keystarts;
+      const ThemeIndexPosting* postings;
+      const char*              text;
+
+      void           getText           (string& line,
+                                        const unsigned int* offsets,
+                                        int index) const;
+
+   private:
+                     ThemeIndex        (const ThemeIndex& anIndex);
+      ThemeIndex&    operator=         (const ThemeIndex& anIndex);
+};
+
+
+#endif  /* _THEMEINDEX_H_INCLUDED */
+
+
+
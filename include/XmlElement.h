@@ -3,12 +3,15 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun  6 14:21:45 PDT 2011
 // Last Modified: Fri Jun 24 15:10:39 PDT 2011
+// Last Modified: Sun Oct 18 22:10:05 PDT 2026 parse attributes on demand
 // Filename:      ...sig/include/SigInfo/XmlElement.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/XmlElement.h
 // Syntax:        C++ 
 //
 // Description:   A class that stores a parsing of an XML item.
-//                For use inside of the XmlFile class.
+//                For use inside of the XmlFile class.  The attributes
+//                of the element are parsed from its start tag the
+//                first time that they are accessed.
 //
 
 #ifndef _XMLENTRY_H_INCLUDED
@@ -50,6 +53,7 @@ class XmlElement {
       int         isTagBang         (void);  /* <!...> excluding comment */
       int         isTagQuestion     (void);  /* <?...> */
 
+      void        setItem           (XmlItem* anItem);
       void        parseXmlAttributes(XmlItem& anItem);
 
       int         getAttributeSize  (void);
@@ -68,6 +72,13 @@ class XmlElement {
       SigString         name;        // name of the element
       Array<SigString*> atkey;       // attribute keys
       Array<SigString*> atvalue;     // attribute values
+      XmlItem*          item;        // start tag of element
+      int               parsedQ;     // true if attributes were parsed
+
+      void        clearAttributes   (void);
+      void        parseAttributes   (void);
+      static void decodeEntities    (SigString& output, const char* text,
+                                     int size);
       
 };
 
@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun  6 14:21:45 PDT 2011
 // Last Modified: Thu Jul  7 13:22:35 PDT 2011
+// Last Modified: Sun Oct 18 22:10:05 PDT 2026 lazy element index
+// Last Modified: Mon Oct 19 03:24:16 PDT 2026 added printItemList
 // Filename:      ...sig/include/SigInfo/XmlFile.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/XmlFile.h
 // Syntax:        C++ 
@@ -50,20 +52,22 @@ class XmlFile {
       int          deleteItem          (int index);
 
       ostream&     printElementList    (ostream& out);
+      ostream&     printItemList       (ostream& out);
 
    private:
 
       XmlFileBasic       xmlitems;
       Array<XmlElement*> elements;
+      XmlElement*        elementBlock; // storage for elements
       int                parsedQ;     // true if element structure created
 
    protected:
 
       void   parseElements           (void);
-      void   parseAttributes         (void);
-      int    processElement          (int index);
       int    isParsed                (void);
       void   clearElements           (void);
+      static void getElementName     (SigString& name, XmlItem& anItem);
+      static const char* getItemTypeName (int itemtype);
 
 };
    
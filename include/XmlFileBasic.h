@@ -3,6 +3,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun  6 14:21:45 PDT 2011
 // Last Modified: Tue Jun  7 13:02:16 PDT 2011
+// Last Modified: Sun Oct 18 22:10:05 PDT 2026 single-buffer tokenizer
 // Filename:      ...sig/include/SigInfo/XmlFileBasic.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/XmlFileBasic.h
 // Syntax:        C++ 
@@ -42,18 +43,20 @@ class XmlFileBasic {
       Array<XmlItem*> itemList;
       Array<int>      serialMap;
       int             serialgen;
+      Array<char>     buffer;      // text of items read from a file
+      XmlItem*        itemBlock;   // items read from a file
+      int             itemBlockSize;
 
    protected:
       int        assignSerialMapping (int index);
       void       parseXmlFile        (const char* filename);
       void       parseXmlStream      (istream& input);
+      void       parseXmlText        (const char* text, int size);
+      int        isBlockItem         (XmlItem* item);
 
-      void       extractText         (Array<char>& output, 
-                                      Array<char>& trailingspace,
-                                        istream& input);
-      void       extractTag          (Array<char>& output, istream& input);
-      void       extractWhiteSpace   (Array<char>& output, 
-                                        istream& input);
+      static int getTagSize          (const char* text, int size);
+      static int getSpaceSize        (const char* text, int size,
+                                      int fromEnd = 0);
 
 };
    
@@ -3,11 +3,15 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun  6 14:21:45 PDT 2011
 // Last Modified: Mon Jul 11 15:32:40 PDT 2011
+// Last Modified: Sun Oct 18 22:10:05 PDT 2026 added shared-buffer items
 // Filename:      ...sig/include/SigInfo/XmlItem.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/XmlItem.h
 // Syntax:        C++ 
 //
 // Description:   A class that stores a list of XML text fragments.
+//                Items read from a file point into the single text
+//                buffer of their XmlFileBasic, while items added
+//                afterwards store their own copy of the text.
 //
 
 #ifndef _XMLITEM_H_INCLUDED
@@ -48,6 +52,8 @@
 #define XMLITEM_TYPE_QUESTION      0x4002
 
 class XmlItem {
+   friend class XmlFileBasic;
+
    public:
 
                  XmlItem     (int serialnum, Array<char>& item);
@@ -56,14 +62,14 @@ class XmlItem {
                 ~XmlItem     (void)  { clear(); }
 
 
-       void      clear       (void)  { serial = -1; string.setSize(0); }
+       void      clear       (void);
 
        int       getSerial   (void) const { return serial; }
-       int       getSize     (void)  { return string.getSize(); }
-       char*     getBase     (void)  { return string.getBase(); }
-       char*     cstr        (void)  { return string.getBase(); }
-       char*     c_str       (void)  { return string.getBase(); }
-       char*     cstring     (void)  { return string.getBase(); }
+       int       getSize     (void)  { return length; }
+       char*     getBase     (void)  { return text; }
+       char*     cstr        (void)  { return text; }
+       char*     c_str       (void)  { return text; }
+       char*     cstring     (void)  { return text; }
 
        int       isElement   (void) const;
        int       isText      (void) const;
@@ -71,15 +77,21 @@ class XmlItem {
        int       getType     (void) const;
 
    protected:
-      SigString string;
-      int       serial;
-      int       itemtype;
+      char*      text;      // null-terminated text of the item
+      int        length;    // number of characters in text
+      SigString* owned;     // storage for text if not in a shared buffer
+      int        serial;
+      int        itemtype;
 
    private:
+                 XmlItem     (const XmlItem& anItem);
+      XmlItem&   operator=   (const XmlItem& anItem);
+
       int       setType      (void);
       void      setSerial    (int aserial);
       int       setText      (Array<char>& item);
       int       setText      (const char* item);
+      int       setText      (char* buffer, int size);
 
 };
 
@@ -5,6 +5,8 @@
 // Last Modified: Mon May 31 16:18:36 PDT 1999
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 Renamed SigCollection class
 // Last Modified: Fri Mar 29 23:28:32 PDT 2013 Added HumdrumFileSet.h
+// Last Modified: Sun Oct 18 11:52:06 PDT 2026 Added HumdrumStreamPool.h
+// Last Modified: Sun Oct 18 17:20:44 PDT 2026 Added KeyCorrelation.h
 // Filename:      ...sig/include/sigInfo/humdrum.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/humdrum.h
 // Syntax:        C++ 
@@ -22,6 +24,7 @@
 // basic classes:
    #include "HumdrumRecord.h"
    #include "HumdrumStream.h"
+   #include "HumdrumStreamPool.h"
    #include "HumdrumFile.h"
    #include "HumdrumFileSet.h"
    #include "humdrumfileextras.h"
@@ -35,6 +38,8 @@
    #include "IntervalWeight.h"
    #include "RootSpectrum.h"
    #include "Maxwell.h"
+   #include "KernToken.h"
+   #include "KeyCorrelation.h"
    #include "RationalNumber.h"
 
 // support classes borrowed from sig++
@@ -20,6 +20,7 @@
 // Last Modified: Sat Jan 22 17:13:36 PST 2011 (added kernToDurationNoDots)
 // Last Modified: Thu Jan 26 18:10:29 PST 2012 (fixed kotoToDurationR)
 // Last Modified: Sun Apr 29 10:01:44 PDT 2018 (convert const char* to strings)
+// Last Modified: Sun Oct 18 22:47:20 PDT 2026 (faster museToBase40)
 // Filename:      ...sig/src/sigInfo/Convert.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/Convert.cpp
 // Syntax:        C++
@@ -43,6 +44,10 @@
 #include <vector>
 #include <cctype>
 
+#ifdef VISUAL
+   #define strtok_r strtok_s
+#endif
+
 using namespace std;
 
 
@@ -240,28 +245,28 @@ char* Convert::durationRToKernRhythm(char* output, RationalNumber input,
 
    // handle rhythms which are not dotted
    if (newdur.getNumerator() == 1) {
-      sprintf(output, "%d", newdur.getDenominator());
+      sprintf(output, "%lld", newdur.getDenominator());
       return output;
    }
 
    // check for single dot rhythms
    RationalNumber dotless1dur = (newdur*2)/3;
    if (dotless1dur.getNumerator() == 1) {
-      sprintf(output, "%d.", dotless1dur.getDenominator());
+      sprintf(output, "%lld.", dotless1dur.getDenominator());
       return output;
    }
 
    // check for double dot rhythms
    RationalNumber dotless2dur = (newdur*4)/7;
    if (dotless2dur.getNumerator() == 1) {
-      sprintf(output, "%d..", dotless2dur.getDenominator());
+      sprintf(output, "%lld..", dotless2dur.getDenominator());
       return output;
    }
 
    // check for triple dot rhythms
    RationalNumber dotless3dur = (newdur*8)/15;
    if (dotless3dur.getNumerator() == 1) {
-      sprintf(output, "%d..", dotless3dur.getDenominator());
+      sprintf(output, "%lld..", dotless3dur.getDenominator());
       return output;
    }
 
@@ -271,7 +276,8 @@ char* Convert::durationRToKernRhythm(char* output, RationalNumber input,
    }
 
    // unknown rhythm, so output a rational duration
-   sprintf(output, "%d%%%d", newdur.getDenominator(), newdur.getNumerator());
+   sprintf(output, "%lld%%%lld", newdur.getDenominator(), 
+         newdur.getNumerator());
    return output;
 }
 
@@ -938,7 +944,8 @@ ChordQuality Convert::chordQualityStringToValue(const string& aString) {
    char* token;
    temp = new char[(int)aString.size()+1];
    strcpy(temp, aString.c_str());
-   token = strtok(temp, ":");
+   char* saveptr = NULL;
+   token = strtok_r(temp, ":", &saveptr);
    for (int i=0; i<3; i++) {
       // determine what the current token is
       if (token == NULL) {
@@ -2379,14 +2386,15 @@ SigCollection<int> Convert::keyToScaleDegrees(int aKey, int aMode) {
 
 //////////////////////////////
 //
-// Convert::museToBase40 --
+// Convert::museToBase40 -- The pitch classes of regular note names
+//    (a letter followed by up to two "f" or "#" characters) are
+//    calculated directly, and any other names are looked up in
+//    musePitchClass.
 //
 
 int Convert::museToBase40(const string& pitchString) {
-   char *temp;
+   const char* temp = pitchString.c_str();
    int length = (int)pitchString.size();
-   temp = new char[length+1];
-   strcpy(temp, pitchString.c_str());
    int octave;
    int i = length - 1;
    while (i >= 0 && !isdigit(temp[i])) {
@@ -2399,9 +2407,36 @@ int Convert::museToBase40(const string& pitchString) {
    }
 
    octave = temp[i] - '0';
-   temp[i] = '\0';
 
-   return musePitchClass.getValue(temp) + 40 * (octave);
+   int pc;
+   switch (temp[0]) {
+      case 'C': pc = E_muse_c; break;
+      case 'D': pc = E_muse_d; break;
+      case 'E': pc = E_muse_e; break;
+      case 'F': pc = E_muse_f; break;
+      case 'G': pc = E_muse_g; break;
+      case 'A': pc = E_muse_a; break;
+      case 'B': pc = E_muse_b; break;
+      default:  pc = -1000;
+   }
+   if (i == 1) {
+      // no accidental
+   } else if ((i == 2) && (temp[1] == 'f')) {
+      pc -= 1;
+   } else if ((i == 2) && (temp[1] == '#')) {
+      pc += 1;
+   } else if ((i == 3) && (temp[1] == 'f') && (temp[2] == 'f')) {
+      pc -= 2;
+   } else if ((i == 3) && (temp[1] == '#') && (temp[2] == '#')) {
+      pc += 2;
+   } else {
+      pc = -1000;
+   }
+   if (pc < 0) {
+      pc = musePitchClass.getValue(pitchString.substr(0, i).c_str());
+   }
+
+   return pc + 40 * (octave);
 }
 
 
@@ -3,12 +3,18 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun  8 21:45:27 PDT 1998
 // Last Modified: Tue Jun 23 14:06:21 PDT 1998
+// Last Modified: Sun Oct 18 11:20:05 PDT 2026 made lookups thread-safe
+// Last Modified: Sun Oct 18 23:44:19 PDT 2026 use std::mutex for locking
+// Last Modified: Mon Oct 19 00:31:12 PDT 2026 entries are never moved/freed
 // Filename:      ...sig/src/sigInfo/Enumeration.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/Convert.cpp
 // Syntax:        C++ 
 //
 // Description:   Messy yet functional way of handling enumerations
-//                and their string equivalents.
+//                and their string equivalents.  Each entry is allocated
+//                separately and is not moved or deleted until the
+//                Enumeration is destroyed, so that the names returned by
+//                getName() stay valid while other threads add entries.
 //
 
 #include "Enumeration.h"
@@ -27,14 +33,16 @@
 Enumeration::Enumeration(void) {
    associations.allowGrowth();
    associations.setSize(0);
+   retired.allowGrowth();
+   retired.setSize(0);
    sortByValue.allowGrowth();
    sortByValue.setSize(0);
    sortByName.allowGrowth();
    sortByName.setSize(0);
 
-   EnumerationData aDatum(E_unknown, "", ENUM_FIXED_ALLOC);
-   associations.append(aDatum);
-   EnumerationData* pointer = &associations[0];
+   EnumerationData* pointer = new EnumerationData(E_unknown, "", 
+         ENUM_FIXED_ALLOC);
+   associations.append(pointer);
    sortByValue.append(pointer);
    sortByName.append(pointer);
 
@@ -43,20 +51,16 @@ Enumeration::Enumeration(void) {
 
 
 Enumeration::Enumeration(const Enumeration& aSet) {
-   int size = aSet.associations.getSize();
    associations.allowGrowth();
-   associations.setSize(size);
+   associations.setSize(0);
+   retired.allowGrowth();
+   retired.setSize(0);
    sortByValue.allowGrowth();
-   sortByValue.setSize(size);
+   sortByValue.setSize(0);
    sortByName.allowGrowth();
-   sortByName.setSize(size);
-   sortQ = aSet.sortQ;
-
-   for (int i=0; i<size; i++) {
-      associations[i] = aSet.associations[i];
-      sortByValue[i] = aSet.sortByValue[i];
-      sortByName[i] = aSet.sortByName[i];
-   }
+   sortByName.setSize(0);
+   sortQ = 1;
+   *this = aSet;
 }
 
 
@@ -67,7 +71,54 @@ Enumeration::Enumeration(const Enumeration& aSet) {
 //
 
 Enumeration::~Enumeration() {
-   // nothing
+   int i;
+   for (i=0; i<associations.getSize(); i++) {
+      delete associations[i];
+   }
+   for (i=0; i<retired.getSize(); i++) {
+      delete retired[i];
+   }
+}
+
+
+
+//////////////////////////////
+//
+// Enumeration::operator= -- The associations are copied while only
+//     the other object is locked, and then stored while only this object
+//     is locked, so that a=b and b=a can run at the same time.  The old
+//     entries are kept until the object is destroyed, since names
+//     returned by getName() may still be in use.
+//
+
+Enumeration& Enumeration::operator=(const Enumeration& aSet) {
+   if (&aSet == this) {
+      return *this;
+   }
+   SigCollection<EnumerationData> copy;
+   int i;
+   {
+      lock_guard<mutex> guard(aSet.lock);
+      copy.setSize(aSet.associations.getSize());
+      for (i=0; i<copy.getSize(); i++) {
+         copy[i] = *aSet.associations[i];
+      }
+   }
+
+   lock_guard<mutex> guard(lock);
+   for (i=0; i<associations.getSize(); i++) {
+      retired.append(associations[i]);
+   }
+   int size = copy.getSize();
+   associations.setSize(size);
+   sortByValue.setSize(size);
+   sortByName.setSize(size);
+   for (i=0; i<size; i++) {
+      associations[i] = new EnumerationData(copy[i]);
+   }
+   // the sorted lists must point to this object's associations:
+   sort();
+   return *this;
 }
 
 
@@ -85,10 +136,8 @@ void Enumeration::add(int aValue, const char* aName, int allocType) {
 
 
 void Enumeration::add(const EnumerationData& aDatum) {
-   associations[associations.getSize()] = aDatum;
-   sortByValue[sortByValue.getSize()] = NULL;
-   sortByName[sortByName.getSize()] = NULL;
-   sortQ = 0;
+   lock_guard<mutex> guard(lock);
+   privateAdd(aDatum);
 }
 
 
@@ -100,8 +149,10 @@ void Enumeration::add(const EnumerationData& aDatum) {
 //
 
 int Enumeration::associate(const char* aName, int allocType) {
-   int associationValue = getFreeValue();
-   add(associationValue, aName, allocType);
+   lock_guard<mutex> guard(lock);
+   int associationValue = privateGetFreeValue();
+   EnumerationData aDatum(associationValue, aName, allocType);
+   privateAdd(aDatum);
    return associationValue;
 }
 
@@ -129,7 +180,7 @@ int Enumeration::getAssociation(const char* aName) {
 //
 
 const char* Enumeration::getName(int aValue) {
-   checksort();
+   lock_guard<mutex> guard(lock);
    EnumerationData aDatum(aValue, "", ENUM_FIXED_ALLOC);
    EnumerationData* pointer = &aDatum;
    void* searchResult;
@@ -137,11 +188,11 @@ const char* Enumeration::getName(int aValue) {
          sortByValue.getSize(), sizeof(EnumerationData*), 
          data_compare_by_value_only);
 
-   if (searchResult == NULL) {
-      return "";
-   } else {
-      return (*(EnumerationData**)searchResult)->getName();
+   const char* output = "";
+   if (searchResult != NULL) {
+      output = (*(EnumerationData**)searchResult)->getName();
    }
+   return output;
 }
 
 
@@ -152,20 +203,9 @@ const char* Enumeration::getName(int aValue) {
 //
 
 int Enumeration::getValue(const char* aName) {
-   checksort();
-   EnumerationData aDatum(E_unknown, aName, ENUM_FIXED_ALLOC);
-   EnumerationData* pointer = &aDatum;
-   void* searchResult;
-   searchResult = bsearch(&pointer, sortByName.getBase(), sortByName.getSize(),
-         sizeof(EnumerationData*), data_compare_by_name_only);
-
-   if (searchResult == NULL) {
-      return E_unknown;
-   } else {
-      return (*(EnumerationData**)searchResult)->getValue();
-   }
-
-   return E_unknown;         // for dumb compilers
+   lock_guard<mutex> guard(lock);
+   int output = privateGetValue(aName);
+   return output;
 }
 
 
@@ -176,7 +216,7 @@ int Enumeration::getValue(const char* aName) {
 //
 
 int Enumeration::memberQ(int aValue) {
-   checksort();
+   lock_guard<mutex> guard(lock);
    EnumerationData aDatum(aValue, "", ENUM_FIXED_ALLOC);
    EnumerationData* pointer = &aDatum;
    void* searchResult;
@@ -193,7 +233,7 @@ int Enumeration::memberQ(int aValue) {
 
 
 int Enumeration::memberQ(const char* aName) {
-   checksort();
+   lock_guard<mutex> guard(lock);
    EnumerationData aDatum(E_unknown, aName, ENUM_FIXED_ALLOC);
    EnumerationData* pointer = &aDatum;
    void* searchResult;
@@ -210,7 +250,7 @@ int Enumeration::memberQ(const char* aName) {
 
 
 int Enumeration::memberQ(const EnumerationData& aDatum) {
-   checksort();
+   lock_guard<mutex> guard(lock);
    void* searchResult;
    const EnumerationData* pointer = &aDatum;
    searchResult = bsearch(&pointer, sortByValue.getBase(), 
@@ -232,8 +272,9 @@ int Enumeration::memberQ(const EnumerationData& aDatum) {
 //
 
 int Enumeration::getFreeValue(void) {
-   checksort();
-   return sortByValue[sortByValue.getSize()-1]->getValue() + 1;
+   lock_guard<mutex> guard(lock);
+   int output = privateGetFreeValue();
+   return output;
 }
 
 
@@ -244,9 +285,10 @@ int Enumeration::getFreeValue(void) {
 //
    
 void Enumeration::print(ostream& out) {
+   lock_guard<mutex> guard(lock);
    // don't print the null enumeration
    for (int i=1; i<associations.getSize(); i++) {
-      out << associations[i] << '\n';
+      out << *associations[i] << '\n';
    }
 }
 
@@ -258,7 +300,7 @@ void Enumeration::print(ostream& out) {
 //
    
 void Enumeration::printByName(ostream& out) {
-   checksort();
+   lock_guard<mutex> guard(lock);
    // don't print the null enumeration
    for (int i=0; i<sortByName.getSize(); i++) {
       if (sortByName[i]->getValue() != E_unknown) {
@@ -275,7 +317,7 @@ void Enumeration::printByName(ostream& out) {
 //
    
 void Enumeration::printByValue(ostream& out) {
-   checksort();
+   lock_guard<mutex> guard(lock);
    // don't print the null enumeration
    for (int i=0; i<sortByValue.getSize(); i++) {
       if (sortByValue[i]->getValue() != E_unknown) {
@@ -288,12 +330,18 @@ void Enumeration::printByValue(ostream& out) {
 
 //////////////////////////////
 //
-// Enumeration::setNullName --
+// Enumeration::setNullName -- The null entry is replaced rather than
+//     renamed so that its old name stays valid.
 //	default value: allocType = ENUM_TRANSIENT_ALLOC
 //
    
 void Enumeration::setNullName(const char* aName, int allocType) {
-   associations[0].setName(aName, allocType);
+   lock_guard<mutex> guard(lock);
+   EnumerationData* pointer = new EnumerationData(*associations[0]);
+   pointer->setName(aName, allocType);
+   retired.append(associations[0]);
+   associations[0] = pointer;
+   sort();
 }
 
 
@@ -325,7 +373,7 @@ void Enumeration::checksort(void) {
 void Enumeration::sort(void) {
    EnumerationData* pointer;
    for (int i=0; i<associations.getSize(); i++) {
-      pointer = &associations[i];
+      pointer = associations[i];
       sortByValue[i] = pointer;
       sortByName[i] = pointer;
    }
@@ -341,6 +389,84 @@ void Enumeration::sort(void) {
 
 
 
+//////////////////////////////
+//
+// Enumeration::privateAdd -- Add a new association and insert it
+//     into the sorted lookup lists.  This is done here rather than at
+//     the next lookup so that lookups never modify the object.  The lock
+//     must be held by the caller.
+//
+
+void Enumeration::privateAdd(const EnumerationData& aDatum) {
+   EnumerationData* pointer = new EnumerationData(aDatum);
+   associations.append(pointer);
+   insertSorted(sortByValue, pointer, data_compare_by_value);
+   insertSorted(sortByName, pointer, data_compare_by_name);
+}
+
+
+
+//////////////////////////////
+//
+// Enumeration::insertSorted -- Insert an entry into a sorted lookup
+//     list after any equal entries, at the position found with a binary
+//     search.
+//
+
+void Enumeration::insertSorted(SigCollection<EnumerationData*>& list,
+      EnumerationData* pointer, int (*compare)(const void*, const void*)) {
+   int low  = 0;
+   int high = list.getSize();
+   int mid;
+   while (low < high) {
+      mid = (low + high) / 2;
+      if (compare(&pointer, &list[mid]) < 0) {
+         high = mid;
+      } else {
+         low = mid + 1;
+      }
+   }
+   list[list.getSize()] = NULL;
+   for (int i=list.getSize()-1; i>low; i--) {
+      list[i] = list[i-1];
+   }
+   list[low] = pointer;
+}
+
+
+
+//////////////////////////////
+//
+// Enumeration::privateGetValue -- Lookup without locking.
+//
+
+int Enumeration::privateGetValue(const char* aName) {
+   EnumerationData aDatum(E_unknown, aName, ENUM_FIXED_ALLOC);
+   EnumerationData* pointer = &aDatum;
+   void* searchResult;
+   searchResult = bsearch(&pointer, sortByName.getBase(), sortByName.getSize(),
+         sizeof(EnumerationData*), data_compare_by_name_only);
+
+   if (searchResult == NULL) {
+      return E_unknown;
+   } else {
+      return (*(EnumerationData**)searchResult)->getValue();
+   }
+}
+
+
+
+//////////////////////////////
+//
+// Enumeration::privateGetFreeValue -- Lookup without locking.
+//
+
+int Enumeration::privateGetFreeValue(void) {
+   return sortByValue[sortByValue.getSize()-1]->getValue() + 1;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////
 //
 // helping functions
@@ -5,6 +5,7 @@
 // Last Modified: Fri Oct 13 15:04:45 PDT 2000 (changed name to EnumerationEI)
 // Last Modified: Sat Oct 14 19:12:37 PDT 2000 (extracted .cpp file)
 // Last Modified: Sun Mar 24 12:10:00 PST 2002 (small changes for visual c++)
+// Last Modified: Sun Oct 18 11:20:05 PDT 2026 (reuse existing names in add)
 // Filename:      ...sig/src/sigInfo/EnumerationEI.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/EnumerationEI.cpp
 // Syntax:        C++ 
@@ -41,12 +42,20 @@ EnumerationEI::EnumerationEI(void) : Enumeration() {
 
 ///////////////////////////////
 //
-// EnumerationEI::add --
+// EnumerationEI::add -- Assign a new enumeration value to an exclusive
+//     interpretation.  If the interpretation was already added (such
+//     as by another thread), then its current value is returned.
 //
 
 int EnumerationEI::add(const char* aString) { 
-   add(nextenumeration++, aString);
-   return nextenumeration-1; 
+   lock_guard<mutex> guard(lock);
+   int value = privateGetValue(aString);
+   if (value == E_unknown) {
+      value = nextenumeration++;
+      EnumerationData aDatum(value, aString, ENUM_TRANSIENT_ALLOC);
+      privateAdd(aDatum);
+   }
+   return value;
 }
 
 void EnumerationEI::add(int aValue, const char* aString, int allocType) { 
@@ -0,0 +1,710 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 16:21:07 PDT 2026
+// Last Modified: Sun Oct 18 16:58:42 PDT 2026
+// Last Modified: Mon Oct 19 02:31:50 PDT 2026 store the rhythm base
+// Filename:      ...sig/src/sigInfo/HumdrumFile-binary.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFile-binary.cpp
+// Syntax:        C++
+//
+// Description:   Binary cache format for analyzed HumdrumFile objects.
+//                The cache stores the text of the file together with the
+//                spine, null-token and rhythm analyses so that the file
+//                can be reloaded without re-running those analyses.
+//
+//                Layout (all integers in native byte order):
+//                   8 bytes:  "HUMDRUMB"
+//                   int:      format version (HUMDRUM_BINARY_VERSION)
+//                   int:      byte-order marker (0x01020304)
+//                   int:      crc32 checksum of the text below
+//                   string:   text of all lines, each ending in newline
+//                   string:   filename
+//                   int:      segment level, maximum track count
+//                   strings:  exclusive interpretation of each track
+//                   strings:  exclusive interpretation name table
+//                   ints:     rhythm analysis state, and if the rhythm
+//                             was analyzed, the analyzeRhythm() base
+//                             string and minimum rhythm values
+//                   records:  line number, spine width, and for each
+//                             field: spine info, exinterp table index
+//                             (only for fields within the spine width),
+//                             null-token line and field; followed by
+//                             the duration, beat and absbeat rationals.
+//
+//                Strings are stored as an int length followed by the
+//                characters, and rational numbers are two long longs.
+//                The checksum is always calculated on the line text as
+//                stored in the cache (carriage returns removed and a
+//                newline after the last line), so a cache made by
+//                writeBinary() matches a source file with CRLF line
+//                endings or without a final newline in readCached().
+//
+
+#include "HumdrumFile.h"
+#include "CheckSum.h"
+#include "Convert.h"
+#include "MappedFile.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#ifndef OLDCPP
+   #include <fstream>
+   #include <iostream>
+   using namespace std;
+#else
+   #include <fstream.h>
+   #include <iostream.h>
+#endif
+
+#define HUMDRUM_BINARY_MAGIC    "HUMDRUMB"
+#define HUMDRUM_BINARY_VERSION  2
+#define HUMDRUM_BINARY_ORDER    0x01020304
+
+
+// function declarations:
+static void appendBinaryInt      (string& output, int value);
+static void appendBinaryLongLong (string& output, long long value);
+static void appendBinaryString   (string& output, const char* text,
+                                  int length);
+static void appendBinaryRational (string& output, const RationalNumber& value);
+static int  readBinaryInt        (const char*& ptr, const char* end,
+                                  int& value);
+static int  readBinaryLongLong   (const char*& ptr, const char* end,
+                                  long long& value);
+static int  readBinaryString     (const char*& ptr, const char* end,
+                                  const char*& text, int& length);
+static int  readBinaryString     (const char*& ptr, const char* end,
+                                  string& text);
+static int  readBinaryRational   (const char*& ptr, const char* end,
+                                  RationalNumber& value);
+static int  readBinaryHeader     (const char*& ptr, const char* end,
+                                  unsigned long& checksum);
+static unsigned long getTextChecksum (const char* data, long size);
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::writeBinary -- Store the file contents and the results
+//     of the spine, null-token and rhythm analyses in a binary cache
+//     which can be loaded again with readBinary().  The rhythm results
+//     are only stored if analyzeRhythm() has been called.
+//
+
+void HumdrumFile::writeBinary(const char* filename) {
+   fstream outfile(filename, ios::out | ios::binary);
+   if (!outfile.is_open()) {
+      cerr << "Error: cannot write binary file " << filename << endl;
+      exit(1);
+   }
+   writeBinary(outfile);
+   outfile.close();
+}
+
+
+void HumdrumFile::writeBinary(const string& filename) {
+   writeBinary(filename.c_str());
+}
+
+
+void HumdrumFile::writeBinary(ostream& out) {
+   string text;
+   getBinaryText(text);
+   string output;
+   makeBinaryData(output, getTextChecksum(text.data(), text.size()), text);
+   out.write(output.data(), output.size());
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::readBinary -- Load a file stored with writeBinary().
+//     The file is read with a single memory map, and the records are
+//     stored in one arena when arena mode is active.  Returns 1 if
+//     successful, or 0 if the data is not a valid binary cache (in which
+//     case the HumdrumFile will be empty).
+//
+
+int HumdrumFile::readBinary(const char* filename) {
+   MappedFile mapped;
+   if (!mapped.open(filename)) {
+      clear();
+      return 0;
+   }
+   return readBinary(mapped.getData(), mapped.getSize());
+}
+
+
+int HumdrumFile::readBinary(const string& filename) {
+   return readBinary(filename.c_str());
+}
+
+
+int HumdrumFile::readBinary(const char* data, long size) {
+   unsigned long checksum;
+   return readBinaryData(data, size, checksum);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::readCached -- Read a Humdrum file through a binary cache.
+//     If the cache file exists, was made from the current contents of
+//     the Humdrum file and has a rhythm analysis made with the same
+//     base, then the analyzed data is loaded from the cache.  Otherwise
+//     (including when the cache is not a valid cache file) the Humdrum
+//     file is read, its rhythm analyzed with analyzeRhythm(base), and a
+//     new cache file is written.  The cache is matched to the Humdrum
+//     file by the crc32 checksum of the Humdrum file's lines (see
+//     getTextChecksum()).
+//
+//     In both cases the file is left with the spine, null-token and
+//     rhythm analyses done, as after read() and analyzeRhythm(base).
+//     Other analyses (kern tokens, ties, datum and time indexes, and the
+//     analyze*() functions with output arrays) are not cached and are
+//     done as usual on demand or by the caller.
+//
+//     Returns 1 if the cache was used, or 0 if the cache was rebuilt.
+//     default value: base = ""
+//
+
+int HumdrumFile::readCached(const char* filename, const char* cachename,
+      const char* base) {
+   if (base == NULL) {
+      base = "";
+   }
+   unsigned long checksum = 0;
+   int haveChecksum = 0;
+   {
+      MappedFile source;
+      if (source.open(filename)) {
+         checksum = getTextChecksum(source.getData(), source.getSize());
+         haveChecksum = 1;
+      }
+   }
+
+   if (haveChecksum) {
+      MappedFile cache;
+      if (cache.open(cachename)) {
+         const char* ptr = cache.getData();
+         unsigned long cachesum;
+         if (readBinaryHeader(ptr, ptr + cache.getSize(), cachesum) &&
+               (cachesum == checksum) &&
+               readBinaryData(cache.getData(), cache.getSize(), cachesum) &&
+               rhythmcheck && (rhythmbase == base)) {
+            return 1;
+         }
+      }
+   }
+
+   read(filename);
+   analyzeRhythm(base);
+
+   if (haveChecksum) {
+      string text;
+      getBinaryText(text);
+      string output;
+      makeBinaryData(output, checksum, text);
+      fstream outfile(cachename, ios::out | ios::binary);
+      if (outfile.is_open()) {
+         outfile.write(output.data(), output.size());
+         outfile.close();
+      }
+   }
+   return 0;
+}
+
+
+int HumdrumFile::readCached(const string& filename, const string& cachename,
+      const char* base) {
+   return readCached(filename.c_str(), cachename.c_str(), base);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getBinaryText -- Concatenate all lines of the file,
+//     each terminated by a newline.
+//
+
+void HumdrumFile::getBinaryText(string& text) {
+   int i;
+   int length = 0;
+   int lines = getNumLines();
+   for (i=0; i<lines; i++) {
+      length += (int)strlen((*this)[i].getLine()) + 1;
+   }
+   text.clear();
+   text.reserve(length);
+   for (i=0; i<lines; i++) {
+      text += (*this)[i].getLine();
+      text += '\n';
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::makeBinaryData -- Generate the contents of a binary
+//     cache file (see the layout at the top of this file).
+//
+
+void HumdrumFile::makeBinaryData(string& output, unsigned long checksum,
+      const string& text) {
+   int i, j;
+   int lines = getNumLines();
+
+   output.clear();
+   output.reserve(text.size() * 3 + 1024);
+   output.append(HUMDRUM_BINARY_MAGIC, 8);
+   appendBinaryInt(output, HUMDRUM_BINARY_VERSION);
+   appendBinaryInt(output, HUMDRUM_BINARY_ORDER);
+   appendBinaryInt(output, (int)(checksum & 0xffffffffUL));
+   appendBinaryString(output, text.data(), (int)text.size());
+
+   appendBinaryString(output, fileName.data(), (int)fileName.size());
+   appendBinaryInt(output, segmentLevel);
+   appendBinaryInt(output, maxtracks);
+   appendBinaryInt(output, (int)trackexinterp.size());
+   for (i=0; i<(int)trackexinterp.size(); i++) {
+      appendBinaryString(output, trackexinterp[i].data(),
+            (int)trackexinterp[i].size());
+   }
+
+   // Exclusive interpretation numbers depend on the order in which
+   // they were added to Convert::exint, so store the names instead.
+   // Index 0 is reserved for unknown interpretations.
+   map<int, int> exindex;
+   vector<int> exvalues;
+   exindex[E_unknown] = 0;
+   exvalues.push_back(E_unknown);
+   int value;
+   int width;
+   for (i=0; i<lines; i++) {
+      width = (*this)[i].getSpineWidth();
+      for (j=0; (j<(*this)[i].getFieldCount()) && (j<width); j++) {
+         value = (*this)[i].getExInterpNum(j);
+         if (exindex.find(value) == exindex.end()) {
+            exindex[value] = (int)exvalues.size();
+            exvalues.push_back(value);
+         }
+      }
+   }
+   appendBinaryInt(output, (int)exvalues.size());
+   appendBinaryString(output, "", 0);
+   const char* name;
+   for (i=1; i<(int)exvalues.size(); i++) {
+      name = Convert::exint.getName(exvalues[i]);
+      appendBinaryString(output, name, (int)strlen(name));
+   }
+
+   appendBinaryInt(output, rhythmcheck);
+   if (rhythmcheck) {
+      appendBinaryString(output, rhythmbase.data(), (int)rhythmbase.size());
+      appendBinaryInt(output, minrhythm);
+      appendBinaryRational(output, minrhythmR);
+      appendBinaryRational(output, pickupdur);
+      appendBinaryInt(output, localrhythms.getSize());
+      for (i=0; i<localrhythms.getSize(); i++) {
+         appendBinaryRational(output, localrhythms[i]);
+      }
+   }
+
+   appendBinaryInt(output, lines);
+   int fields;
+   for (i=0; i<lines; i++) {
+      HumdrumRecord& record = (*this)[i];
+      fields = record.getFieldCount();
+      width = record.getSpineWidth();
+      appendBinaryInt(output, record.getLineNum());
+      appendBinaryInt(output, width);
+      appendBinaryInt(output, fields);
+      for (j=0; j<fields; j++) {
+         const string& info = record.getSpineInfo(j);
+         appendBinaryString(output, info.data(), (int)info.size());
+         if (j < width) {
+            appendBinaryInt(output, exindex[record.getExInterpNum(j)]);
+         }
+         appendBinaryInt(output, record.getDotLine(j));
+         appendBinaryInt(output, record.getDotSpine(j));
+      }
+      if (rhythmcheck) {
+         appendBinaryRational(output, record.getDurationR());
+         appendBinaryRational(output, record.getBeatR());
+         appendBinaryRational(output, record.getAbsBeatR());
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::readBinaryData -- Load the contents of a binary cache
+//     file.  The checksum of the original text is returned in the
+//     checksum variable.  Returns 0 if the data is invalid.
+//
+
+int HumdrumFile::readBinaryData(const char* data, long size,
+      unsigned long& checksum) {
+   clear();
+   const char* ptr = data;
+   const char* end = data + size;
+   int i, j;
+
+   if (!readBinaryHeader(ptr, end, checksum)) {
+      return 0;
+   }
+
+   const char* text;
+   int length;
+   if (!readBinaryString(ptr, end, text, length)) {
+      return 0;
+   }
+   if (arenaQ) {
+      appendArenaText(text, length);
+   } else {
+      string line;
+      const char* newline;
+      int start = 0;
+      while (start < length) {
+         newline = (const char*)memchr(text + start, '\n', length - start);
+         if (newline == NULL) {
+            break;
+         }
+         line.assign(text + start, newline - text - start);
+         HumdrumFileBasic::appendLine(line.c_str());
+         start = (int)(newline - text) + 1;
+      }
+   }
+
+   int count;
+   int okQ = 1;
+   string name;
+   okQ = okQ && readBinaryString(ptr, end, fileName);
+   okQ = okQ && readBinaryInt(ptr, end, segmentLevel);
+   okQ = okQ && readBinaryInt(ptr, end, maxtracks);
+   okQ = okQ && readBinaryInt(ptr, end, count);
+   okQ = okQ && (count >= 0);
+   for (i=0; okQ && (i<count); i++) {
+      okQ = readBinaryString(ptr, end, name);
+      trackexinterp.push_back(name);
+   }
+
+   vector<int> exvalues;
+   okQ = okQ && readBinaryInt(ptr, end, count);
+   okQ = okQ && (count >= 1);
+   for (i=0; okQ && (i<count); i++) {
+      okQ = readBinaryString(ptr, end, name);
+      if (i == 0) {
+         exvalues.push_back(E_unknown);
+         continue;
+      }
+      int value = Convert::exint.getValue(name.c_str());
+      if ((value == E_unknown) || (value == E_UNKNOWN_EXINT)) {
+         Convert::exint.add(name.c_str());
+         value = Convert::exint.getValue(name.c_str());
+      }
+      exvalues.push_back(value);
+   }
+
+   int rhythmQ = 0;
+   okQ = okQ && readBinaryInt(ptr, end, rhythmQ);
+   string base;
+   if (okQ && rhythmQ) {
+      okQ = okQ && readBinaryString(ptr, end, base);
+      okQ = okQ && readBinaryInt(ptr, end, minrhythm);
+      okQ = okQ && readBinaryRational(ptr, end, minrhythmR);
+      okQ = okQ && readBinaryRational(ptr, end, pickupdur);
+      okQ = okQ && readBinaryInt(ptr, end, count);
+      okQ = okQ && (count >= 0);
+      if (okQ) {
+         localrhythms.setSize(count);
+      }
+      for (i=0; okQ && (i<count); i++) {
+         okQ = readBinaryRational(ptr, end, localrhythms[i]);
+      }
+   }
+
+   okQ = okQ && readBinaryInt(ptr, end, count);
+   okQ = okQ && (count == getNumLines());
+
+   int value = 0;
+   int width = 0;
+   int fields;
+   RationalNumber rvalue;
+   for (i=0; okQ && (i<count); i++) {
+      HumdrumRecord& record = (*this)[i];
+      okQ = readBinaryInt(ptr, end, value);
+      record.setLineNum(value);
+      okQ = okQ && readBinaryInt(ptr, end, width);
+      record.setSpineWidth(width);
+      okQ = okQ && readBinaryInt(ptr, end, fields);
+      okQ = okQ && (fields == record.getFieldCount());
+      for (j=0; okQ && (j<fields); j++) {
+         okQ = readBinaryString(ptr, end, name);
+         record.setSpineID(j, name.c_str());
+         if (okQ && (j < width)) {
+            okQ = readBinaryInt(ptr, end, value);
+            okQ = okQ && (value >= 0) && (value < (int)exvalues.size());
+            if (okQ) {
+               record.setExInterp(j, exvalues[value]);
+            }
+         }
+         okQ = okQ && readBinaryInt(ptr, end, value);
+         record.setDotLine(j, value);
+         okQ = okQ && readBinaryInt(ptr, end, value);
+         record.setDotSpine(j, value);
+      }
+      if (okQ && rhythmQ) {
+         okQ = okQ && readBinaryRational(ptr, end, rvalue);
+         record.setDurationR(rvalue);
+         okQ = okQ && readBinaryRational(ptr, end, rvalue);
+         record.setBeatR(rvalue);
+         okQ = okQ && readBinaryRational(ptr, end, rvalue);
+         record.setAbsBeatR(rvalue);
+      }
+   }
+
+   if (!okQ) {
+      clear();
+      return 0;
+   }
+   rhythmcheck = rhythmQ;
+   rhythmbase = base;
+   return 1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// Binary encoding helper functions.
+//
+
+//////////////////////////////
+//
+// appendBinaryInt -- store a 4-byte integer.
+//
+
+static void appendBinaryInt(string& output, int value) {
+   output.append((const char*)&value, sizeof(int));
+}
+
+
+
+//////////////////////////////
+//
+// appendBinaryLongLong -- store an 8-byte integer.
+//
+
+static void appendBinaryLongLong(string& output, long long value) {
+   output.append((const char*)&value, sizeof(long long));
+}
+
+
+
+//////////////////////////////
+//
+// appendBinaryString -- store a string length followed by the
+//     characters of the string (without a terminating null).
+//
+
+static void appendBinaryString(string& output, const char* text,
+      int length) {
+   appendBinaryInt(output, length);
+   output.append(text, length);
+}
+
+
+
+//////////////////////////////
+//
+// appendBinaryRational -- store the numerator and denominator of
+//     a rational number.
+//
+
+static void appendBinaryRational(string& output,
+      const RationalNumber& value) {
+   appendBinaryLongLong(output, value.getNumerator());
+   appendBinaryLongLong(output, value.getDenominator());
+}
+
+
+
+//////////////////////////////
+//
+// readBinaryInt -- read a 4-byte integer, returning 0 if there
+//     is not enough data left.
+//
+
+static int readBinaryInt(const char*& ptr, const char* end, int& value) {
+   if (end - ptr < (long)sizeof(int)) {
+      return 0;
+   }
+   memcpy(&value, ptr, sizeof(int));
+   ptr += sizeof(int);
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// readBinaryLongLong -- read an 8-byte integer, returning 0 if there
+//     is not enough data left.
+//
+
+static int readBinaryLongLong(const char*& ptr, const char* end,
+      long long& value) {
+   if (end - ptr < (long)sizeof(long long)) {
+      return 0;
+   }
+   memcpy(&value, ptr, sizeof(long long));
+   ptr += sizeof(long long);
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// readBinaryString -- read a string, either as a pointer into the
+//     data or as a copy.
+//
+
+static int readBinaryString(const char*& ptr, const char* end,
+      const char*& text, int& length) {
+   if (!readBinaryInt(ptr, end, length)) {
+      return 0;
+   }
+   if ((length < 0) || (end - ptr < length)) {
+      return 0;
+   }
+   text = ptr;
+   ptr += length;
+   return 1;
+}
+
+
+static int readBinaryString(const char*& ptr, const char* end,
+      string& text) {
+   const char* start;
+   int length;
+   if (!readBinaryString(ptr, end, start, length)) {
+      return 0;
+   }
+   text.assign(start, length);
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// readBinaryRational -- read a rational number.
+//
+
+static int readBinaryRational(const char*& ptr, const char* end,
+      RationalNumber& value) {
+   long long top;
+   long long bot;
+   if (!readBinaryLongLong(ptr, end, top)) {
+      return 0;
+   }
+   if (!readBinaryLongLong(ptr, end, bot)) {
+      return 0;
+   }
+   if (bot <= 0) {
+      return 0;
+   }
+   value.setValue(top, bot);
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// readBinaryHeader -- check the magic string, version and byte order
+//     of a binary cache, and read the checksum of the original text.
+//
+
+static int readBinaryHeader(const char*& ptr, const char* end,
+      unsigned long& checksum) {
+   if (end - ptr < 8) {
+      return 0;
+   }
+   if (strncmp(ptr, HUMDRUM_BINARY_MAGIC, 8) != 0) {
+      return 0;
+   }
+   ptr += 8;
+   int value;
+   if (!readBinaryInt(ptr, end, value) || (value != HUMDRUM_BINARY_VERSION)) {
+      return 0;
+   }
+   if (!readBinaryInt(ptr, end, value) || (value != HUMDRUM_BINARY_ORDER)) {
+      return 0;
+   }
+   if (!readBinaryInt(ptr, end, value)) {
+      return 0;
+   }
+   checksum = ((unsigned long)(unsigned int)value) & 0xffffffffUL;
+   return 1;
+}
+
+
+
+
+
+
+//////////////////////////////
+//
+// getTextChecksum -- calculate the crc32 checksum of Humdrum data in
+//     the form that it is stored in a binary cache: the data is split
+//     into lines in the same way as HumdrumFileBasic::readMemory(), a
+//     carriage return at the end of a line is removed, and each line
+//     is terminated by a newline.  Data which is already in that form
+//     is checked directly without being copied.
+//
+
+static unsigned long getTextChecksum(const char* data, long size) {
+   if ((size == 0) || ((data[size-1] == '\n') &&
+         (memchr(data, '\r', size) == NULL) &&
+         (memchr(data, '\0', size) == NULL))) {
+      return CheckSum::crc32(data, (int)size) & 0xffffffffUL;
+   }
+
+   string text;
+   text.reserve(size + 1);
+   const char* newline;
+   long start = 0;
+   long stop;
+   long length;
+   while (start <= size) {
+      newline = (const char*)memchr(data + start, '\n', size - start);
+      stop = (newline == NULL) ? size : (long)(newline - data);
+      // lines are C strings, so ignore any text after a null
+      length = (long)strnlen(data + start, stop - start);
+      if ((newline == NULL) && (length == 0)) {
+         break;
+      }
+      if ((length > 0) && (data[start+length-1] == '\r')) {
+         length--;
+      }
+      text.append(data + start, length);
+      text += '\n';
+      start = stop + 1;
+   }
+   return CheckSum::crc32(text.data(), (int)text.size()) & 0xffffffffUL;
+}
+
+
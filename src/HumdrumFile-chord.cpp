@@ -4,6 +4,7 @@
 // Creation Date: Mon May 14 12:26:45 PDT 2001
 // Last Modified: Tue May 15 11:23:21 PDT 2001
 // Last Modified: Sun Mar 24 12:10:00 PST 2002 (small changes for visual c++)
+// Last Modified: Sun Oct 18 21:10:37 PDT 2026 Added measureChordRoots()
 // Filename:      ...sig/src/sigInfo/HumdrumFile-chord.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFile.cpp
 // Syntax:        C++ 
@@ -54,8 +55,32 @@ int HumdrumFile::measureChordRoot(Array<double>& scores,
       }
    }
 
-   int output = 0;
+   int output = measureChordRoot(scores, parameters, notelist, algorithmno);
+
+   if (debug) {
+      cout << "Root is: " << output << endl;
+   }
+   
+   return output;
+}
+
+
+int HumdrumFile::measureChordRoot(Array<double>& scores,
+      Array<double>& parameters, double startbeat, double stopbeat, 
+      int algorithmno, int debug) {
 
+   int start = getStartIndex(startbeat);
+   int stop = getStopIndex(stopbeat);
+
+// cout << "STARTBEAT = " << startbeat << "\tSTOPBEAT = " << stopbeat << endl;
+
+   return measureChordRoot(scores, parameters, start, stop, algorithmno, debug);
+}
+
+
+int HumdrumFile::measureChordRoot(Array<double>& scores,
+      Array<double>& parameters, NoteListArray& notelist, int algorithmno) {
+   int output = 0;
    switch (algorithmno) {
       case 0: output = measureChordRoot0(scores, parameters, notelist); break;
       case 1: output = measureChordRoot1(scores, parameters, notelist); break;
@@ -68,25 +93,108 @@ int HumdrumFile::measureChordRoot(Array<double>& scores,
       case 8: output = measureChordRoot8(scores, parameters, notelist); break;
       case 9: output = measureChordRoot9(scores, parameters, notelist); break;
    }
-
-   if (debug) {
-      cout << "Root is: " << output << endl;
-   }
-   
    return output;
 }
 
 
-int HumdrumFile::measureChordRoot(Array<double>& scores,
-      Array<double>& parameters, double startbeat, double stopbeat, 
-      int algorithmno, int debug) {
 
-   int start = getStartIndex(startbeat);
-   int stop = getStopIndex(stopbeat);
+//////////////////////////////
+//
+// HumdrumFile::measureChordRoots -- measure the chord roots of a list
+//     of regions in the music (such as every beat in a harmonic rhythm
+//     study).  roots[i] and scores[i] are the results which would be
+//     given by measureChordRoot() for the lines startindex[i] to
+//     stopindex[i] (or for the beats startbeats[i] to stopbeats[i]).
+//     The metric levels, tied durations and pitches of the notes on
+//     every data line are calculated only once for all regions, rather
+//     than rescanning the entire score for each region.  Returns the
+//     number of regions analyzed.
+//
 
-// cout << "STARTBEAT = " << startbeat << "\tSTOPBEAT = " << stopbeat << endl;
+int HumdrumFile::measureChordRoots(Array<int>& roots, 
+      Array<Array<double> >& scores, Array<double>& parameters, 
+      Array<int>& startindex, Array<int>& stopindex, int algorithmno) {
 
-   return measureChordRoot(scores, parameters, start, stop, algorithmno, debug);
+   HumdrumFile& score = *this;
+   int size = startindex.getSize();
+   if (stopindex.getSize() < size) {
+      size = stopindex.getSize();
+   }
+   roots.setSize(size);
+   scores.setSize(size);
+   if (size == 0) {
+      return 0;
+   }
+
+   Array<int> scorelevels;
+   score.analyzeMetricLevel(scorelevels);
+
+   // notes on each data line when it is not the first line of a region
+   NoteListArray allnotes;
+   allnotes.setSize(score.getNumLines() * 4);
+   allnotes.setGrowth(score.getNumLines());
+   allnotes.setSize(0);
+   allnotes.allowGrowth(1);
+   Array<int> linestart(score.getNumLines() + 1);
+   int i, j;
+   for (i=0; i<score.getNumLines(); i++) {
+      linestart[i] = allnotes.getSize();
+      if (score[i].getType() == E_humrec_data) {
+         appendChordRootNotes(allnotes, i, scorelevels, 0);
+      }
+   }
+   linestart[score.getNumLines()] = allnotes.getSize();
+
+   NoteListArray notelist;
+   notelist.setSize(allnotes.getSize() + 100);
+   notelist.setGrowth(allnotes.getSize() + 100);
+   int startLine, endLine, temp;
+   int firstline;
+   for (i=0; i<size; i++) {
+      startLine = startindex[i];
+      endLine = stopindex[i];
+      if (endLine <= 0) {
+         endLine = score.getNumLines() - 1;
+      }
+      if (startLine > endLine) {
+         temp = endLine;
+         endLine = startLine;
+         startLine = temp;
+      }
+      notelist.setSize(0);
+      notelist.allowGrowth(1);
+      firstline = -1;
+      for (j=startLine; j<=endLine; j++) {
+         if (score[j].getType() == E_humrec_data) {
+            // held-over notes are only extracted on the first line
+            firstline = j;
+            appendChordRootNotes(notelist, j, scorelevels, 1);
+            break;
+         }
+      }
+      if (firstline >= 0) {
+         for (j=linestart[firstline+1]; j<linestart[endLine+1]; j++) {
+            notelist.append(allnotes[j]);
+         }
+      }
+      notelist.allowGrowth(0);
+      roots[i] = measureChordRoot(scores[i], parameters, notelist, 
+            algorithmno);
+   }
+
+   return size;
+}
+
+
+int HumdrumFile::measureChordRoots(Array<int>& roots, 
+      Array<Array<double> >& scores, Array<double>& parameters, 
+      Array<double>& startbeats, Array<double>& stopbeats, 
+      int algorithmno) {
+   Array<int> startindex;
+   Array<int> stopindex;
+   getIndexRanges(startindex, stopindex, startbeats, stopbeats);
+   return measureChordRoots(roots, scores, parameters, startindex, 
+         stopindex, algorithmno);
 }
 
 
@@ -112,13 +220,6 @@ int HumdrumFile::measureChordRoot0(Array<double>& scores,
 int HumdrumFile::measureChordRoot1(Array<double>& scores, 
       Array<double>& parameters, NoteListArray& notelist) {
 
-   int vx[40] = {0, 7, 7, 1000, 4, 4, 4, 4, 4, 1000, 8, 1, 1, 8, 8, 5, 5,
-		5, 5, 5, 1000, 9, 2, 2, 2, 9, 1000, 6, 6, 6, 6, 6, 1000, 3,
-		3, 3, 3, 10, 7, 7};
-   int vy[40] = {0, -2, -4, 1000, 4, 2, 0, -2, -4, 1000, 3, 1, 1, -3, -5, 5,
-		3, 1, -1, -3, 1000, 4, 2, 0, -2, -4, 1000, 4, 2, 0, -2, -4,
-		1000, 3, 1, -1, -3, -5, 4, 2};
-
    double& alpha  = parameters[0];
    double& delta  = parameters[1];
    double& lambda = parameters[2];
@@ -126,22 +227,33 @@ int HumdrumFile::measureChordRoot1(Array<double>& scores,
    scores.zero();
 
    int i, j;
-   int p;
    int count = notelist.getSize();
    double asum, bsum;
-   double I;
    int max = 0;
 
+   double weights[40];
+   getChordRootWeights(weights, alpha);
+   vector<int> pitches;
+   vector<double> logdurs;
+   vector<double> loglevels;
+   getChordRootNoteLogs(pitches, logdurs, loglevels, notelist);
+   vector<double> durterms(count);
+   vector<double> levelterms(count);
+   for (j=0; j<count; j++) {
+      durterms[j] = delta + logdurs[j];
+      levelterms[j] = lambda + loglevels[j];
+   }
+
 // cout << "Notelist size is: " << notelist.getSize() << endl;
 // cout << "Scores size is: " << scores.getSize() << endl;
 
+   double I;
    for (i=0; i<40; i++) {
       asum = bsum = 0.0;
       for (j=0; j<count; j++) {
-         p = (notelist[j].getPitch() - i - 2 + 40) % 40;
-         I = sqrt(alpha * alpha * vx[p] * vx[p] + vy[p] * vy[p]);
-         asum += I * (delta + log(notelist[j].getDur())/log(2.0));
-         bsum += I * (lambda + log(notelist[j].getLevel())/log(2.0));
+         I = weights[(pitches[j] - i + 40) % 40];
+         asum += I * durterms[j];
+         bsum += I * levelterms[j];
       }
       scores[i] = sqrt(asum * asum + bsum * bsum)/count;
       if (scores[i] < scores[max]) {
@@ -188,13 +300,6 @@ int HumdrumFile::measureChordRoot1(Array<double>& scores,
 int HumdrumFile::measureChordRoot2(Array<double>& scores, 
       Array<double>& parameters, NoteListArray& notelist) {
 
-   int vx[40] = {0, 7, 7, 1000, 4, 4, 4, 4, 4, 1000, 8, 1, 1, 8, 8, 5, 5,
-		5, 5, 5, 1000, 9, 2, 2, 2, 9, 1000, 6, 6, 6, 6, 6, 1000, 3,
-		3, 3, 3, 10, 7, 7};
-   int vy[40] = {0, -2, -4, 1000, 4, 2, 0, -2, -4, 1000, 3, 1, 1, -3, -5, 5,
-		3, 1, -1, -3, 1000, 4, 2, 0, -2, -4, 1000, 4, 2, 0, -2, -4,
-		1000, 3, 1, -1, -3, -5, 4, 2};
-
    double& alpha   = parameters[0];
    double& delta   = parameters[1];
    double& lambda  = parameters[2];
@@ -202,35 +307,47 @@ int HumdrumFile::measureChordRoot2(Array<double>& scores,
    scores.zero();
 
    int i, j;
-   int p;
    int count = notelist.getSize();
    double asum, bsum;
-   double I;
    int max = 0;
 
+   double weights[40];
+   getChordRootWeights(weights, alpha);
+   vector<int> pitches;
+   vector<double> logdurs;
+   vector<double> loglevels;
+   getChordRootNoteLogs(pitches, logdurs, loglevels, notelist);
+
    double offset = 0.0;
    double testv;
-   for (i=0; i<notelist.getSize(); i++) {
-      testv = -log(notelist[i].getDur())/log(2.0);
+   for (i=0; i<count; i++) {
+      testv = -logdurs[i];
       if (testv > offset) {
          offset = testv;
       }
-      testv = -log(notelist[i].getLevel())/log(2.0);
+      testv = -loglevels[i];
       if (testv > offset) {
          offset = testv;
       }
    }
    offset = offset * 2;
 
+   vector<double> durterms(count);
+   vector<double> levelterms(count);
+   for (j=0; j<count; j++) {
+      durterms[j] = offset + logdurs[j];
+      levelterms[j] = offset + loglevels[j];
+   }
+
 // cout << "Notelist size is: " << notelist.getSize() << endl;
 // cout << "Scores size is: " << scores.getSize() << endl;
+   double I;
    for (i=0; i<40; i++) {
       asum = bsum = 0.0;
       for (j=0; j<count; j++) {
-         p = (notelist[j].getPitch() - 2 - i + 40) % 40;
-         I = sqrt(alpha * alpha * vx[p] * vx[p] + vy[p] * vy[p]);
-         asum += I * delta * (offset + log(notelist[j].getDur())/log(2.0));
-         bsum += I * lambda * (offset + log(notelist[j].getLevel())/log(2.0));
+         I = weights[(pitches[j] - i + 40) % 40];
+         asum += I * delta * durterms[j];
+         bsum += I * lambda * levelterms[j];
       }
       scores[i] = (asum + bsum)/count;
       if (scores[i] < scores[max]) {
@@ -249,6 +366,53 @@ int HumdrumFile::measureChordRoot2(Array<double>& scores,
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::getChordRootWeights -- calculate the interval weight
+//     of each base-40 interval above a chord root candidate, used in
+//     measureChordRoot1() and measureChordRoot2().
+//
+
+void HumdrumFile::getChordRootWeights(double* weights, double alpha) {
+   int vx[40] = {0, 7, 7, 1000, 4, 4, 4, 4, 4, 1000, 8, 1, 1, 8, 8, 5, 5,
+		5, 5, 5, 1000, 9, 2, 2, 2, 9, 1000, 6, 6, 6, 6, 6, 1000, 3,
+		3, 3, 3, 10, 7, 7};
+   int vy[40] = {0, -2, -4, 1000, 4, 2, 0, -2, -4, 1000, 3, 1, 1, -3, -5, 5,
+		3, 1, -1, -3, 1000, 4, 2, 0, -2, -4, 1000, 4, 2, 0, -2, -4,
+		1000, 3, 1, -1, -3, -5, 4, 2};
+
+   for (int p=0; p<40; p++) {
+      weights[p] = sqrt(alpha * alpha * vx[p] * vx[p] + vy[p] * vy[p]);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getChordRootNoteLogs -- extract the base-40 pitch class
+//     (offset by two so that C is interval 0 above a root of 0) and the 
+//     base-2 logarithms of the duration and metric level of each note,
+//     so that they do not have to be recalculated for each root
+//     candidate.
+//
+
+void HumdrumFile::getChordRootNoteLogs(vector<int>& pitches, 
+      vector<double>& logdurs, vector<double>& loglevels, 
+      NoteListArray& notelist) {
+   int count = notelist.getSize();
+   pitches.resize(count);
+   logdurs.resize(count);
+   loglevels.resize(count);
+   for (int j=0; j<count; j++) {
+      pitches[j] = (notelist[j].getPitch() - 2 + 40) % 40;
+      logdurs[j] = log(notelist[j].getDur())/log(2.0);
+      loglevels[j] = log(notelist[j].getLevel())/log(2.0);
+   }
+}
+
+
+
 //////////////////////////////
 //
 // static HumdrumFile::measureChordRoot3 -- 
@@ -372,97 +536,17 @@ void HumdrumFile::generateNoteList(NoteListArray& notelist,
    notelist.setSize(0);
    notelist.allowGrowth(1);
 
-   NoteList currentlist;
-   currentlist.clear();
-
    Array<int> scorelevels;
    score.analyzeMetricLevel(scorelevels);
    
    int firsttime = 1;
-   int i, j, k;
-   int ii, jj;
-   int ccount;
-   static char buffer[1024] = {0};
-   int pitch;
-   int token;
-   int spine;
-   double beatvalue;
-   double track;
-   double duration;
-   double firstdur;
-   for (i=startLine; i<=endLine; i++) {
+   for (int i=startLine; i<=endLine; i++) {
       if (score[i].getType() != E_humrec_data) {
          // ignore non-note data lines
          continue;
       }
-      beatvalue = score.getAbsBeat(i);
-      ii = i;
-      for (j=0; j<score[i].getFieldCount(); j++) {
-         spine = j;
-         if (score[i].getExInterpNum(j) != E_KERN_EXINT) {
-            // ignore non-kern data spines
-            continue;
-         }
-         if (firsttime && strcmp(score[i][j], ".") == 0) {
-            // extract the held over note from a previous point in the score
-            ii = score[i].getDotLine(j);
-            jj = score[i].getDotSpine(j);
-         } else {
-            ii = i;
-            jj = j;
-         }
- 
-         if (strcmp(score[ii][jj], ".") != 0) {
-            // extract all notes in the region of interest, ignoring
-            // tied notes.
-            ccount = score[ii].getTokenCount(jj);
-            track = score[ii].getTrack(jj);
-            for (k=0; k<ccount; k++) {
-               token = k;
-               score[ii].getToken(buffer, jj, k, 128);
-               if (strchr(buffer, 'r') != NULL) {
-                  // skip over rests
-                  continue;
-               }
-               if (strchr(buffer, '_') != NULL) {
-                  // skip over doubly tied notes
-                  continue;                
-
-               }
-               if (!firsttime && strchr(buffer, ']') != NULL) {
-                  // skip over tied notes at the ends of ties.
-                  continue;
-               }
-               // have a note so now extract the metric level and the duration
-               pitch = Convert::kernToBase40(buffer);
-// cout << "read pitch: " << pitch % 40 << endl;
-               if (pitch < 0) {
-                  // ignore rests
-                  continue;
-               }
-               duration = score.getTiedDuration(ii, jj, k);
-               firstdur = Convert::kernToDuration(score[ii].getToken(buffer, jj, k));
-               if (duration == 0.0) {
-                  // ignore grace notes and other zero-dur ornaments
-                  continue;
-               }
-               currentlist.setLevel(1.0/pow(2.0, scorelevels[ii]));
-               currentlist.setFirstDur(firstdur);
-               currentlist.setDur(duration);
-               currentlist.setPitch(pitch);
-               currentlist.setAbsBeat(beatvalue);
-               currentlist.setLine(i);
-               currentlist.setTrack(track);
-               currentlist.setSpine(spine);
-               currentlist.setToken(token);
-               notelist.append(currentlist);
-               currentlist.clear();
- 
-            } // end of a chord
-         }
-      }  // end of a line
+      appendChordRootNotes(notelist, i, scorelevels, firsttime);
       firsttime = 0;
- 
    } // end of the music selection   
 
    notelist.allowGrowth(0);
@@ -479,6 +563,102 @@ void HumdrumFile::generateNoteList(NoteListArray& notelist,
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::appendChordRootNotes -- add the notes on a data line
+//     to a note list for chord root analysis.  If firstQ is true, the
+//     line is the first line of the analysis region, so notes held over
+//     from previous lines (null tokens) and the ends of ties are also
+//     included.
+//
+
+void HumdrumFile::appendChordRootNotes(NoteListArray& notelist, int line,
+      Array<int>& scorelevels, int firstQ) {
+
+   HumdrumFile& score = *this;
+   NoteList currentlist;
+   currentlist.clear();
+
+   int i = line;
+   int j, k;
+   int ii, jj;
+   int ccount;
+   char buffer[1024] = {0};
+   int pitch;
+   int token;
+   int spine;
+   double beatvalue;
+   double track;
+   double duration;
+   double firstdur;
+
+   beatvalue = score.getAbsBeat(i);
+   ii = i;
+   for (j=0; j<score[i].getFieldCount(); j++) {
+      spine = j;
+      if (score[i].getExInterpNum(j) != E_KERN_EXINT) {
+         // ignore non-kern data spines
+         continue;
+      }
+      if (firstQ && strcmp(score[i][j], ".") == 0) {
+         // extract the held over note from a previous point in the score
+         ii = score[i].getDotLine(j);
+         jj = score[i].getDotSpine(j);
+      } else {
+         ii = i;
+         jj = j;
+      }
+ 
+      if (strcmp(score[ii][jj], ".") != 0) {
+         // extract all notes in the region of interest, ignoring
+         // tied notes.
+         ccount = score[ii].getTokenCount(jj);
+         track = score[ii].getTrack(jj);
+         for (k=0; k<ccount; k++) {
+            token = k;
+            score[ii].getToken(buffer, jj, k, 128);
+            if (strchr(buffer, 'r') != NULL) {
+               // skip over rests
+               continue;
+            }
+            if (strchr(buffer, '_') != NULL) {
+               // skip over doubly tied notes
+               continue;                
+            }
+            if (!firstQ && strchr(buffer, ']') != NULL) {
+               // skip over tied notes at the ends of ties.
+               continue;
+            }
+            // have a note so now extract the metric level and the duration
+            pitch = Convert::kernToBase40(buffer);
+            if (pitch < 0) {
+               // ignore rests
+               continue;
+            }
+            duration = score.getTiedDuration(ii, jj, k);
+            firstdur = Convert::kernToDuration(score[ii].getToken(buffer, jj, k));
+            if (duration == 0.0) {
+               // ignore grace notes and other zero-dur ornaments
+               continue;
+            }
+            currentlist.setLevel(1.0/pow(2.0, scorelevels[ii]));
+            currentlist.setFirstDur(firstdur);
+            currentlist.setDur(duration);
+            currentlist.setPitch(pitch);
+            currentlist.setAbsBeat(beatvalue);
+            currentlist.setLine(i);
+            currentlist.setTrack(track);
+            currentlist.setSpine(spine);
+            currentlist.setToken(token);
+            notelist.append(currentlist);
+            currentlist.clear();
+         } // end of a chord
+      }
+   }  // end of a line
+}
+
+
+
 //////////////////////////////////////////////////////////////////////////
 //
 // old functions -- should get rid of them, but they are used by ckey
@@ -45,6 +45,15 @@
 // Last Modified: Wed Feb  2 17:51:57 PST 2011 Partial fix for breve beat
 // Last Modified: Tue Apr 16 23:18:16 PDT 2013 Added attackQ to gBase12PchLst
 // Last Modified: Mon Sep 16 20:26:17 PDT 2013 Added getMeasureNumber()
+// Last Modified: Sun Oct 18 13:05:11 PDT 2026 Added analyzeKernTokens()
+// Last Modified: Sun Oct 18 14:12:40 PDT 2026 Indexed getLast/NextDatum
+// Last Modified: Sun Oct 18 15:02:17 PDT 2026 Added analyzeTies()
+// Last Modified: Sun Oct 18 15:48:33 PDT 2026 Integer rhythm accumulation
+// Last Modified: Sun Oct 18 19:36:05 PDT 2026 Hashed analyzeCliche()
+// Last Modified: Sun Oct 18 20:24:51 PDT 2026 Binary search time index
+// Last Modified: Sun Oct 18 23:58:02 PDT 2026 Added getLastIndex()
+// Last Modified: Mon Oct 19 01:10:45 PDT 2026 restored getStartIndex results
+// Last Modified: Mon Oct 19 01:41:08 PDT 2026 datum lookups across spine splits
 // Filename:      ...sig/src/sigInfo/HumdrumFile.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFile.cpp
 // Syntax:        C++ 
@@ -65,6 +74,9 @@
 #include <cctype>
 #include <math.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 #ifndef OLDCPP
    #include <fstream>
    #include <iostream>
@@ -84,6 +96,10 @@
    #define CSTRING str()
 #endif
 
+#ifdef VISUAL
+   #define strtok_r strtok_s
+#endif
+
 // #define ROUNDERR 0.005
 // Changed on Tue Mar 23 17:48:42 PST 2004
 #define ROUNDERR 0.005
@@ -97,6 +113,11 @@
 
 HumdrumFile::HumdrumFile(void) : HumdrumFileBasic() {
    rhythmcheck = 0;
+   kerntokencheck = 0;
+   tiecheck = 0;
+   datumcheck = 0;
+   timecheck = 0;
+   timesortQ = 1;
    minrhythm = 0;
    minrhythmR = 0;
    pickupdur = -1;
@@ -107,6 +128,11 @@ HumdrumFile::HumdrumFile(void) : HumdrumFileBasic() {
 HumdrumFile::HumdrumFile(const HumdrumFile& aHumdrumFile) :
    HumdrumFileBasic(aHumdrumFile) {
    rhythmcheck = 0;
+   kerntokencheck = 0;
+   tiecheck = 0;
+   datumcheck = 0;
+   timecheck = 0;
+   timesortQ = 1;
    minrhythm = 0;
    minrhythmR = 0;
    pickupdur = -1;
@@ -116,6 +142,11 @@ HumdrumFile::HumdrumFile(const HumdrumFile& aHumdrumFile) :
 HumdrumFile::HumdrumFile(const HumdrumFileBasic& aHumdrumFile) :
    HumdrumFileBasic(aHumdrumFile) {
    rhythmcheck = 0;
+   kerntokencheck = 0;
+   tiecheck = 0;
+   datumcheck = 0;
+   timecheck = 0;
+   timesortQ = 1;
    minrhythm = 0;
    minrhythmR = 0;
    pickupdur = -1;
@@ -125,6 +156,11 @@ HumdrumFile::HumdrumFile(const HumdrumFileBasic& aHumdrumFile) :
 
 HumdrumFile::HumdrumFile(const char* filename) : HumdrumFileBasic(filename) {
    rhythmcheck = 0;
+   kerntokencheck = 0;
+   tiecheck = 0;
+   datumcheck = 0;
+   timecheck = 0;
+   timesortQ = 1;
    minrhythm = 0;
    minrhythmR = 0;
    pickupdur = -1;
@@ -151,8 +187,10 @@ HumdrumFile::~HumdrumFile() {
 //
 
 void HumdrumFile::analyzeRhythm(const char* base, int debug) {
+   clearTimeIndex();
    privateRhythmAnalysis(base, debug);
    rhythmcheck = 1;
+   rhythmbase = (base == NULL) ? "" : base;
 }
 
 
@@ -206,105 +244,460 @@ RationalNumber HumdrumFile::getPickupDurR(void) {
 
 //////////////////////////////
 //
-// getStartIndex -- Given an absolute beat, return the first 
-//    line starting at that time or just after if there is no
-//    items at the specified time.
+// getStartIndex -- Given an absolute beat, return the last line
+//    of the time position containing it.  A beat between two time
+//    positions returns the last line of the earlier position; a beat
+//    before the first time position or after the last one returns the
+//    last line of the file.  The results are the same as the original
+//    line-by-line search (whose quirks at exact onsets are kept for the
+//    RationalNumber version, which uses strict comparisons), but the
+//    lines are found with a binary search of the time index.  The double
+//    version matches times within ROUNDERR of the given beat.
 //
  
 int HumdrumFile::getStartIndex(double startbeat) {
+   if (!timecheck) {
+      buildTimeIndex();
+   }
    HumdrumFile& score = *this;
-   int index = 1;
-   while (index < score.getNumLines() - 1) {
-      if (score[index+1].getAbsBeat() == score[index].getAbsBeat()) {
+   int lines = getNumLines();
+   if (!timesortQ) {
+      int index = 1;
+      while (index < lines - 1) {
+         if (score[index+1].getAbsBeat() == score[index].getAbsBeat()) {
+            index++;
+            continue;
+         }
+         if (startbeat < score[index].getAbsBeat() + ROUNDERR &&
+             startbeat > score[index-1].getAbsBeat() - ROUNDERR) {
+            return index;
+         }
+         if (startbeat > score[index].getAbsBeat() + ROUNDERR &&
+             startbeat < score[index+1].getAbsBeat() - ROUNDERR) {
+            return index;
+         }
          index++;
-         continue;
-      }
-      if (startbeat < score[index].getAbsBeat() + ROUNDERR &&
-          startbeat > score[index-1].getAbsBeat() - ROUNDERR) {
-         return index;
       }
-      if (startbeat > score[index].getAbsBeat() + ROUNDERR &&
-          startbeat < score[index+1].getAbsBeat() - ROUNDERR) {
-         return index;
-      }
-      index++;
+      return lines - 1;
    }
- 
-   return score.getNumLines() - 1;
+
+   // Only the last line of each time position before the final one
+   // is a candidate, and never line 0.
+   int count = (int)timebeats.size();
+   int low   = (count > 0 && timelastline[0] == 0) ? 1 : 0;
+   int high  = count - 2;
+   int best  = count;
+   int k;
+
+   // last line at a time just after the beat:
+   k = (int)(partition_point(timebeats.begin(), timebeats.end(),
+         [startbeat](double t) { return !(startbeat < t + ROUNDERR); })
+         - timebeats.begin());
+   if (k < low) {
+      k = low;
+   }
+   if ((k <= high) && 
+         (startbeat > score[timelastline[k]-1].getAbsBeat() - ROUNDERR)) {
+      best = k;
+   }
+
+   // last line at a time just before the beat:
+   k = (int)(partition_point(timebeats.begin(), timebeats.end(),
+         [startbeat](double t) { return !(startbeat < t - ROUNDERR); })
+         - timebeats.begin()) - 1;
+   if (k < low) {
+      k = low;
+   }
+   if ((k <= high) && (k < best) &&
+         (startbeat > timebeats[k] + ROUNDERR)) {
+      best = k;
+   }
+
+   if (best >= count) {
+      return lines - 1;
+   }
+   return timelastline[best];
 }
  
 
 int HumdrumFile::getStartIndex(RationalNumber startbeat) {
+   if (!timecheck) {
+      buildTimeIndex();
+   }
    HumdrumFile& score = *this;
-   int index = 1;
-   while (index < score.getNumLines() - 1) {
-      if (score[index+1].getAbsBeatR() == score[index].getAbsBeatR()) {
+   int lines = getNumLines();
+   if (!timesortQ) {
+      int index = 1;
+      while (index < lines - 1) {
+         if (score[index+1].getAbsBeatR() == score[index].getAbsBeatR()) {
+            index++;
+            continue;
+         }
+         if ((startbeat < score[index].getAbsBeatR()) &&
+             (startbeat > score[index-1].getAbsBeatR() ) ) {
+            return index;
+         }
+         if ((startbeat > score[index].getAbsBeatR()) &&
+             (startbeat < score[index+1].getAbsBeatR() ) ) {
+            return index;
+         }
          index++;
-         continue;
       }
-      if ((startbeat < score[index].getAbsBeatR()) &&
-          (startbeat > score[index-1].getAbsBeatR() ) ) {
-         return index;
-      }
-      if ((startbeat > score[index].getAbsBeatR()) &&
-          (startbeat < score[index+1].getAbsBeatR() ) ) {
-         return index;
-      }
-      index++;
+      return lines - 1;
    }
- 
-   return score.getNumLines() - 1;
+
+   int count = (int)timestamps.size();
+   int low   = (count > 0 && timelastline[0] == 0) ? 1 : 0;
+   int high  = count - 2;
+   int best  = count;
+   int k;
+
+   k = (int)(upper_bound(timestamps.begin(), timestamps.end(),
+         startbeat) - timestamps.begin());
+   if (k < low) {
+      k = low;
+   }
+   if ((k <= high) && 
+         (startbeat > score[timelastline[k]-1].getAbsBeatR())) {
+      best = k;
+   }
+
+   k = (int)(upper_bound(timestamps.begin(), timestamps.end(),
+         startbeat) - timestamps.begin()) - 1;
+   if (k < low) {
+      k = low;
+   }
+   if ((k <= high) && (k < best) && (startbeat > timestamps[k])) {
+      best = k;
+   }
+
+   if (best >= count) {
+      return lines - 1;
+   }
+   return timelastline[best];
 }
 
 
 
 //////////////////////////////
 //
-// getStopIndex -- Given an absolute beat, return the last item
-//    occuring on that beat.  If there is no items at that time,
-//    then return the first item before the specified time.
+// getStopIndex -- Given an absolute beat, return the first line
+//    occuring on that beat.  If there are no lines at that time, then
+//    return the last line before the specified time.  A beat at or
+//    before the start of the music returns line 1 if it matches the
+//    first time position (within ROUNDERR for the double version),
+//    otherwise the last line of the file, which is also returned for a
+//    beat after the end of the music.  The results are the same as the
+//    original line-by-line search, but the lines are found with a
+//    binary search of the time index.  See getLastIndex() for the last
+//    line at or before a given time.
 //
 
 int HumdrumFile::getStopIndex(double stopbeat) {
+   if (!timecheck) {
+      buildTimeIndex();
+   }
    HumdrumFile& score = *this;
-   int index = 1;
-   while (index < score.getNumLines()) {
-      if (stopbeat <= score[index].getAbsBeat() + ROUNDERR &&
-          stopbeat > score[index-1].getAbsBeat() - ROUNDERR) {
-         return index;
+   int lines = getNumLines();
+   if (!timesortQ) {
+      int index = 1;
+      while (index < lines) {
+         if (stopbeat <= score[index].getAbsBeat() + ROUNDERR &&
+             stopbeat > score[index-1].getAbsBeat() - ROUNDERR) {
+            return index;
+         }
+         if (index + 1 < lines &&
+             stopbeat > score[index].getAbsBeat() + ROUNDERR &&
+             stopbeat < score[index+1].getAbsBeat() - ROUNDERR) {
+            return index;
+         }
+         index++;
+      }
+      return lines - 1;
+   }
+
+   int count = (int)timebeats.size();
+   int best  = lines;
+   int k;
+   int index;
+
+   // first line at or just after the beat:
+   k = (int)(partition_point(timebeats.begin(), timebeats.end(),
+         [stopbeat](double t) { return !(stopbeat <= t + ROUNDERR); })
+         - timebeats.begin());
+   if (k < count) {
+      index = getFirstTimeLine(k);
+      if (index < 1) {
+         index = 1;
       }
-      if (stopbeat > score[index].getAbsBeat() + ROUNDERR &&
-          stopbeat < score[index+1].getAbsBeat() - ROUNDERR) {
-         return index;
+      if ((index < lines) && 
+            (stopbeat > score[index-1].getAbsBeat() - ROUNDERR)) {
+         best = index;
       }
-      index++;
    }
- 
-   return score.getNumLines() - 1;
+
+   // last line before the beat when no line is near the beat:
+   k = (int)(partition_point(timebeats.begin(), timebeats.end(),
+         [stopbeat](double t) { return !(stopbeat < t - ROUNDERR); })
+         - timebeats.begin());
+   if (k < count) {
+      index = getFirstTimeLine(k) - 1;
+      if (index < 1) {
+         index = 1;
+      }
+      if ((index < best) && (index + 1 < lines) &&
+            (stopbeat > score[index].getAbsBeat() + ROUNDERR)) {
+         best = index;
+      }
+   }
+
+   if (best >= lines) {
+      return lines - 1;
+   }
+   return best;
 }         
 
 
 
 int HumdrumFile::getStopIndex(RationalNumber stopbeat) {
+   if (!timecheck) {
+      buildTimeIndex();
+   }
    HumdrumFile& score = *this;
-   int index = 1;
-   while (index < score.getNumLines()) {
-      if ((stopbeat <= score[index].getAbsBeatR() ) &&
-          (stopbeat > score[index-1].getAbsBeatR() ) ) {
-         return index;
+   int lines = getNumLines();
+   if (!timesortQ) {
+      int index = 1;
+      while (index < lines) {
+         if ((stopbeat <= score[index].getAbsBeatR() ) &&
+             (stopbeat > score[index-1].getAbsBeatR() ) ) {
+            return index;
+         }
+         if ((index + 1 < lines) &&
+             (stopbeat > score[index].getAbsBeatR() ) &&
+             (stopbeat < score[index+1].getAbsBeatR() ) ) {
+            return index;
+         }
+         index++;
+      }
+      return lines - 1;
+   }
+
+   int count = (int)timestamps.size();
+   int best  = lines;
+   int k;
+   int index;
+
+   k = (int)(lower_bound(timestamps.begin(), timestamps.end(),
+         stopbeat) - timestamps.begin());
+   if (k < count) {
+      index = getFirstTimeLine(k);
+      if (index < 1) {
+         index = 1;
       }
-      if ((stopbeat > score[index].getAbsBeatR() ) &&
-          (stopbeat < score[index+1].getAbsBeatR() ) ) {
-         return index;
+      if ((index < lines) && (stopbeat > score[index-1].getAbsBeatR())) {
+         best = index;
       }
-      index++;
    }
- 
-   return score.getNumLines() - 1;
+
+   k = (int)(upper_bound(timestamps.begin(), timestamps.end(),
+         stopbeat) - timestamps.begin());
+   if (k < count) {
+      index = getFirstTimeLine(k) - 1;
+      if (index < 1) {
+         index = 1;
+      }
+      if ((index < best) && (index + 1 < lines) &&
+            (stopbeat > score[index].getAbsBeatR())) {
+         best = index;
+      }
+   }
+
+   if (best >= lines) {
+      return lines - 1;
+   }
+   return best;
+}         
+
+
+
+//////////////////////////////
+//
+// getLastIndex -- Given an absolute beat, return the last line
+//    occuring on that beat.  If there are no lines at that time,
+//    then return the last line before the specified time.  Returns
+//    the first line of the file if the beat is before the start of the
+//    music.  This differs from getStopIndex() only when there are
+//    several lines at the given beat.  The double version matches times
+//    within ROUNDERR of the given beat.  Uses a binary search of the
+//    time index.
+//
+
+int HumdrumFile::getLastIndex(double beat) {
+   if (!timecheck) {
+      buildTimeIndex();
+   }
+   int count = (int)timebeats.size();
+   int index;
+   if (timesortQ) {
+      index = (int)(upper_bound(timebeats.begin(), timebeats.end(),
+            beat + ROUNDERR) - timebeats.begin()) - 1;
+      if (index >= 0 && !(timebeats[index] < beat + ROUNDERR)) {
+         index--;
+      }
+   } else {
+      for (index=count-1; index>=0; index--) {
+         if (timebeats[index] < beat + ROUNDERR) {
+            break;
+         }
+      }
+   }
+   if (index < 0) {
+      return 0;
+   }
+   return timelastline[index];
+}         
+
+
+
+int HumdrumFile::getLastIndex(RationalNumber beat) {
+   if (!timecheck) {
+      buildTimeIndex();
+   }
+   int count = (int)timestamps.size();
+   int index;
+   if (timesortQ) {
+      index = (int)(upper_bound(timestamps.begin(), timestamps.end(),
+            beat) - timestamps.begin()) - 1;
+   } else {
+      for (index=count-1; index>=0; index--) {
+         if (!(beat < timestamps[index])) {
+            break;
+         }
+      }
+   }
+   if (index < 0) {
+      return 0;
+   }
+   return timelastline[index];
 }         
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::getIndexRanges -- Find the start and stop line indexes
+//    (as given by getStartIndex() and getStopIndex()) for a list of
+//    time windows, such as the windows of a sliding-window analysis.
+//    Each lookup is a binary search of the time index, which is built
+//    once for all of the windows.
+//
+
+void HumdrumFile::getIndexRanges(Array<int>& startindex, 
+      Array<int>& stopindex, Array<RationalNumber>& startbeats, 
+      Array<RationalNumber>& stopbeats) {
+   if (!timecheck) {
+      buildTimeIndex();
+   }
+   int size = startbeats.getSize();
+   if (stopbeats.getSize() < size) {
+      size = stopbeats.getSize();
+   }
+   startindex.setSize(size);
+   stopindex.setSize(size);
+   for (int i=0; i<size; i++) {
+      startindex[i] = getStartIndex(startbeats[i]);
+      stopindex[i] = getStopIndex(stopbeats[i]);
+   }
+}
+
+
+void HumdrumFile::getIndexRanges(Array<int>& startindex, 
+      Array<int>& stopindex, Array<double>& startbeats, 
+      Array<double>& stopbeats) {
+   int size = startbeats.getSize();
+   if (stopbeats.getSize() < size) {
+      size = stopbeats.getSize();
+   }
+   startindex.setSize(size);
+   stopindex.setSize(size);
+   for (int i=0; i<size; i++) {
+      startindex[i] = getStartIndex(startbeats[i]);
+      stopindex[i] = getStopIndex(stopbeats[i]);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::buildTimeIndex -- Store the distinct absolute beat
+//    positions of the file and the last line at each position, so that
+//    time-range queries can be done with a binary search.  Lines with
+//    the same absolute beat are consecutive in a valid file; if the
+//    absolute beats ever decrease, the queries fall back to a linear
+//    search of the index.
+//
+
+void HumdrumFile::buildTimeIndex(void) {
+   HumdrumFile& file = *this;
+   timestamps.clear();
+   timebeats.clear();
+   timelastline.clear();
+   timesortQ = 1;
+
+   RationalNumber beat;
+   int size;
+   for (int i=0; i<file.getNumLines(); i++) {
+      beat = file[i].getAbsBeatR();
+      size = (int)timestamps.size();
+      if ((size > 0) && (timestamps[size-1] == beat)) {
+         timelastline[size-1] = i;
+         continue;
+      }
+      if ((size > 0) && (beat < timestamps[size-1])) {
+         timesortQ = 0;
+      }
+      timestamps.push_back(beat);
+      timebeats.push_back(beat.getFloat());
+      timelastline.push_back(i);
+   }
+   timecheck = 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getFirstTimeLine -- return the first line at the given
+//     position in the time index.  Only valid when the absolute beats
+//     of the file are in ascending order.
+//
+
+int HumdrumFile::getFirstTimeLine(int index) {
+   if (index <= 0) {
+      return 0;
+   }
+   return timelastline[index-1] + 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::clearTimeIndex -- remove the getStartIndex/getStopIndex
+//     lookup tables.
+//
+
+void HumdrumFile::clearTimeIndex(void) {
+   timecheck = 0;
+   timesortQ = 1;
+   timestamps.clear();
+   timebeats.clear();
+   timelastline.clear();
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFile::appendLine  -- adds a line to a humdrum file
@@ -313,12 +706,18 @@ int HumdrumFile::getStopIndex(RationalNumber stopbeat) {
 void HumdrumFile::appendLine(const char* aLine) {
    HumdrumFileBasic::appendLine(aLine);
    rhythmcheck = 0;
+   clearKernTokens();
+   clearDatumIndex();
+   clearTimeIndex();
 }
 
 
 void HumdrumFile::appendLine(HumdrumRecord& aRecord) {
    HumdrumFileBasic::appendLine(aRecord);
    rhythmcheck = 0;
+   clearKernTokens();
+   clearDatumIndex();
+   clearTimeIndex();
 }
    
 
@@ -1389,6 +1788,9 @@ int HumdrumFile::processLinesForCombine(HumdrumFile& output, HumdrumFile& A,
 void HumdrumFile::clear(void) {
    HumdrumFileBasic::clear();
    rhythmcheck = 0;
+   clearKernTokens();
+   clearDatumIndex();
+   clearTimeIndex();
    pickupdur = -1;
    localrhythms.setSize(0);
 }
@@ -1463,11 +1865,18 @@ int HumdrumFile::hasNoteAttack(int line) {
       return 0;
    }
    int i;
+   int j;
    for (i=0; i<afile[line].getFieldCount(); i++) {
       if (!afile[line].isExInterp(i, "**kern")) {
          continue;
       }
-      if (afile[line].hasNoteAttack(i)) {
+      if (kerntokencheck) {
+         for (j=0; j<getKernTokenCount(line, i); j++) {
+            if (getKernToken(line, i, j).isNoteAttack()) {
+               return 1;
+            }
+         }
+      } else if (afile[line].hasNoteAttack(i)) {
          return 1;
       }
    }
@@ -1500,52 +1909,7 @@ const char* HumdrumFile::getLastDatum(int index, int spine, int options) {
 
 int HumdrumFile::getLastDatumLine(int& nspine, int index, int spine, 
       int options) { 
-   HumdrumFile& file = *this;
-   int i = index  - 1;
-   int j;
-   int lastspine = -1;
-   double currenttrack = file[index].getTrack(spine);
-   while (i >= 0) {
-      if (file[i].getType() != E_humrec_data) {
-         i--;
-         continue;
-      }
-
-      // find matching spine
-      lastspine = -1;
-      for (j=0; j<file[i].getFieldCount(); j++) {
-         if (file[i].getTrack(j) == currenttrack) {
-            lastspine = j;
-            break;
-         }
-      }
-      if (lastspine == -1) {
-         for (j=0; j<file[i].getFieldCount(); j++) {
-            if (file[i].getTrack(j) == currenttrack) {
-               lastspine = j;
-               break;
-            }
-         }
-      }
-
-      if (lastspine == -1) {
-         nspine = lastspine;
-         return -1;
-      }
-
-      if (strcmp(file[i][j], ".") == 0) {
-         i--;
-         continue;
-      } else {
-         nspine = j;
-         return i;
-      }
-
-   }
-
-   // At the beginning of the file, no previous data
-   nspine = -1;
-   return -1;
+   return getDatumLine(nspine, index, spine, -1);
 }
 
 
@@ -1572,50 +1936,227 @@ const char* HumdrumFile::getNextDatum(int index, int spine, int options) {
 int HumdrumFile::getNextDatumLine(int& nspine, int index, int spine, 
       int options) { 
    HumdrumFile& file = *this;
-   RationalNumber duration(0,1);
-   int nextline = -1;
-   if (options == 0) {
-      // search for next note based on the tied duration of the current note
-      duration = getTiedDurationR(index, spine);
-   } else {
-      // search for next note based including tied notes (ignore ties)
-      duration = Convert::kernToDurationR(file[index][spine]);
+   int nextline = getDatumLine(nspine, index, spine, +1);
+   if (options != 0) {
+      return nextline;
    }
 
-   if (duration >= getTotalDurationR()) {
-      nspine = -1;
+   // skip over the continuations and endings of ties on the first note.
+   const char* ptr;
+   int tiedQ = 1;
+   while (tiedQ && (nextline >= 0)) {
+      tiedQ = 0;
+      for (ptr = file[nextline][nspine]; (*ptr != '\0') && (*ptr != ' '); 
+            ptr++) {
+         if ((*ptr == '_') || (*ptr == ']')) {
+            tiedQ = 1;
+            break;
+         }
+      }
+      if (tiedQ) {
+         nextline = getDatumLine(nspine, nextline, nspine, +1);
+      }
+   }
+
+   return nextline;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getDatumLine -- Look up the previous (direction < 0) or
+//     next (direction > 0) non-null data token in the same track as the
+//     given field.  Across a spine split or merge, where the track does
+//     not exist on the adjacent data line, the search continues in the
+//     first field of the same primary track on that line (see
+//     findDatumField()).
+//
+
+int HumdrumFile::getDatumLine(int& nspine, int index, int spine, 
+      int direction) {
+   HumdrumFile& file = *this;
+   nspine = -1;
+   if ((index < 0) || (index >= file.getNumLines()) || (spine < 0) ||
+         (spine >= file[index].getFieldCount())) {
       return -1;
    }
-   nextline = getStartIndex(getAbsBeatR(index) + duration);
-   while (nextline < getNumLines() && getType(nextline) != E_humrec_data ) {
-      nextline++;
+   if (!datumcheck) {
+      buildDatumIndex();
    }
-   if (nextline >= file.getNumLines()) {
-      nspine = -1;
+
+   vector<int>& dataline  = (direction < 0) ? lastdataline   : nextdataline;
+   vector<int>& datumline = (direction < 0) ? lastdatumline  : nextdatumline;
+   vector<int>& datumfield= (direction < 0) ? lastdatumfield : nextdatumfield;
+
+   if (file[index].isData()) {
+      int entry = datumlineindex[index] + spine;
+      nspine = datumfield[entry];
+      return datumline[entry];
+   }
+
+   // non-data lines are not in the index: resolve the first step here.
+   int line = dataline[index];
+   if (line < 0) {
       return -1;
    }
+   int field = findDatumField(line, file[index].getTrack(spine));
+   if (field < 0) {
+      return -1;
+   }
+   if (strcmp(file[line][field], ".") != 0) {
+      nspine = field;
+      return line;
+   }
+   int entry = datumlineindex[line] + field;
+   nspine = datumfield[entry];
+   return datumline[entry];
+}
 
-   int i;
-   double currenttrack = file[index].getTrack(spine);
 
-   for (i=0; i<file[nextline].getFieldCount(); i++) {
-      if (file[nextline].getTrack(i) == currenttrack) {
-         nspine = i;
-         return nextline;
+
+//////////////////////////////
+//
+// HumdrumFile::buildDatumIndex -- Store the location of the previous
+//     and next non-null data token in the same track for every field
+//     on every data line.  Null tokens are resolved through the token
+//     on the adjacent data line, so the index is built in a single pass 
+//     in each direction.
+//
+
+void HumdrumFile::buildDatumIndex(void) {
+   HumdrumFile& file = *this;
+   int lines = file.getNumLines();
+
+   datumlineindex.resize(lines + 1);
+   lastdataline.resize(lines);
+   nextdataline.resize(lines);
+
+   int i, j;
+   int count = 0;
+   int line = -1;
+   for (i=0; i<lines; i++) {
+      datumlineindex[i] = count;
+      lastdataline[i] = line;
+      if (file[i].isData()) {
+         count += file[i].getFieldCount();
+         line = i;
+      }
+   }
+   datumlineindex[lines] = count;
+   line = -1;
+   for (i=lines-1; i>=0; i--) {
+      nextdataline[i] = line;
+      if (file[i].isData()) {
+         line = i;
+      }
+   }
+
+   datumtrack.resize(count);
+   for (i=0; i<lines; i++) {
+      if (!file[i].isData()) {
+         continue;
+      }
+      for (j=0; j<file[i].getFieldCount(); j++) {
+         datumtrack[datumlineindex[i] + j] = file[i].getTrack(j);
       }
    }
 
-   // didn't find exact track, search for first matching primary track
-   for (i=0; i<file[nextline].getFieldCount(); i++) {
-      if (file[nextline].getPrimaryTrack(i) == (int)currenttrack) {
-         nspine = i;
-         return nextline;
+   lastdatumline.assign(count, -1);
+   lastdatumfield.assign(count, -1);
+   nextdatumline.assign(count, -1);
+   nextdatumfield.assign(count, -1);
+
+   int direction;
+   int start, stop, step;
+   int entry, other;
+   int field;
+   for (direction=-1; direction<=1; direction+=2) {
+      vector<int>& dataline  = (direction < 0) ? lastdataline  : nextdataline;
+      vector<int>& datumline = (direction < 0) ? lastdatumline : nextdatumline;
+      vector<int>& datumfield= (direction < 0) ? lastdatumfield: nextdatumfield;
+      // process lines in the opposite order of the search direction so
+      // that the adjacent line is always finished first.
+      if (direction < 0) {
+         start = 0;        stop = lines; step = +1;
+      } else {
+         start = lines-1;  stop = -1;    step = -1;
+      }
+      for (i=start; i!=stop; i+=step) {
+         if (!file[i].isData()) {
+            continue;
+         }
+         line = dataline[i];
+         if (line < 0) {
+            continue;
+         }
+         for (j=0; j<file[i].getFieldCount(); j++) {
+            entry = datumlineindex[i] + j;
+            field = findDatumField(line, datumtrack[entry]);
+            if (field < 0) {
+               continue;
+            }
+            if (strcmp(file[line][field], ".") != 0) {
+               datumline[entry]  = line;
+               datumfield[entry] = field;
+            } else {
+               other = datumlineindex[line] + field;
+               datumline[entry]  = datumline[other];
+               datumfield[entry] = datumfield[other];
+            }
+         }
       }
    }
 
-   // shouldn't get to this line;
+   datumcheck = 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::findDatumField -- Return the first field on the given
+//     data line which has the given track number.  If there is none
+//     (the track was split off from, or merged into, another subspine
+//     between the two lines), return the first field with the same
+//     primary track, or -1 if there is none.
+//
+
+int HumdrumFile::findDatumField(int line, double track) {
+   int i;
+   int start = datumlineindex[line];
+   int stop = datumlineindex[line+1];
+   for (i=start; i<stop; i++) {
+      if (datumtrack[i] == track) {
+         return i - start;
+      }
+   }
+   for (i=start; i<stop; i++) {
+      if ((int)datumtrack[i] == (int)track) {
+         return i - start;
+      }
+   }
    return -1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::clearDatumIndex -- remove the getLastDatum/getNextDatum
+//     index.
+//
 
+void HumdrumFile::clearDatumIndex(void) {
+   datumcheck = 0;
+   datumlineindex.clear();
+   datumtrack.clear();
+   lastdatumline.clear();
+   lastdatumfield.clear();
+   nextdatumline.clear();
+   nextdatumfield.clear();
+   lastdataline.clear();
+   nextdataline.clear();
 }
 
 
@@ -1915,7 +2456,7 @@ void HumdrumFile::getNoteArray(Array<double>& absbeat,
    int i, j, k;
    int ii, jj;
    int ccount;
-   static char buffer[1024] = {0};
+   char buffer[1024] = {0};
    int pitch;
    double beatvalue;
    double duration;
@@ -2077,7 +2618,7 @@ void HumdrumFile::getNoteArray2(Array<double>& absbeat,
    int i, j, k;
    int ii, jj;
    int ccount;
-   static char buffer[1024] = {0};
+   char buffer[1024] = {0};
    int pitch;
    double beatvalue;
    double duration;
@@ -2191,13 +2732,32 @@ void HumdrumFile::getNoteArray2(Array<double>& absbeat,
 
 //////////////////////////////
 //
-// convertKernStringToArray --  extract the base 40 notes from kern data.
+// HumdrumFile::clearKernTokens -- remove analyzeKernTokens() data.
 //
 
-void HumdrumFile::convertKernStringToArray(Array<int>& array, 
-      const char* string) {
-   array.setSize(0);
-   int note;
+void HumdrumFile::clearKernTokens(void) {
+   kerntokencheck = 0;
+   kerntokens.clear();
+   kernlineindex.clear();
+   kernfieldindex.clear();
+   tiecheck = 0;
+   tieline.clear();
+   tiefield.clear();
+   tietoken.clear();
+   tieduration.clear();
+}
+
+
+
+//////////////////////////////
+//
+// convertKernStringToArray --  extract the base 40 notes from kern data.
+//
+
+void HumdrumFile::convertKernStringToArray(Array<int>& array, 
+      const char* string) {
+   array.setSize(0);
+   int note;
    char* buffer;
    int size = strlen(string);
    if (size == 0) {
@@ -2206,11 +2766,12 @@ void HumdrumFile::convertKernStringToArray(Array<int>& array,
    buffer = new char[size+1];
    strcpy(buffer, string);
    char* ptr;
-   ptr = strtok(buffer, " \t\n");
+   char* saveptr = NULL;
+   ptr = strtok_r(buffer, " \t\n", &saveptr);
    while (ptr != NULL) {
       note = Convert::kernToBase40(ptr);
       array.append(note);
-      ptr = strtok(NULL, " \t\n");
+      ptr = strtok_r(NULL, " \t\n", &saveptr);
    }
    delete [] buffer;
    buffer = NULL;
@@ -2243,14 +2804,30 @@ RationalNumber HumdrumFile::getTiedDurationR(int linenum, int field,
    int done = 0;                 // true when end of tied note is found
    int startpitch = 0;           // starting pitch of the tie
    int matchpitch = 0;           // current matching pitch of the tie
+   int tieflags;                 // tie markers in the current field
+   int cacheQ = kerntokencheck && 
+                (token < getKernTokenCount(linenum, field));
    
-   file[linenum].getToken(buffer, field, token);
-   if (strchr(buffer, '[')) {
-      duration = Convert::kernToDurationR(buffer);
-      // allow for enharmonic ties:
-      startpitch = Convert::kernToMidiNoteNumber(buffer);
+   if (cacheQ && tiecheck) {
+      return tieduration[kernfieldindex[kernlineindex[linenum]+field]+token];
+   }
+
+   if (cacheQ) {
+      const KernToken& note = getKernToken(linenum, field, token);
+      if (!note.isTieStart()) {
+         return note.getDurationR();
+      }
+      duration = note.getDurationR();
+      startpitch = note.getMidiNoteNumber();
    } else {
-      return Convert::kernToDurationR(buffer);
+      file[linenum].getToken(buffer, field, token);
+      if (strchr(buffer, '[')) {
+         duration = Convert::kernToDurationR(buffer);
+         // allow for enharmonic ties:
+         startpitch = Convert::kernToMidiNoteNumber(buffer);
+      } else {
+         return Convert::kernToDurationR(buffer);
+      }
    }
 
 // not quite perfect: if two primary tracks with common ties, will have prob:
@@ -2269,24 +2846,37 @@ RationalNumber HumdrumFile::getTiedDurationR(int linenum, int field,
             continue;
          }
 
-         if (strchr(file[currentLine][m], '_')) {
-            matchpitch = Convert::kernToMidiNoteNumber(file[currentLine][m]);
-            if (startpitch == matchpitch) {
-               duration += Convert::kernToDurationR(file[currentLine][m]);
-            } else {
-               done = 1;
+         if (cacheQ) {
+            tieflags = getKernFieldFlags(currentLine, m);
+         } else {
+            tieflags = 0;
+            if (strchr(file[currentLine][m], '_')) {
+               tieflags |= KT_TIE_CONTINUE;
             }
-            break;
-         } else if (strchr(file[currentLine][m], ']')) {
+            if (strchr(file[currentLine][m], ']')) {
+               tieflags |= KT_TIE_END;
+            }
+         }
+         if (!(tieflags & (KT_TIE_CONTINUE | KT_TIE_END))) {
+            continue;
+         }
+
+         if (cacheQ) {
+            matchpitch = getKernToken(currentLine, m).getMidiNoteNumber();
+         } else {
             matchpitch = Convert::kernToMidiNoteNumber(file[currentLine][m]);
-            if (startpitch == matchpitch) {
-               duration += Convert::kernToDurationR(file[currentLine][m]);
-               done = 1;
+         }
+         if (startpitch == matchpitch) {
+            if (cacheQ) {
+               duration += getKernToken(currentLine, m).getDurationR();
             } else {
-               done = 1;
+               duration += Convert::kernToDurationR(file[currentLine][m]);
             }
-            break;
          }
+         if ((startpitch != matchpitch) || !(tieflags & KT_TIE_CONTINUE)) {
+            done = 1;
+         }
+         break;
       }
       currentLine++;
    }
@@ -2306,6 +2896,16 @@ RationalNumber HumdrumFile::getTiedDurationR(int linenum, int field,
 
 RationalNumber HumdrumFile::getTotalTiedDurationR(int linenum, int field, 
       int token) {
+   if (tiecheck && (token < getKernTokenCount(linenum, field))) {
+      int index = kernfieldindex[kernlineindex[linenum]+field] + token;
+      if (tieline[index] < 0) {
+         return tieduration[index];
+      }
+      index = kernfieldindex[kernlineindex[tieline[index]]+tiefield[index]] 
+            + tietoken[index];
+      return tieduration[index];
+   }
+
    char buffer[128] = {0};
    (*this)[linenum].getToken(buffer, field, token);
 
@@ -2329,6 +2929,8 @@ RationalNumber HumdrumFile::getTotalTiedDurationR(int linenum, int field,
 //////////////////////////////
 //
 // HumdrumFile::getTiedStartLocation --  Need to generalize to chords.
+//     Chords are handled if analyzeTies() has been done, in which case
+//     the location is set to -1 if the start of the tie cannot be found.
 //
 
 void HumdrumFile::getTiedStartLocation(int linenum, int field, int token, 
@@ -2341,6 +2943,14 @@ void HumdrumFile::getTiedStartLocation(int linenum, int field, int token,
    int done = 0;                  // true when end of tied note is found
    int startpitch = 0;            // starting pitch of the tie
    int matchpitch = 0;            // current matching pitch of the tie
+
+   if (tiecheck && (token < getKernTokenCount(linenum, field))) {
+      int index = kernfieldindex[kernlineindex[linenum]+field] + token;
+      tline = tieline[index];
+      tcol  = tiefield[index];
+      ttok  = tietoken[index];
+      return;
+   }
    
    file[linenum].getToken(buffer, field, token);
    if ((strchr(buffer, ']') != NULL) || (strchr(buffer, '_') != NULL)) {
@@ -2520,6 +3130,7 @@ HumdrumFile& HumdrumFile::operator=(const HumdrumFile& aFile) {
       delete records[i];
       records[i] = NULL;
    }
+   clearArenas();
 
    records.setSize(aFile.records.getSize());
    for (i=0; i<aFile.records.getSize(); i++) {
@@ -2528,6 +3139,30 @@ HumdrumFile& HumdrumFile::operator=(const HumdrumFile& aFile) {
    }
 
    rhythmcheck = aFile.rhythmcheck;
+   rhythmbase = aFile.rhythmbase;
+   kerntokencheck = aFile.kerntokencheck;
+   kerntokens = aFile.kerntokens;
+   kernlineindex = aFile.kernlineindex;
+   kernfieldindex = aFile.kernfieldindex;
+   tiecheck = aFile.tiecheck;
+   tieline = aFile.tieline;
+   tiefield = aFile.tiefield;
+   tietoken = aFile.tietoken;
+   tieduration = aFile.tieduration;
+   datumcheck = aFile.datumcheck;
+   datumlineindex = aFile.datumlineindex;
+   datumtrack = aFile.datumtrack;
+   lastdatumline = aFile.lastdatumline;
+   lastdatumfield = aFile.lastdatumfield;
+   nextdatumline = aFile.nextdatumline;
+   nextdatumfield = aFile.nextdatumfield;
+   lastdataline = aFile.lastdataline;
+   nextdataline = aFile.nextdataline;
+   timecheck = aFile.timecheck;
+   timesortQ = aFile.timesortQ;
+   timestamps = aFile.timestamps;
+   timebeats = aFile.timebeats;
+   timelastline = aFile.timelastline;
    maxtracks = aFile.maxtracks;
    localrhythms = aFile.localrhythms;
 
@@ -2555,12 +3190,27 @@ void HumdrumFile::read(const string& filename) {
 void HumdrumFile::read(const char* filename) {
    HumdrumFileBasic::read(filename);
    rhythmcheck = 0;
+   clearKernTokens();
+   clearDatumIndex();
+   clearTimeIndex();
 }
 
 
 void HumdrumFile::read(istream& inStream) {
    HumdrumFileBasic::read(inStream);
    rhythmcheck = 0;
+   clearKernTokens();
+   clearDatumIndex();
+   clearTimeIndex();
+}
+
+
+void HumdrumFile::readMemory(const char* text, int length) {
+   HumdrumFileBasic::readMemory(text, length);
+   rhythmcheck = 0;
+   clearKernTokens();
+   clearDatumIndex();
+   clearTimeIndex();
 }
 
 
@@ -2584,6 +3234,265 @@ int HumdrumFile::rhythmQ(void) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::analyzeKernTokens -- Parse every subtoken of every
+//     **kern data field once, so that the pitch, duration and tie
+//     state of notes can be looked up without re-parsing the token
+//     strings.  Subtokens are split on spaces in the same way as
+//     HumdrumRecord::getToken().  The analysis is discarded when the
+//     file is read or lines are appended, but not when individual
+//     fields are changed, so call this function again after editing
+//     **kern data.
+//
+
+void HumdrumFile::analyzeKernTokens(void) {
+   HumdrumFile& infile = *this;
+   int lines = infile.getNumLines();
+
+   clearKernTokens();
+   kernlineindex.resize(lines + 1);
+
+   int i, j;
+   const char* ptr;
+   const char* start;
+   for (i=0; i<lines; i++) {
+      kernlineindex[i] = (int)kernfieldindex.size();
+      if (!infile[i].isData()) {
+         continue;
+      }
+      for (j=0; j<infile[i].getFieldCount(); j++) {
+         kernfieldindex.push_back((int)kerntokens.size());
+         if (infile[i].getExInterpNum(j) != E_KERN_EXINT) {
+            continue;
+         }
+         ptr = infile[i][j];
+         while (*ptr != '\0') {
+            while (*ptr == ' ') {
+               ptr++;
+            }
+            if (*ptr == '\0') {
+               break;
+            }
+            start = ptr;
+            while ((*ptr != '\0') && (*ptr != ' ')) {
+               ptr++;
+            }
+            kerntokens.resize(kerntokens.size() + 1);
+            kerntokens.back().parse(start, (int)(ptr - start));
+         }
+      }
+   }
+   kernlineindex[lines] = (int)kernfieldindex.size();
+   kernfieldindex.push_back((int)kerntokens.size());
+   kerntokencheck = 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::kernTokensQ -- returns 1 if analyzeKernTokens() has
+//     been done and is still valid.
+//
+
+int HumdrumFile::kernTokensQ(void) {
+   return kerntokencheck;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getKernTokenCount -- returns the number of parsed 
+//     subtokens for the given field.  Returns 0 if the field is not
+//     **kern data or if analyzeKernTokens() has not been done.
+//
+
+int HumdrumFile::getKernTokenCount(int line, int field) {
+   if (!kerntokencheck || (line < 0) || (line >= getNumLines())) {
+      return 0;
+   }
+   int index = kernlineindex[line] + field;
+   if ((field < 0) || (index >= kernlineindex[line+1])) {
+      return 0;
+   }
+   return kernfieldindex[index+1] - kernfieldindex[index];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getKernFieldFlags -- returns the KT_* flags of all 
+//     parsed subtokens in a field combined together.
+//
+
+int HumdrumFile::getKernFieldFlags(int line, int field) {
+   int count = getKernTokenCount(line, field);
+   if (count == 0) {
+      return 0;
+   }
+   int start = kernfieldindex[kernlineindex[line]+field];
+   int output = 0;
+   for (int i=0; i<count; i++) {
+      output |= kerntokens[start+i].getFlags();
+   }
+   return output;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getKernToken -- returns the parsed version of a **kern
+//     subtoken.  A null token is returned for non-**kern fields and
+//     invalid subtoken indexes.
+//     default value: subtoken = 0
+//
+
+const KernToken& HumdrumFile::getKernToken(int line, int field, 
+      int subtoken) {
+   static const KernToken nulltoken;
+   int count = getKernTokenCount(line, field);
+   if ((subtoken < 0) || (subtoken >= count)) {
+      return nulltoken;
+   }
+   return kerntokens[kernfieldindex[kernlineindex[line]+field] + subtoken];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::analyzeTies -- Link the notes of every tied group in
+//     **kern spines to the first note of the group, and store the
+//     total duration of the group in the first note, so that
+//     getTiedDurationR(), getTotalTiedDurationR() and 
+//     getTiedStartLocation() do not have to search the file.  Tied
+//     notes are matched by MIDI note number within the same primary
+//     track (so enharmonic ties and ties between notes of chords are
+//     allowed).  Calls analyzeKernTokens() if it has not been done.
+//     The analysis is discarded with the kern token analysis.
+//
+
+void HumdrumFile::analyzeTies(void) {
+   HumdrumFile& infile = *this;
+   if (!kerntokencheck) {
+      analyzeKernTokens();
+   }
+
+   int size = (int)kerntokens.size();
+   tieline.assign(size, -1);
+   tiefield.assign(size, -1);
+   tietoken.assign(size, -1);
+   tieduration.resize(size);
+
+   // ties which have started but not yet ended:
+   vector<int> openindex;     // kerntokens index of first note in group
+   vector<int> opentrack;     // primary track of group
+   vector<int> openpitch;     // MIDI note number of group
+   vector<int> openfield;     // field of the last note in group
+
+   int i, j, k, m;
+   int ptrack;
+   int index;
+   int count;
+   int found;
+   int start;
+   for (i=0; i<infile.getNumLines(); i++) {
+      if (!infile[i].isData()) {
+         continue;
+      }
+      for (j=0; j<infile[i].getFieldCount(); j++) {
+         count = getKernTokenCount(i, j);
+         if (count == 0) {
+            continue;
+         }
+         ptrack = infile[i].getPrimaryTrack(j);
+         index = kernfieldindex[kernlineindex[i]+j];
+         for (k=0; k<count; k++, index++) {
+            const KernToken& note = kerntokens[index];
+            tieduration[index] = note.getDurationR();
+
+            if (note.isTieStart() || !note.isTied()) {
+               tieline[index]  = i;
+               tiefield[index] = j;
+               tietoken[index] = k;
+            }
+            if (note.isTieStart()) {
+               // replace any unterminated tie on the same pitch
+               for (m=0; m<(int)openindex.size(); m++) {
+                  if ((opentrack[m] == ptrack) && 
+                        (openpitch[m] == note.getMidiNoteNumber())) {
+                     break;
+                  }
+               }
+               if (m == (int)openindex.size()) {
+                  openindex.push_back(index);
+                  opentrack.push_back(ptrack);
+                  openpitch.push_back(note.getMidiNoteNumber());
+                  openfield.push_back(j);
+               } else {
+                  openindex[m] = index;
+                  openfield[m] = j;
+               }
+               continue;
+            }
+            if (!note.isTied()) {
+               continue;
+            }
+
+            // tie continuation or ending: find the matching open tie,
+            // preferring one which was continued in the same field.
+            found = -1;
+            for (m=0; m<(int)openindex.size(); m++) {
+               if ((opentrack[m] != ptrack) || 
+                     (openpitch[m] != note.getMidiNoteNumber())) {
+                  continue;
+               }
+               if ((found < 0) || (openfield[m] == j)) {
+                  found = m;
+               }
+            }
+            if (found < 0) {
+               // no start to the tie: leave the location at -1
+               continue;
+            }
+            start = openindex[found];
+            tieline[index]  = tieline[start];
+            tiefield[index] = tiefield[start];
+            tietoken[index] = tietoken[start];
+            tieduration[start] += note.getDurationR();
+            if (note.isTieContinue()) {
+               openfield[found] = j;
+            } else {
+               openindex.erase(openindex.begin() + found);
+               opentrack.erase(opentrack.begin() + found);
+               openpitch.erase(openpitch.begin() + found);
+               openfield.erase(openfield.begin() + found);
+            }
+         }
+      }
+   }
+
+   tiecheck = 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::tiesQ -- returns 1 if analyzeTies() has been done and
+//     is still valid.
+//
+
+int HumdrumFile::tiesQ(void) {
+   return tiecheck;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFile::privateRhythmAnalysis --
@@ -2630,6 +3539,10 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
    // for analyzing record durations:
    SigCollection<RationalNumber> lastdurations;
    SigCollection<RationalNumber> runningstatus;
+   vector<long long> lastticks;    // integer versions of lastdurations
+   vector<long long> runningticks; // integer versions of runningstatus
+   long long tpq = 1;              // ticks per quarter note
+   vector<RationalNumber> rhythmsseen;
 
    // int fixedTimebase = 0;
    RationalNumber timebase = 4;
@@ -2690,6 +3603,8 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
             if (!foundstart && infile[i].hasExclusiveQ()) {
                foundstart = 1;
                initializeTracers(lastdurations, runningstatus, infile[i]);
+               durationsToTicks(lastticks, lastdurations, tpq);
+               durationsToTicks(runningticks, runningstatus, tpq);
             } else {
                // check for time signature
                PerlRegularExpression pre;
@@ -2719,6 +3634,8 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
                */
    
             }
+            ticksToDurations(lastdurations, lastticks, tpq);
+            ticksToDurations(runningstatus, runningticks, tpq);
             for (ii=0; ii<infile[i].getFieldCount(); ii++) {
                if (strcmp(infile[i][ii], "*free") == 0) {
                   adjustForRhythmMarker(infile[i], 1, ii, lastdurations, 
@@ -2732,6 +3649,8 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
                adjustForSpinePaths(infile[i], lastdurations, runningstatus, 
                      init, datainit, ignore);
             }
+            durationsToTicks(lastticks, lastdurations, tpq);
+            durationsToTicks(runningticks, runningstatus, tpq);
             //if (datainit == 0) {
             //   infile[i].setBeatR(0,1);
             //   if (debug) {
@@ -2788,8 +3707,13 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
 
 //            duration = (determineDurationR(infile[i], init,
 //               lastdurations, runningstatus, rhythms, ignore) * timebase) / 4;
-            duration = (determineDurationR2(infile[i], init,
-               lastdurations, runningstatus, rhythmsR, ignore) * timebase) / 4;
+//            duration = (determineDurationR2(infile[i], init,
+//               lastdurations, runningstatus, rhythmsR, ignore) * timebase) / 4;
+            duration = determineDurationTicks(infile[i], init, lastticks,
+               runningticks, tpq, rhythmsR, rhythmsseen, ignore);
+            if (timebase != 4) {
+               duration = (duration * timebase) / 4;
+            }
 
             infile[i].setDurationR(duration);
             if (datainit && i+1 < infile.getNumLines()) {
@@ -3711,6 +4635,275 @@ RationalNumber HumdrumFile::determineDurationR2(HumdrumRecord& aRecord,
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::determineDurationTicks -- Integer version of 
+//     determineDurationR2().  The running state of each rhythmic spine
+//     is kept as a count of ticks, with tpq ticks per quarter note.
+//     When a duration cannot be expressed in the current ticks, tpq is
+//     increased to the least common multiple of tpq and the duration's
+//     denominator, and the stored ticks are scaled to match.  Only the
+//     duration of the line is converted back into a RationalNumber.
+//     Durations which have already been added to the rhythms array
+//     are stored in rhythmsseen so that they are only checked once.
+//     Tick calculations use the overflow checks of RationalNumber.
+//
+
+RationalNumber HumdrumFile::determineDurationTicks(HumdrumRecord& aRecord,
+      int& init, vector<long long>& lastticks, vector<long long>& runticks,
+      long long& tpq, Array<RationalNumber>& rhythms, 
+      vector<RationalNumber>& rhythmsseen, Array<int>& ignore) {
+   int i;
+   // initialization:
+   if (init) {
+      init = 0;
+      int size = aRecord.getFieldCount("**kern");
+      size += aRecord.getFieldCount("**recip");
+      size += aRecord.getFieldCount("**koto");
+      lastticks.assign(size, 0);
+      runticks.assign(size, 0);
+   }
+
+   // Step (1): if lastticks == runticks, then zero running status.
+   for (i=0; i<(int)runticks.size(); i++) {
+      if (runticks[i] == lastticks[i]) {
+         runticks[i] = 0;
+      }
+   }
+ 
+   // Step (2): input new durations into the lastticks array
+   int q, z;
+   int count = 0;
+   int stype = 0;
+   int seenQ;
+   RationalNumber duration;
+   long long den;
+   long long factor;
+   for (i=0; i<aRecord.getFieldCount(); i++) {
+      if (ignore[aRecord.getPrimaryTrack(i)-1] != 0) {
+         stype = 0;
+      } else if (aRecord.getExInterpNum(i) == E_KERN_EXINT) {
+         stype = 1;
+      } else if (strcmp(aRecord.getExInterp(i), "**koto") == 0) {
+         stype = 2;
+      } else if (strcmp(aRecord.getExInterp(i), "**recip") == 0) {
+         stype = 1; // **recip is same rhythm as **kern
+      } else {
+         stype = 0;
+      }
+      if (!stype) {
+         continue;
+      }
+      if (strcmp(aRecord[i], ".") == 0) {
+         count++;
+         continue;
+      }
+
+      switch (stype) {
+         case 1:
+            duration = Convert::kernToDurationR(aRecord[i]);
+            if (strchr(aRecord[i], 'P') != NULL) {
+               // remove appogiatura durations for summations
+               // duration = 0;
+            } else if ((strchr(aRecord[i], 'q') != NULL) ||
+                       (strchr(aRecord[i], 'Q') != NULL)) {
+               // remove gracenote durations from summations
+               duration = 0;
+            } 
+            break;
+         case 2:
+            duration = Convert::kotoToDurationR(aRecord[i]);
+            if ((strchr(aRecord[i], 'q') != NULL) ||
+                (strchr(aRecord[i], 'Q') != NULL)) {
+               // remove gracenote durations from summations
+               duration = 0;
+            } 
+            break;
+      }
+
+      if (duration != 0) {
+         // have a legitimate rhythm, store it in the rhythms array
+         // if it has not been seen before.
+         seenQ = 0;
+         for (z=0; z<(int)rhythmsseen.size(); z++) {
+            if (rhythmsseen[z] == duration) {
+               seenQ = 1;
+               break;
+            }
+         }
+         if (!seenQ) {
+            rhythmsseen.push_back(duration);
+            RationalNumber rbase = duration.getInversion() * 4;
+            int done = 0;
+            RationalNumber value;
+            for (z=0; z<rhythms.getSize(); z++) {
+               value = rhythms[z] / rbase;
+               if (value.getDenominator() == 1) {
+                  // if the duration of rbase is an integer
+                  // multiple of a particular rhythm, then stop
+                  // processing, since the minimum rhythm calculation
+                  // will not need to know anything about rbase.
+                  done = 1;
+                  break;
+               }
+            }
+            if (!done) {
+               rhythms.append(rbase);
+            }
+         }
+
+         // rescale the ticks if the duration does not fit into them.
+         den = duration.getDenominator();
+         if (tpq % den != 0) {
+            factor = den / gcdTicks(tpq, den);
+            tpq = RationalNumber::multiply(tpq, factor);
+            for (z=0; z<(int)lastticks.size(); z++) {
+               lastticks[z] = RationalNumber::multiply(lastticks[z], factor);
+               runticks[z]  = RationalNumber::multiply(runticks[z], factor);
+            }
+         }
+      }
+      lastticks[count] = RationalNumber::multiply(duration.getNumerator(), 
+            tpq / duration.getDenominator());
+
+      if (strstr(aRecord[i], "--") != NULL && runticks[count] != 0) {
+         cout << "Error in rhythm on line: " << aRecord.getLineNum()
+              << endl;
+
+         cout << "Error on line: " << aRecord.getLineNum() 
+              << ": problem with rhythm in spine " << i+1 << endl;
+
+         cout << "\n\t" << aRecord.getLine() << endl;
+         cout << "D";
+         for (q=0; q<(int)lastticks.size(); q++) {
+            cout << "\t" << ticksToRational(lastticks[q], tpq); 
+         }
+         cout << endl;
+         cout << "RT";
+         for (q=0; q<(int)runticks.size(); q++) {
+            cout << "\t" << ticksToRational(runticks[q], tpq); 
+         }
+         cout << endl;
+         exit(1);
+      }
+      count++;
+   }
+   if (count != (int)runticks.size()) {
+      cerr << "Error: spine count has changed" << endl;
+   }
+
+   if (lastticks.size() == 0) {
+      return RationalNumber(99999999,1);
+   }
+
+   // Step (3): find minimum duration by subtracting last from running
+   long long min = lastticks[0] - runticks[0];
+   long long testval;
+   for (i=0; i<(int)lastticks.size(); i++) {
+      testval = lastticks[i] - runticks[i];
+      if (testval < 0) {   
+         cout << "Error on line: " << aRecord.getLineNum() 
+              << ": problem with rhythm in **kern spine " 
+              << i+1 << endl;
+         cout << "Line min duration is measured to be: " 
+              << ticksToRational(testval, tpq) << endl;
+  
+         cout << "Durations on this line: " << endl;
+         for (q=0; q<(int)lastticks.size(); q++) {
+            cout << "\t" << ticksToRational(lastticks[q], tpq); 
+         }
+         cout << endl;
+         cout << "Running total of durations from previous rhythm: " << endl;
+         for (q=0; q<(int)runticks.size(); q++) {
+            cout << "\t" << ticksToRational(runticks[q], tpq); 
+         }
+         cout << endl;
+         cout << "Line of data that failed:\n";
+         cout << aRecord << endl;
+  
+         exit(1);
+      }
+      if (testval < min) {
+         min = testval;
+      }
+   }
+
+   // Step (4): add the duration to the running values and to meter position
+   for (i=0; i<(int)runticks.size(); i++) {
+      runticks[i] = RationalNumber::add(runticks[i], min);
+   }
+
+   return ticksToRational(min, tpq);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::ticksToRational -- Convert a tick count into a duration 
+//     in quarter notes.
+//
+
+RationalNumber HumdrumFile::ticksToRational(long long ticks, long long tpq) {
+   long long divisor = gcdTicks(ticks < 0 ? -ticks : ticks, tpq);
+   if (divisor == 0) {
+      return RationalNumber(0,1);
+   }
+   return RationalNumber(ticks / divisor, tpq / divisor);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::ticksToDurations -- Copy tick counts into an array of 
+//     durations so that they can be adjusted for spine path changes.
+//
+
+void HumdrumFile::ticksToDurations(SigCollection<RationalNumber>& durations,
+      vector<long long>& ticks, long long tpq) {
+   durations.setSize((int)ticks.size());
+   for (int i=0; i<(int)ticks.size(); i++) {
+      durations[i] = ticksToRational(ticks[i], tpq);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::durationsToTicks -- Inverse of ticksToDurations().
+//
+
+void HumdrumFile::durationsToTicks(vector<long long>& ticks, 
+      SigCollection<RationalNumber>& durations, long long tpq) {
+   ticks.resize(durations.getSize());
+   for (int i=0; i<durations.getSize(); i++) {
+      ticks[i] = RationalNumber::multiply(durations[i].getNumerator(), 
+            tpq / durations[i].getDenominator());
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::gcdTicks -- Greatest common divisor of two non-negative
+//     tick values.
+//
+
+long long HumdrumFile::gcdTicks(long long a, long long b) {
+   long long z;
+   while (b != 0) {
+      z = a % b;
+      a = b;
+      b = z;
+   }
+   return a;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFile::determineDurationR -- determines the duration of the **kern
@@ -3750,7 +4943,7 @@ RationalNumber HumdrumFile::determineDurationR(HumdrumRecord& aRecord,
    int q;
    int count = 0;
    int stype = 0;
-   static char rbuff[32] = {0};
+   char rbuff[32] = {0};
    for (i=0; i<aRecord.getFieldCount(); i++) {
       if (ignore[aRecord.getPrimaryTrack(i)-1] != 0) {
          stype = 0;
@@ -3948,121 +5141,237 @@ void HumdrumFile::analyzeDataIndex(Array<int>& indices, int segment) {
 //////////////////////////////
 //
 // HumdrumFile::analyzeCliche -- returns the count of cliches found
-//    in the score.
+//    in the score.  A cliche is a sequence of data lines lasting at
+//    least duration beats which is repeated (with the same line
+//    durations and the same sorted set of pitches on each line) at
+//    least minimumcount more times in the score.  The first data line
+//    of the first occurrence of cliche n is marked with -n in the
+//    output array, and the first data line of each repetition is marked
+//    with n.  Cliches are numbered in order of their first occurrence.
+//    Every starting position is tested, so occurrences of a cliche can
+//    overlap (a pattern repeated three times in a row is also found
+//    starting on its second line), and a line starts at most one
+//    cliche, since the cliche starting there is fixed by its duration.
+//    Starting positions are grouped by a rolling hash of the line
+//    sequences, so the analysis runs in linear time rather than comparing
+//    all pairs of lines.  Requires that analyzeRhythm() has been called.
 //     Default values: start = -1, stop = -1;
 //
 
 int HumdrumFile::analyzeCliche(Array<int>& cliche, double duration, 
       int minimumcount, double start, double stop) {
+   map<string, int> dictionary;
+   Array<Array<int> > cliches(1);
+   Array<Array<int> > lines(1);
+   Array<Array<int> > symbols(1);
+   Array<Array<int> > spans(1);
+
+   getClicheSequence(lines[0], symbols[0], spans[0], dictionary, duration,
+         start, stop);
+   cliches[0].setSize(getNumLines());
+   int count = markCliches(cliches, lines, symbols, spans, minimumcount);
+   cliche = cliches[0];
+   return count;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getClicheSequence -- Convert the data lines of the score
+//    into a list of symbols for cliche analysis.  Each distinct
+//    combination of line duration and sorted pitch set is given a symbol
+//    number from the dictionary, which can be shared between files.
+//    lines contains the line index of each symbol, and spans contains the
+//    number of symbols from each position which are needed to fill the
+//    cliche duration (or 0 if the end of the range is reached before
+//    that).  Only lines which start at or after start and before stop
+//    are considered.
+//     Default values: start = -1, stop = -1;
+//
+
+void HumdrumFile::getClicheSequence(Array<int>& lines, Array<int>& symbols,
+      Array<int>& spans, map<string, int>& dictionary, double duration, 
+      double start, double stop) {
    HumdrumFile& score = *this;
    int  nlflag = NL_SORT | NL_UNIQ;
    // later flags to add: NL_PC; NL_FILL;
 
-   cliche.setSize(score.getNumLines());
-   cliche.zero();
-
    Array<int> di;  // data index list for score data lines
    score.analyzeDataIndex(di);
 
-   Array<Array<int> > pitchset;
    int starti = 0;
-// cout << "di get size = " << di.getSize() << endl;
-
    if (start > 0) {
-      while (score[di[starti]].getAbsBeat() < start && starti < di.getSize()) {
+      while (starti < di.getSize() && score[di[starti]].getAbsBeat() < start) {
          starti++;
       }
    }
-
-   int endi = di.getSize() - 1;
+   int endi = di.getSize();
    if (stop > 0) {
-      while (score[di[endi]].getAbsBeat() < stop && endi > 1) {
+      while (endi > starti && score[di[endi-1]].getAbsBeat() >= stop) {
          endi--;
       }
    }
 
+   int size = endi - starti;
+   lines.setSize(size);
+   symbols.setSize(size);
+   spans.setSize(size);
+   if (size <= 0) {
+      return;
+   }
+
+   Array<int> notes;
+   Array<RationalNumber> sums(size+1);
+   map<string, int>::iterator entry;
+   RationalNumber linedur;
+   string key;
    int i, j;
-   Array<Array<int> > allnotes;
-   allnotes.setSize(endi-starti+1);
-   for (i=0; i<endi-starti+1; i++) {
-      score.getNoteList(allnotes[i], di[i], nlflag);
+
+   sums[0] = 0;
+   for (i=0; i<size; i++) {
+      lines[i] = di[starti+i];
+      linedur = score[lines[i]].getDurationR();
+      sums[i+1] = sums[i] + linedur;
+      score.getNoteList(notes, lines[i], nlflag);
+      key = to_string(linedur.getNumerator());
+      key += '/';
+      key += to_string(linedur.getDenominator());
+      for (j=0; j<notes.getSize(); j++) {
+         key += ' ';
+         key += to_string(notes[j]);
+      }
+      entry = dictionary.find(key);
+      if (entry == dictionary.end()) {
+         symbols[i] = (int)dictionary.size();
+         dictionary[key] = symbols[i];
+      } else {
+         symbols[i] = entry->second;
+      }
    }
 
-   int match = 0;
-   int found = 0;
-   int count = 0;
-   int tcount = 0;
-   for (i=starti; i<endi; i++) {
-      if (cliche[di[i]] != 0) {
-         continue;
+   // The end of the cliche only moves forward as the starting
+   // position advances, since line durations are not negative.
+   int end = 0;
+   for (i=0; i<size; i++) {
+      if (end <= i) {
+         end = i + 1;
       }
-      found = 0;
-      match = 0;
-      tcount = 0;
-      for (j=i+1; j<=endi; j++) {
-// cout << "Matching line " << di[i] << " to " << di[j] << " : "
-//      << score[di[i]][0] << " \t" << score[di[j]][0] << endl;
-         match = attemptMatch(allnotes, di, starti, i, j, duration);
-         if (match && !found) {
-            count++;
-            cliche[di[i]] = -count;
-            found = 1;
-         }
-         if (match) {
-            cliche[di[j]] = count;
-            tcount++;
-         }
+      while (end < size && (sums[end] - sums[i]).getFloat() < duration) {
+         end++;
       }
-      if (tcount < minimumcount) {
-         for (j=i+1; j<=endi; j++) {
-            if (cliche[di[j]] == -cliche[di[i]]) {
-               cliche[di[j]] = 0;
-            }
-         }
-         cliche[di[i]] = 0;
-         count--;
+      if ((sums[end] - sums[i]).getFloat() < duration) {
+         spans[i] = 0;
+      } else {
+         spans[i] = end - i;
       }
    }
-
-   return count;
 }
 
 
 
 //////////////////////////////
 //
-// private: HumdrumFile::attemptMatch -- for use with analyzeCliche
-//
-
-int HumdrumFile::attemptMatch(Array<Array<int> >& allnotes, Array<int>& di, 
-      int starti, int i, int j, double duration) {
-   HumdrumFile& score = *this;
-
-   double sumduration = 0.0;
+// HumdrumFile::markCliches -- Group the starting positions of the
+//    symbol sequences created by getClicheSequence() (for one or more
+//    files) which have identical spans, and mark the groups which occur at
+//    least minimumcount+1 times in the cliche arrays (which should be sized
+//    to the line count of each file).  Returns the number of cliches.
+//    Candidate groups are found with a polynomial rolling hash of the
+//    symbols, and then verified by comparing the symbols.
+//
+
+int HumdrumFile::markCliches(Array<Array<int> >& cliche, 
+      Array<Array<int> >& lines, Array<Array<int> >& symbols, 
+      Array<Array<int> >& spans, int minimumcount) {
+   typedef unsigned long long ULL;
+   const ULL base = 1000003ULL;
+   int f, i, k;
+
+   // Groups are stored in order of their first occurrence.
+   vector<int> groupfile;
+   vector<int> groupstart;
+   vector<int> groupcount;
+   Array<Array<int> > membership(symbols.getSize());
+   unordered_map<ULL, vector<int> > table;
+
+   vector<ULL> prefix;
+   vector<ULL> powers(1, 1);
+   ULL hash;
+   int span, g, gf, gs;
+   for (f=0; f<symbols.getSize(); f++) {
+      cliche[f].zero();
+      membership[f].setSize(symbols[f].getSize());
+      membership[f].setAll(-1);
+      prefix.resize(symbols[f].getSize() + 1);
+      prefix[0] = 0;
+      for (i=0; i<symbols[f].getSize(); i++) {
+         prefix[i+1] = prefix[i] * base + (ULL)symbols[f][i] + 1;
+      }
+      while (powers.size() < prefix.size()) {
+         powers.push_back(powers.back() * base);
+      }
 
-   int delta = 0;
-   int k;
-   while (sumduration < duration) {
-      if (score[di[i+delta]].getDuration() != 
-            score[di[j+delta]].getDuration()) {
-         return 0;
-      } else {
-         sumduration += duration;
+      for (i=0; i<symbols[f].getSize(); i++) {
+         span = spans[f][i];
+         if (span <= 0) {
+            continue;
+         }
+         hash = prefix[i+span] - prefix[i] * powers[span];
+         hash ^= (ULL)span * 0x9E3779B97F4A7C15ULL;
+         vector<int>& candidates = table[hash];
+         g = -1;
+         for (k=0; k<(int)candidates.size(); k++) {
+            gf = groupfile[candidates[k]];
+            gs = groupstart[candidates[k]];
+            if (spans[gf][gs] != span) {
+               continue;
+            }
+            if (memcmp(symbols[gf].getBase() + gs, symbols[f].getBase() + i,
+                  span * sizeof(int)) == 0) {
+               g = candidates[k];
+               break;
+            }
+         }
+         if (g < 0) {
+            g = (int)groupstart.size();
+            groupfile.push_back(f);
+            groupstart.push_back(i);
+            groupcount.push_back(0);
+            candidates.push_back(g);
+         }
+         groupcount[g]++;
+         membership[f][i] = g;
       }
-      
-      if (allnotes[i+delta].getSize() != allnotes[j+delta].getSize()) {
-         return 0;
+   }
+
+   // number the groups which are repeated often enough
+   if (minimumcount < 1) {
+      minimumcount = 1;
+   }
+   vector<int> number(groupstart.size(), 0);
+   int count = 0;
+   for (g=0; g<(int)groupstart.size(); g++) {
+      if (groupcount[g] - 1 >= minimumcount) {
+         number[g] = ++count;
       }
+   }
 
-      for (k=0; k<allnotes[i+delta].getSize(); k++) {
-         if (allnotes[i+delta][k] != allnotes[j+delta][k]) {
-            return 0;
+   for (f=0; f<symbols.getSize(); f++) {
+      for (i=0; i<membership[f].getSize(); i++) {
+         g = membership[f][i];
+         if ((g < 0) || (number[g] == 0)) {
+            continue;
+         }
+         if ((groupfile[g] == f) && (groupstart[g] == i)) {
+            cliche[f][lines[f][i]] = -number[g];
+         } else {
+            cliche[f][lines[f][i]] = number[g];
          }
       }
-      delta++;
    }
-   
-   return 1;
+
+   return count;
 }
 
 
@@ -18,6 +18,9 @@
 // Last Modified: Tue Apr 24 16:37:34 PDT 2012 added jrp:// URI
 // Last Modified: Tue Dec 11 17:23:04 PST 2012 added fileName, segmentLevel
 // Last Modified: Mon Apr  1 16:44:32 PDT 2013 added printNonemptySegmentLevel
+// Last Modified: Sun Oct 18 09:12:40 PDT 2026 added arena line storage
+// Last Modified: Sun Oct 18 10:02:17 PDT 2026 added memory-mapped reading
+// Last Modified: Sun Oct 18 23:06:45 PDT 2026 direct reading of PDF data
 // Filename:      ...sig/src/sigInfo/HumdrumFileBasic.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFileBasic.cpp
 // Syntax:        C++ 
@@ -31,6 +34,7 @@
 #include "HumdrumFileBasic.h"
 #include "PDFFile.h"
 #include "CheckSum.h"
+#include "MappedFile.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -203,6 +207,8 @@ HumdrumFileBasic::HumdrumFileBasic(void) {
    records.setGrowth(1000000);      // grow in increments of 1000000 lines
    maxtracks = 0;
    segmentLevel = 0;
+   arenaQ = 1;
+   arenas.allowGrowth();
 }
 
 
@@ -213,6 +219,8 @@ HumdrumFileBasic::HumdrumFileBasic(const HumdrumFileBasic& aHumdrumFileBasic) {
    records.setGrowth(1000000);      // grow in increments of 1000000 lines
    maxtracks = 0;
    segmentLevel = 0;
+   arenaQ = 1;
+   arenas.allowGrowth();
 
    *this = aHumdrumFileBasic;
 }
@@ -225,6 +233,8 @@ HumdrumFileBasic::HumdrumFileBasic(const char* filename) {
    records.setAllocSize(1000000);    // grow in increments of 1000000 lines
    maxtracks = 0;
    segmentLevel = 0;
+   arenaQ = 1;
+   arenas.allowGrowth();
 
    ifstream infile(filename, ios::in);
 
@@ -258,6 +268,8 @@ HumdrumFileBasic::HumdrumFileBasic(const string& filename) {
    records.setAllocSize(1000000);    // grow in increments of 1000000 lines
    maxtracks = 0;
    segmentLevel = 0;
+   arenaQ = 1;
+   arenas.allowGrowth();
 
    ifstream infile(filename.data(), ios::in);
 
@@ -284,6 +296,32 @@ HumdrumFileBasic::HumdrumFileBasic(const string& filename) {
 
 
 
+////////////////////////////////////////
+//
+// HumdrumFileBasic::setArenaMode -- Store the text of lines read
+//     with read() in a single block of memory owned by the file
+//     rather than allocating each line and field of each record
+//     separately.  On by default.
+//     default value: state = 1
+//
+
+void HumdrumFileBasic::setArenaMode(int state) {
+   arenaQ = state ? 1 : 0;
+}
+
+
+
+////////////////////////////////////////
+//
+// HumdrumFileBasic::getArenaMode -- Returns true if reading into arenas.
+//
+
+int HumdrumFileBasic::getArenaMode(void) {
+   return arenaQ;
+}
+
+
+
 ////////////////////////////////////////
 //
 // HumdrumFileBasic::setAllocation -- set the expected number of 
@@ -381,6 +419,7 @@ void HumdrumFileBasic::clear(void) {
       }
    }
    records.setSize(0);
+   clearArenas();
    maxtracks = 0;
    segmentLevel = 0;
    trackexinterp.clear();
@@ -388,6 +427,67 @@ void HumdrumFileBasic::clear(void) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBasic::clearArenas -- delete the line text storage for
+//     records read in arena mode.  The records which use the text
+//     must be deleted before calling this function.
+//
+
+void HumdrumFileBasic::clearArenas(void) {
+   int i;
+   for (i=0; i<arenas.getSize(); i++) {
+      delete [] arenas[i];
+      arenas[i] = NULL;
+   }
+   arenas.setSize(0);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::appendArenaText -- split a block of text into
+//     lines and append them as records which point into a single
+//     arena rather than copying each line and field separately.
+//     Each line of n characters uses 2n+2 characters of the arena:
+//     the first half stores the line and the second half stores
+//     the fields of the line.  A final empty line (after the last
+//     newline) is not stored.
+//
+
+void HumdrumFileBasic::appendArenaText(const char* text, int length) {
+   if (length <= 0) {
+      return;
+   }
+   char* arena = new char[2 * length + 2];
+   arenas.append(arena);
+   char* line = arena;
+   HumdrumRecord* aRecord;
+   const char* newline;
+   int linelength;
+   int start = 0;
+   int stop;
+   while (start <= length) {
+      newline = (const char*)memchr(text + start, '\n', length - start);
+      stop = (newline == NULL) ? length : (int)(newline - text);
+      // treat lines as C strings, ignoring any text after a null
+      linelength = (int)strnlen(text + start, stop - start);
+      if ((newline == NULL) && (linelength == 0)) {
+         break;
+      }
+      memcpy(line, text + start, linelength);
+      line[linelength] = '\0';
+      aRecord = new HumdrumRecord;
+      aRecord->setArenaLine(line, linelength);
+      records[records.getSize()] = aRecord;
+      line += 2 * linelength + 2;
+      start = stop + 1;
+   }
+}
+
+
+
 //////////////////////////////
 //
 // changeField -- Change the contents of a token in the Humdrum file.
@@ -786,6 +886,7 @@ HumdrumFileBasic& HumdrumFileBasic::operator=(const HumdrumFileBasic& aFile) {
       delete records[i];
       records[i] = NULL;
    }
+   clearArenas();
 
    records.setSize(aFile.records.getSize());
    for (i=0; i<aFile.records.getSize(); i++) {
@@ -847,6 +948,19 @@ void HumdrumFileBasic::read(const char* filename) {
       records[i] = NULL;
    }
    records.setSize(0);
+   clearArenas();
+
+   // read directly from a memory-mapped view of the file if possible.
+   // PDF files and non-regular files (such as pipes) are read through
+   // an ifstream instead.
+   MappedFile mapped;
+   if (mapped.open(filename) && ((mapped.getSize() == 0) || 
+         (mapped.getData()[0] != '%'))) {
+      setFilename(filename);
+      readMemory(mapped.getData(), (int)mapped.getSize());
+      return;
+   }
+   mapped.close();
 
    #ifndef OLDCPP
       ifstream infile(filename, ios::in);
@@ -860,14 +974,20 @@ void HumdrumFileBasic::read(const char* filename) {
    }
 
    if (infile.peek() == '%') {
-      stringstream embeddedData;
-      extractEmbeddedDataFromPdf(embeddedData, infile);
-      read(embeddedData);
+      readEmbeddedPdf(infile);
       return;
    }
 
 	setFilename(filename);
 
+   if (arenaQ) {
+      stringstream contents;
+      contents << infile.rdbuf();
+      string text = contents.str();
+      readMemory(text.c_str(), (int)text.size());
+      return;
+   }
+
    char templine[4096];
    while (!infile.eof()) {
       infile.getline(templine, 4096, '\n');
@@ -884,42 +1004,32 @@ void HumdrumFileBasic::read(const char* filename) {
 
 void HumdrumFileBasic::read(istream& inStream) {
    char* templine;
-   templine = new char[4096];
    int linecount = 0;
 
    if (inStream.peek() == '%') {
-      stringstream embeddedData;
-      extractEmbeddedDataFromPdf(embeddedData, inStream);
-      read(embeddedData);
+      readEmbeddedPdf(inStream);
       return;
    }
 
+   if (arenaQ) {
+      stringstream contents;
+      contents << inStream.rdbuf();
+      string text = contents.str();
+      string::size_type firstline = text.find('\n');
+      if (readFromUriLine(text.substr(0, firstline).c_str())) {
+         return;
+      }
+      readMemory(text.c_str(), (int)text.size());
+      return;
+   }
+
+   templine = new char[4096];
    while (!inStream.eof()) {
       inStream.getline(templine, 4096);
-#ifdef USING_URI
-      if ((linecount++ == 0) && (strstr(templine, "://") != NULL)) {
-         if (strncmp(templine, "http://", strlen("http://")) == 0) {
-            readFromHttpURI(templine);
-            delete [] templine;
-            return;
-         }
-         if (strncmp(templine, "humdrum://", strlen("humdrum://")) == 0) {
-            readFromHumdrumURI(templine);
-            delete [] templine;
-            return;
-         } 
-         if (strncmp(templine, "hum://", strlen("hum://")) == 0) {
-            readFromHumdrumURI(templine);
-            delete [] templine;
-            return;
-         } 
-         if (strncmp(templine, "h://", strlen("h://")) == 0) {
-            readFromHumdrumURI(templine);
-            delete [] templine;
-            return;
-         } 
+      if ((linecount++ == 0) && readFromUriLine(templine)) {
+         delete [] templine;
+         return;
       }
-#endif
       if (inStream.eof() && (strcmp(templine, "") == 0)) {
          break;
       } else {
@@ -933,6 +1043,72 @@ void HumdrumFileBasic::read(istream& inStream) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBasic::readMemory -- Append Humdrum data stored in a block
+//     of memory (which does not need to be null-terminated) and analyze
+//     the spines and null tokens.  Lines of any length are allowed.
+//
+
+void HumdrumFileBasic::readMemory(const char* text, int length) {
+   if (arenaQ) {
+      appendArenaText(text, length);
+   } else if (length > 0) {
+      string line;
+      const char* newline;
+      int start = 0;
+      int stop;
+      while (start <= length) {
+         newline = (const char*)memchr(text + start, '\n', length - start);
+         stop = (newline == NULL) ? length : (int)(newline - text);
+         line.assign(text + start, stop - start);
+         if ((newline == NULL) && (line.c_str()[0] == '\0')) {
+            break;
+         }
+         appendLine(line.c_str());
+         start = stop + 1;
+      }
+   }
+   analyzeSpines();
+   analyzeDots();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::readFromUriLine -- If the first line of an input
+//     stream is a Humdrum or web URI, then read the data from that
+//     location instead.  Returns true if the line was a URI.
+//
+
+int HumdrumFileBasic::readFromUriLine(const char* line) {
+#ifdef USING_URI
+   if (strstr(line, "://") == NULL) {
+      return 0;
+   }
+   if (strncmp(line, "http://", strlen("http://")) == 0) {
+      readFromHttpURI(line);
+      return 1;
+   }
+   if (strncmp(line, "humdrum://", strlen("humdrum://")) == 0) {
+      readFromHumdrumURI(line);
+      return 1;
+   } 
+   if (strncmp(line, "hum://", strlen("hum://")) == 0) {
+      readFromHumdrumURI(line);
+      return 1;
+   } 
+   if (strncmp(line, "h://", strlen("h://")) == 0) {
+      readFromHumdrumURI(line);
+      return 1;
+   } 
+#endif
+   return 0;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFileBasic::removeNullRecords
@@ -1682,19 +1858,65 @@ void HumdrumFileBasic::readjustDotArrays(Array<int>& lastline,
 
 void HumdrumFileBasic::extractEmbeddedDataFromPdf(ostream& outputData, 
       istream& inputData) {
+   Array<char> embeddedData;
+   extractEmbeddedDataFromPdf(embeddedData, inputData);
+   outputData.write(embeddedData.getBase(), embeddedData.getSize());
+}
+
+
+void HumdrumFileBasic::extractEmbeddedDataFromPdf(Array<char>& outputData, 
+      istream& inputData) {
+   outputData.setSize(0);
    PDFFile pdffile;
    pdffile.process(inputData);
    int filecount = pdffile.getEmbeddedFileCount();
+   Array<char> contents;
+   int size;
    int i;
    for (i=0; i<filecount; i++) {
       if (pdffile.isEmbeddedHumdrumFile(i)) {
-         pdffile.getEmbeddedFileContents(i, outputData);
+         pdffile.getEmbeddedFileContents(i, contents);
+         // don't copy the null character at the end of the contents:
+         size = outputData.getSize();
+         outputData.setSize(size + contents.getSize() - 1);
+         memcpy(outputData.getBase() + size, contents.getBase(), 
+               contents.getSize() - 1);
       }
    }
 }
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBasic::readEmbeddedPdf -- Read the Humdrum files embedded
+//    in a PDF file.  The embedded data is given directly to readMemory()
+//    rather than being copied into another stream and parsed again.
+//
+
+void HumdrumFileBasic::readEmbeddedPdf(istream& inStream) {
+   Array<char> embeddedData;
+   extractEmbeddedDataFromPdf(embeddedData, inStream);
+   const char* text = embeddedData.getBase();
+   int size = embeddedData.getSize();
+
+   if ((size > 0) && (text[0] == '%')) {
+      stringstream embedded;
+      embedded.write(text, size);
+      read(embedded);
+      return;
+   }
+
+   const char* newline = (const char*)memchr(text, '\n', size);
+   string firstline(text, newline == NULL ? size : (int)(newline - text));
+   if (readFromUriLine(firstline.c_str())) {
+      return;
+   }
+   readMemory(text, size);
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////
 //
 // Code for downloading data from the internet.
@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Fri Mar 29 15:14:19 PDT 2013
 // Last Modified: Fri Mar 29 15:14:24 PDT 2013
+// Last Modified: Sun Oct 18 10:02:17 PDT 2026 read segments from memory
+// Last Modified: Sun Oct 18 19:36:05 PDT 2026 added analyzeCliche()
 // Filename:      ...sig/src/sigInfo/HumdrumFileSet.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFileSet.cpp
 // Syntax:        C++ 
@@ -13,7 +15,10 @@
 //
 
 #include "HumdrumFileSet.h"
-#include "PerlRegularExpression.h"
+#include "MappedFile.h"
+
+#include <string.h>
+#include <cctype>
 
 #include <fstream>
 #include <iostream>
@@ -86,6 +91,35 @@ HumdrumFile& HumdrumFileSet::operator[](int index) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFileSet::analyzeCliche -- Search for cliches in all files of
+//     the set (see HumdrumFile::analyzeCliche()).  Cliches are numbered
+//     across the entire set, so a cliche which first occurs in one file
+//     is marked with the same number in all other files where it repeats.
+//     cliche[i] is sized to the line count of file i.  Requires that 
+//     analyzeRhythm() has been called on each file.  Returns the number 
+//     of cliches found.
+//
+
+int HumdrumFileSet::analyzeCliche(Array<Array<int> >& cliche, 
+      double duration, int minimumcount) {
+   map<string, int> dictionary;
+   Array<Array<int> > lines(getSize());
+   Array<Array<int> > symbols(getSize());
+   Array<Array<int> > spans(getSize());
+   cliche.setSize(getSize());
+   for (int i=0; i<getSize(); i++) {
+      data[i]->getClicheSequence(lines[i], symbols[i], spans[i], dictionary,
+            duration);
+      cliche[i].setSize(data[i]->getNumLines());
+   }
+   return HumdrumFile::markCliches(cliche, lines, symbols, spans, 
+         minimumcount);
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFileSet::read -- Returns the total number of segments
@@ -163,6 +197,16 @@ int HumdrumFileSet::readAppend(const char* filename) {
    } 
 #endif
 
+   // split a memory-mapped view of the file directly into segments
+   // unless it is a PDF or a non-regular file such as a pipe.
+   MappedFile mapped;
+   if (mapped.open(filename) && ((mapped.getSize() == 0) ||
+         (mapped.getData()[0] != '%'))) {
+      return readAppendMemory(mapped.getData(), (int)mapped.getSize(),
+            filename);
+   }
+   mapped.close();
+
    ifstream infile;
    #ifndef OLDCPP
       infile.open(filename, ios::in);
@@ -185,40 +229,71 @@ int HumdrumFileSet::readAppend(const char* filename) {
 }
 
 
-// !!!!SEGMENT: filename
+//////////////////////////////
+//
+// HumdrumFileSet::readAppend -- Read all of the input stream and split
+//     it into segments.
+//
 
 int HumdrumFileSet::readAppend(istream& inStream, const char* filename) {
-   PerlRegularExpression pre;
+   SSTREAM contents;
+   contents << inStream.rdbuf();
+   string text = contents.str();
+   return readAppendMemory(text.c_str(), (int)text.size(), filename);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileSet::readAppendMemory -- Split a block of text into
+//     HumdrumFile segments, which are either marked by lines in the
+//     form:
+//        !!!!SEGMENT: filename
+//     or start with a second exclusive interpretation line.  Each
+//     segment is parsed directly from the text without copying it
+//     into an intermediate buffer.  Returns the total number of segments.
+//
+
+int HumdrumFileSet::readAppendMemory(const char* text, int length,
+      const char* filename) {
    int contentQ   = 0;
    int exclusiveQ = 0;
-   char line[1123123] = {0};
-   SSTREAM* inbuffer;
-   char tfilename[123123] = {0};
+   string tfilename;
    if (strrchr(filename, '/') != NULL) {
       filename = strrchr(filename, '/') + 1;
    }
-   strcpy(tfilename, filename);
-   inbuffer = new SSTREAM;
-   while (!inStream.eof()) {
-      line[0] = '\0';
-      inStream.getline(line, 321321);
-      if (inStream.eof() && (strlen(line) == 0)) {
-         break;
-      }
-      if (strncmp(line, "**", 2) == 0) {
+   tfilename = filename;
+
+   const char* line;
+   const char* newline;
+   const char* segment = text;
+   int start = 0;
+   int stop;
+   int next;
+   int i;
+   while (start < length) {
+      line = text + start;
+      newline = (const char*)memchr(line, '\n', length - start);
+      stop = (newline == NULL) ? length : (int)(newline - text);
+      next = (newline == NULL) ? length : stop + 1;
+      if ((stop - start >= 2) && (strncmp(line, "**", 2) == 0)) {
          exclusiveQ++;
       }
-      if (pre.search(line, "^!!!!SEGMENT:\\s*(.*)\\s*$", "")) {
+      if ((stop - start >= 12) && (strncmp(line, "!!!!SEGMENT:", 12) == 0)) {
          if (contentQ != 0) {
-            if (strlen(tfilename) == 0) {
-               strcpy(tfilename, filename);
+            if (tfilename.empty()) {
+               tfilename = filename;
             }
-            appendHumdrumFileContent(tfilename, *inbuffer);
-            delete inbuffer;
-            inbuffer = new SSTREAM;
-            strcpy(tfilename, "");
+            appendHumdrumFileContent(tfilename.c_str(), segment, 
+                  (int)(line - segment));
+         }
+         i = start + 12;
+         while ((i < stop) && isspace(text[i])) {
+            i++;
          }
-         strcpy(tfilename, pre.getSubmatch(1));
+         tfilename.assign(text + i, stop - i);
+         segment = text + next;
          contentQ = 0;
          exclusiveQ = 0;
       } else if (exclusiveQ == 2) {
@@ -226,35 +301,33 @@ int HumdrumFileSet::readAppend(istream& inStream, const char* filename) {
          // HumdrumFile data structure, so split the data at this
          // point into a new HumdrumFile segement, assigning an
          // empty filename.
-         appendHumdrumFileContent("", *inbuffer);
-         delete inbuffer;
-         inbuffer = new SSTREAM;
+         appendHumdrumFileContent("", segment, (int)(line - segment));
+         segment = line;
          exclusiveQ = 1;
          contentQ = 1;
-         *inbuffer << line << "\n";
       } else {
          contentQ = 1;
-         *inbuffer << line << "\n";
       }
+      start = next;
    }
 
    if (contentQ) {
       // store last segment
-      appendHumdrumFileContent(filename, *inbuffer);
+      appendHumdrumFileContent(filename, segment, 
+            (int)(text + length - segment));
    }
 
-   delete inbuffer;
    return getSize();
 }
 
 
 void HumdrumFileSet::appendHumdrumFileContent(const char* filename, 
-      SSTREAM& inbuffer) {
+      const char* text, int length) {
    HumdrumFile* newfile;
    newfile = new HumdrumFile;
    HumdrumFile& infile = *newfile;
    infile.setFilename(filename);
-   infile.read(inbuffer);
+   infile.readMemory(text, length);
    data.append(newfile);
 }
 
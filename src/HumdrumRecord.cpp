@@ -22,6 +22,9 @@
 // Last Modified: Sun Dec 26 12:18:34 PST 2010 added setToken
 // Last Modified: Mon Jul 30 16:10:45 PDT 2012 added setSize and setAllFields
 // Last Modified: Mon Dec 10 10:14:08 PST 2012 added Array<char> getToken
+// Last Modified: Sun Oct 18 09:12:40 PDT 2026 added setArenaLine
+// Last Modified: Sun Oct 18 12:40:02 PDT 2026 interpretation tests w/o regex
+// Last Modified: Sun Oct 18 21:55:40 PDT 2026 size spineids to field count
 // Filename:      ...sig/src/sigInfo/HumdrumRecord.cpp
 // Webpage:       http://sig.sapp.org/src/sigInfo/HumdrumRecord.cpp
 // Syntax:        C++ 
@@ -31,6 +34,7 @@
 //
 
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <cctype>
@@ -40,6 +44,10 @@
 #include "PerlRegularExpression.h"
 #include <sstream>
 
+#ifdef VISUAL
+   #define strtok_r strtok_s
+#endif
+
 using namespace std;
 
 
@@ -62,6 +70,8 @@ HumdrumRecord::HumdrumRecord(void) {
    recordString[0] = '\0';
    modifiedQ = 0;
    lineno = -1;
+   arenaStart = NULL;
+   arenaEnd = NULL;
 
    recordFields.allowGrowth(1);
    recordFields.setSize(32);   
@@ -73,8 +83,6 @@ HumdrumRecord::HumdrumRecord(void) {
    interpretation.setGrowth(132);
    interpretation.setSize(0);
 
-   spineids.reserve(32);
-
    dotline.setSize(32);
    dotline.setGrowth(132);
    dotline.setSize(0);
@@ -99,6 +107,8 @@ HumdrumRecord::HumdrumRecord(const char* aLine, int aLineNum) {
    recordString = new char[1];
    recordString[0] = '\0';
    modifiedQ = 0;
+   arenaStart = NULL;
+   arenaEnd = NULL;
    interpretation.allowGrowth(1);
    interpretation.setSize(32);
    interpretation.setGrowth(132);
@@ -108,8 +118,6 @@ HumdrumRecord::HumdrumRecord(const char* aLine, int aLineNum) {
    recordFields.setGrowth(132);
    recordFields.setSize(0);
 
-   spineids.reserve(32);
-
    dotline.allowGrowth(1);
    dotline.setSize(0);
    dotline.setSize(32);
@@ -135,6 +143,8 @@ HumdrumRecord::HumdrumRecord(const HumdrumRecord& aRecord) {
    recordString = new char[strlen(aRecord.recordString)+1];
    strcpy(recordString, aRecord.recordString);
    modifiedQ = aRecord.modifiedQ;
+   arenaStart = NULL;
+   arenaEnd = NULL;
    interpretation.allowGrowth();
    interpretation.setSize(aRecord.interpretation.getSize());
    recordFields.allowGrowth();
@@ -162,18 +172,7 @@ HumdrumRecord::HumdrumRecord(const HumdrumRecord& aRecord) {
 //
 
 HumdrumRecord::~HumdrumRecord() {
-   if (recordString != NULL) {
-      delete [] recordString;
-      recordString = NULL;
-   }
-   int i;
-   for (i=0; i<recordFields.getSize(); i++) {
-      if (recordFields[i] != NULL) {
-         delete [] recordFields[i];
-         recordFields[i] = NULL;
-      }
-   }
-   recordFields.setSize(0);
+   releaseStrings();
 
    spineids.clear();
 
@@ -224,10 +223,7 @@ void HumdrumRecord::changeField(int aField, const char* aString) {
       return;
    }
 
-   if (recordFields[aField] != NULL) {
-      delete [] recordFields[aField];
-      recordFields[aField] = NULL;
-   }
+   releaseString(recordFields[aField]);
    recordFields[aField] = new char[strlen(aString) + 1];
    strcpy(recordFields[aField], aString);
    
@@ -810,8 +806,11 @@ double HumdrumRecord::getTrack(int spineNumber) {
       i++;
    }
    double output;
-   int inttrack;
-   sscanf(&info[i], "%d", &inttrack);
+   int inttrack = 0;
+   int j;
+   for (j=i; std::isdigit(info[j]); j++) {
+      inttrack = inttrack * 10 + (info[j] - '0');
+   }
    output = inttrack;
    i++;
    int subtrack = 0;
@@ -867,8 +866,9 @@ int HumdrumRecord::getPrimaryTrack(int spineNumber) {
       i++;
    }
    int track = 0;
-   if (!sscanf(&info[i], "%d", &track)) {
-      track = 0;
+   while (std::isdigit(info[i])) {
+      track = track * 10 + (info[i] - '0');
+      i++;
    }
    return track;
 }
@@ -914,7 +914,9 @@ void HumdrumRecord::changeToken(int spineIndex, int tokenIndex,
    char *buff;
    buff = new char[strlen(record[spineIndex]) + strlen(newtoken) + 1];
    buff[0] = '\0';
-   char* oldtoken = strtok((char*)record[spineIndex], separatorstr);
+   char* saveptr = NULL;
+   char* oldtoken = strtok_r((char*)record[spineIndex], separatorstr, 
+         &saveptr);
    int token = 0;
    while (oldtoken != NULL) {
       if (token == tokenIndex) {
@@ -924,13 +926,13 @@ void HumdrumRecord::changeToken(int spineIndex, int tokenIndex,
       }
 
       token++;
-      oldtoken = strtok(NULL, separatorstr);
+      oldtoken = strtok_r(NULL, separatorstr, &saveptr);
       if (oldtoken != NULL) {
          strcat(buff, separatorstr);
       }
    }
 
-   delete [] recordFields[spineIndex];
+   releaseString(recordFields[spineIndex]);
    recordFields[spineIndex] = buff;
    modifiedQ = 1;
 }
@@ -989,12 +991,13 @@ char* HumdrumRecord::getToken(char* buffer, int fieldIndex, int tokenIndex,
    int location = 0;
    const char* string = (*this)[fieldIndex];
    // char temp[strlen(string) + 1];  // can't do in MS Visual C++ 6.0
-   static char temp[1024] = {0};      // doing this instead
+   char temp[1024] = {0};             // doing this instead
    strcpy(temp, string);
    char *current = NULL;
-   current = strtok(temp, sepstring);
+   char *saveptr = NULL;
+   current = strtok_r(temp, sepstring, &saveptr);
    while (current != NULL && location < tokenIndex) {
-      current = strtok(NULL, sepstring);
+      current = strtok_r(NULL, sepstring, &saveptr);
       location++;
    }
 
@@ -1203,24 +1206,38 @@ int HumdrumRecord::isNullToken(int index) {
 //
 
 int HumdrumRecord::hasNoteAttack(int field) {
-   PerlRegularExpression pre;
-   Array<Array<char> > notes;
-   pre.getTokens(notes, " ", (*this)[field]);
-   int i;
-   for (i=0; i<notes.getSize(); i++) {
-      if (strcmp(notes[i].getBase(), ".") == 0) {
+   // Subtokens are scanned in place rather than extracted, splitting
+   // in the same way as PerlRegularExpression::getTokens(" "): a single
+   // leading space is skipped and each subtoken is at least one 
+   // character long.
+   const char* ptr = (*this)[field];
+   const char* start;
+   int length;
+   if (*ptr == ' ') {
+      ptr++;
+   }
+   while (*ptr != '\0') {
+      start = ptr++;
+      while ((*ptr != '\0') && (*ptr != ' ')) {
+         ptr++;
+      }
+      length = (int)(ptr - start);
+      if (*ptr == ' ') {
+         ptr++;
+      }
+      if ((length == 1) && (start[0] == '.')) {
          // a Null token (not allowed in chords as a subtoken).
          continue;
       }
-      if (strchr(notes[i].getBase(), 'r') != NULL) {
+      if (memchr(start, 'r', length) != NULL) {
          // rest (not allowed in a chord)
          continue;
       }
-      if (strchr(notes[i].getBase(), ']') != NULL) {
+      if (memchr(start, ']', length) != NULL) {
          // ending printed note if a tie group
          continue;
       }
-      if (strchr(notes[i].getBase(), '_') != NULL) {
+      if (memchr(start, '_', length) != NULL) {
          // tie continuation note
          continue;
       }
@@ -1250,20 +1267,186 @@ int HumdrumRecord::isRest(int field) {
 
 
 
+//////////////////////////////
+//
+// Token matchers for the tandem interpretation tests below.  Each one
+//    is equivalent to the regular expression given in its comment, but
+//    the tests are called for every field on every line by some
+//    programs, so they are done by hand rather than with PCRE.
+//
+
+static int matchClefShape(const char* ptr) {
+   // [CFG]v?\d+
+   if ((*ptr != 'C') && (*ptr != 'F') && (*ptr != 'G')) {
+      return 0;
+   }
+   ptr++;
+   if (*ptr == 'v') {
+      ptr++;
+   }
+   return isdigit((unsigned char)*ptr) ? 1 : 0;
+}
+
+// ^\*oclef[CFG]v?\d+
+static int matchOriginalClef(const char* token) {
+   if (strncmp(token, "*oclef", 6) != 0) {
+      return 0;
+   }
+   return matchClefShape(token + 6);
+}
+
+// ^\*clef[CFG]v?\d+
+static int matchClef(const char* token) {
+   if (strncmp(token, "*clef", 5) != 0) {
+      return 0;
+   }
+   return matchClefShape(token + 5);
+}
+
+// ^\*[A-Ga-g][-#n]?:
+static int matchKey(const char* token) {
+   if (token[0] != '*') {
+      return 0;
+   }
+   char letter = token[1];
+   if (((letter < 'a') || (letter > 'g')) && 
+       ((letter < 'A') || (letter > 'G'))) {
+      return 0;
+   }
+   const char* ptr = token + 2;
+   if ((*ptr == '-') || (*ptr == '#') || (*ptr == 'n')) {
+      ptr++;
+   }
+   return *ptr == ':';
+}
+
+// ^\*[kK]\[[A-Ga-g#-]*\]
+static int matchKeySig(const char* token) {
+   if ((token[0] != '*') || ((token[1] != 'k') && (token[1] != 'K')) ||
+         (token[2] != '[')) {
+      return 0;
+   }
+   const char* ptr = token + 3;
+   while (((*ptr >= 'a') && (*ptr <= 'g')) || ((*ptr >= 'A') && (*ptr <= 'G'))
+         || (*ptr == '#') || (*ptr == '-')) {
+      ptr++;
+   }
+   return *ptr == ']';
+}
+
+// ^\*MM\d+\.?\d*
+static int matchTempo(const char* token) {
+   return (strncmp(token, "*MM", 3) == 0) && 
+         isdigit((unsigned char)token[3]);
+}
+
+// ^\*M\d+/\d+
+static int matchTimeSig(const char* token) {
+   if ((token[0] != '*') || (token[1] != 'M') || 
+         !isdigit((unsigned char)token[2])) {
+      return 0;
+   }
+   const char* ptr = token + 3;
+   while (isdigit((unsigned char)*ptr)) {
+      ptr++;
+   }
+   return (ptr[0] == '/') && isdigit((unsigned char)ptr[1]);
+}
+
+// ^\*met\([^)]*\)
+static int matchMetSig(const char* token) {
+   if (strncmp(token, "*met(", 5) != 0) {
+      return 0;
+   }
+   return strchr(token + 5, ')') != NULL;
+}
+
+// ^\*ITr
+static int matchTranspose(const char* token) {
+   return strncmp(token, "*ITr", 4) == 0;
+}
+
+// ^\*I[a-z]{2,5}
+static int matchInstrumentType(const char* token) {
+   return (token[0] == '*') && (token[1] == 'I') && 
+         islower((unsigned char)token[2]) && islower((unsigned char)token[3]);
+}
+
+// ^\*IC[a-z]+
+static int matchInstrumentClass(const char* token) {
+   return (strncmp(token, "*IC", 3) == 0) && islower((unsigned char)token[3]);
+}
+
+// ^\*I"
+static int matchInstrumentName(const char* token) {
+   return strncmp(token, "*I\"", 3) == 0;
+}
+
+// ^\*I'
+static int matchInstrumentAbbr(const char* token) {
+   return strncmp(token, "*I'", 3) == 0;
+}
+
+// ^\*I#
+static int matchInstrumentNum(const char* token) {
+   return strncmp(token, "*I#", 3) == 0;
+}
+
+// ^\*>\[[^]]*\]$
+static int matchLabelExpansion(const char* token) {
+   if (strncmp(token, "*>[", 3) != 0) {
+      return 0;
+   }
+   const char* ptr = strchr(token + 3, ']');
+   return (ptr != NULL) && (ptr[1] == '\0');
+}
+
+// ^\*>[^[]+\[[^]]*\]$
+static int matchLabelVariant(const char* token) {
+   if ((token[0] != '*') || (token[1] != '>')) {
+      return 0;
+   }
+   const char* ptr = strchr(token + 2, '[');
+   if ((ptr == NULL) || (ptr == token + 2)) {
+      return 0;
+   }
+   ptr = strchr(ptr + 1, ']');
+   return (ptr != NULL) && (ptr[1] == '\0');
+}
+
+// ^\*>[^[]+$
+static int matchLabelMarker(const char* token) {
+   if ((token[0] != '*') || (token[1] != '>') || (token[2] == '\0')) {
+      return 0;
+   }
+   return strchr(token + 2, '[') == NULL;
+}
+
+// ^\*staff\d
+static int matchStaffNumber(const char* token) {
+   return (strncmp(token, "*staff", 6) == 0) && 
+         isdigit((unsigned char)token[6]);
+}
+
+// ^\*staff:\d
+static int matchSysStaffNumber(const char* token) {
+   return (strncmp(token, "*staff:", 7) == 0) && 
+         isdigit((unsigned char)token[7]);
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumRecord::isOriginalClef -- returns true if a clef, but prefixed
 //     with "o" to indicate the clef in the original source.
 //
 
-#define REGEX_ISORIGINALCLEF "^\\*oclef[CFG]v?\\d+" 
-
 int HumdrumRecord::isOriginalClef(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;
-   if (pre.search(aRecord[index], "^\\*oclef[CFG]v?\\d+")) {
+   if (matchOriginalClef(aRecord[index])) {
       return 1;
-   } 
+   }
    if (strcmp("*oclefX", aRecord[index]) == 0) {
       //percussion clef
       return 1;
@@ -1276,7 +1459,7 @@ int HumdrumRecord::isOriginalClef(int index) {
 }
 
 int HumdrumRecord::isAllOriginalClef(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISORIGINALCLEF, "**kern");
+   return HumdrumRecord::isParticularType(matchOriginalClef, "**kern");
 }
 
 
@@ -1287,14 +1470,11 @@ int HumdrumRecord::isAllOriginalClef(void) {
 //    clef tandem interpretation record.
 //
 
-#define REGEX_ISCLEF "^\\*clef[CFG]v?\\d+" 
-
 int HumdrumRecord::isClef(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;
-   if (pre.search(aRecord[index], REGEX_ISCLEF)) {
+   if (matchClef(aRecord[index])) {
       return 1;
-   } 
+   }
    if (strcmp("*clefX", aRecord[index]) == 0) {
       //percussion clef
       return 1;
@@ -1307,7 +1487,7 @@ int HumdrumRecord::isClef(int index) {
 }
 
 int HumdrumRecord::isAllClef(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISCLEF, "**kern");
+   return HumdrumRecord::isParticularType(matchClef, "**kern");
 }
 
 
@@ -1318,11 +1498,11 @@ int HumdrumRecord::isAllClef(void) {
 //    exclusive interpretation (presumably **kern data).
 //
 
-int HumdrumRecord::isParticularType(const char* regexp, const char* exinterp) {
+int HumdrumRecord::isParticularType(int (*matcher)(const char* token),
+      const char* exinterp) {
    int output = 1;
    int j;
    int count = 0;
-   PerlRegularExpression pre;
    HumdrumRecord& aRecord = *this;
    for (j=0; j<aRecord.getFieldCount(); j++) {
       if (!aRecord.isExInterp(j, "**kern")) {
@@ -1333,7 +1513,7 @@ int HumdrumRecord::isParticularType(const char* regexp, const char* exinterp) {
          continue;
       }
       count++;
-      if (!pre.search(aRecord[j], regexp)) {
+      if (!matcher(aRecord[j])) {
          output = 0;
          break;
       }
@@ -1353,19 +1533,16 @@ int HumdrumRecord::isParticularType(const char* regexp, const char* exinterp) {
 // HumdrumRecord::isKey --
 //
 
-#define REGEX_ISKEY "^\\*[A-Ga-g][-#n]?:"
-
-int HumdrumRecord::isKey(int index) { 
+int HumdrumRecord::isKey(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISKEY)) {
+   if (matchKey(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllKey(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISKEY, "**kern");
+   return HumdrumRecord::isParticularType(matchKey, "**kern");
 }
 
 
@@ -1375,19 +1552,16 @@ int HumdrumRecord::isAllKey(void) {
 // HumdrumRecord::isKeySig --
 //
 
-#define REGEX_ISKEYSIG "^\\*[kK]\\[[A-Ga-g#-]*\\]"
-
-int HumdrumRecord::isKeySig(int index) { 
+int HumdrumRecord::isKeySig(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISKEYSIG)) {
+   if (matchKeySig(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllKeySig(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISKEYSIG, "**kern");
+   return HumdrumRecord::isParticularType(matchKeySig, "**kern");
 }
 
 
@@ -1397,19 +1571,16 @@ int HumdrumRecord::isAllKeySig(void) {
 // HumdrumRecord::isTempo --
 //
 
-#define REGEX_ISTEMPO "^\\*MM\\d+\\.?\\d*"
-
-int HumdrumRecord::isTempo(int index) { 
+int HumdrumRecord::isTempo(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISTEMPO)) {
+   if (matchTempo(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllTempo(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISTEMPO, "**kern");
+   return HumdrumRecord::isParticularType(matchTempo, "**kern");
 }
 
 
@@ -1419,19 +1590,16 @@ int HumdrumRecord::isAllTempo(void) {
 // HumdrumRecord::isTimeSig --
 //
 
-#define REGEX_ISTIMESIG "^\\*M\\d+/\\d+"
-
 int HumdrumRecord::isTimeSig(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISTIMESIG)) {
+   if (matchTimeSig(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllTimeSig(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISTIMESIG, "**kern");
+   return HumdrumRecord::isParticularType(matchTimeSig, "**kern");
 }
 
 
@@ -1441,41 +1609,35 @@ int HumdrumRecord::isAllTimeSig(void) {
 // HumdrumRecord::isMetSig --
 //
 
-#define REGEX_ISMETSIG "^\\*met\\([^)]*\\)"
-
 int HumdrumRecord::isMetSig(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISMETSIG)) {
+   if (matchMetSig(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllMetSig(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISMETSIG, "**kern");
+   return HumdrumRecord::isParticularType(matchMetSig, "**kern");
 }
 
 
 
 //////////////////////////////
 //
-// HumdrumRecord::isTranspose --  Work on splitting up this into two cases.
+// HumdrumRecord::isTranspose -- Work on splitting up this into two cases.
 //
 
-#define REGEX_ISTRANSPOSE "^\\*ITr"
-
-int HumdrumRecord::isTranspose(int index) { 
+int HumdrumRecord::isTranspose(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISTRANSPOSE)) {
+   if (matchTranspose(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllTranspose(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISTRANSPOSE, "**kern");
+   return HumdrumRecord::isParticularType(matchTranspose, "**kern");
 }
 
 
@@ -1485,19 +1647,16 @@ int HumdrumRecord::isAllTranspose(void) {
 // HumdrumRecord::isInstrumentType --
 //
 
-#define REGEX_ISINSTRUMENTTYPE "^\\*I[a-z]{2,5}"
-
-int HumdrumRecord::isInstrumentType(int index) { 
+int HumdrumRecord::isInstrumentType(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], "^\\*I[a-z]{2,5}")) {
+   if (matchInstrumentType(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllInstrumentType(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISINSTRUMENTTYPE, "**kern");
+   return HumdrumRecord::isParticularType(matchInstrumentType, "**kern");
 }
 
 
@@ -1507,19 +1666,16 @@ int HumdrumRecord::isAllInstrumentType(void) {
 // HumdrumRecord::isInstrumentClass --
 //
 
-#define REGEX_ISINSTRUMENTCLASS "^\\*IC[a-z]+"
-
 int HumdrumRecord::isInstrumentClass(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISINSTRUMENTCLASS)) {
+   if (matchInstrumentClass(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllInstrumentClass(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISINSTRUMENTCLASS, "**kern");
+   return HumdrumRecord::isParticularType(matchInstrumentClass, "**kern");
 }
 
 
@@ -1529,19 +1685,16 @@ int HumdrumRecord::isAllInstrumentClass(void) {
 // HumdrumRecord::isInstrumentName --
 //
 
-#define REGEX_ISINSTRUMENTNAME "^\\*I\""
-
 int HumdrumRecord::isInstrumentName(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISINSTRUMENTNAME)) {
+   if (matchInstrumentName(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllInstrumentName(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISINSTRUMENTNAME, "**kern");
+   return HumdrumRecord::isParticularType(matchInstrumentName, "**kern");
 }
 
 
@@ -1551,19 +1704,16 @@ int HumdrumRecord::isAllInstrumentName(void) {
 // HumdrumRecord::isInstrumentAbbr --
 //
 
-#define REGEX_ISINSTRUMENTABBR "^\\*I\'"
-
 int HumdrumRecord::isInstrumentAbbr(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISINSTRUMENTNAME)) {
+   if (matchInstrumentAbbr(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllInstrumentAbbr(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISINSTRUMENTABBR, "**kern");
+   return HumdrumRecord::isParticularType(matchInstrumentAbbr, "**kern");
 }
 
 
@@ -1573,19 +1723,16 @@ int HumdrumRecord::isAllInstrumentAbbr(void) {
 // HumdrumRecord::isInstrumentNum --
 //
 
-#define REGEX_ISINSTRUMENTNUM "^\\*I#"
-
-int HumdrumRecord::isInstrumentNum(int index) { 
+int HumdrumRecord::isInstrumentNum(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISINSTRUMENTNUM)) {
+   if (matchInstrumentNum(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllInstrumentNum(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISINSTRUMENTNUM, "**kern");
+   return HumdrumRecord::isParticularType(matchInstrumentNum, "**kern");
 }
 
 
@@ -1595,19 +1742,16 @@ int HumdrumRecord::isAllInstrumentNum(void) {
 // HumdrumRecord::isLabelExpansion --
 //
 
-#define REGEX_ISLABELEXPANSION "^\\*>\\[[^]]*\\]$"
-
 int HumdrumRecord::isLabelExpansion(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISLABELEXPANSION)) {
+   if (matchLabelExpansion(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllLabelExpansion(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISLABELEXPANSION, "**kern");
+   return HumdrumRecord::isParticularType(matchLabelExpansion, "**kern");
 }
 
 
@@ -1617,19 +1761,16 @@ int HumdrumRecord::isAllLabelExpansion(void) {
 // HumdrumRecord::isLabelVariant --
 //
 
-#define REGEX_ISLABELVARIANT "^\\*>[^[]+\\[[^]]*\\]$"
-
 int HumdrumRecord::isLabelVariant(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISLABELVARIANT)) {
+   if (matchLabelVariant(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllLabelVariant(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISLABELVARIANT, "**kern");
+   return HumdrumRecord::isParticularType(matchLabelVariant, "**kern");
 }
 
 
@@ -1639,19 +1780,16 @@ int HumdrumRecord::isAllLabelVariant(void) {
 // HumdrumRecord::isLabelMarker --
 //
 
-#define REGEX_ISLABELMARKER "^\\*>[^[]+$"
-
-int HumdrumRecord::isLabelMarker(int index) { 
+int HumdrumRecord::isLabelMarker(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISLABELMARKER)) {
+   if (matchLabelMarker(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllLabelMarker(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISLABELMARKER, "**kern");
+   return HumdrumRecord::isParticularType(matchLabelMarker, "**kern");
 }
 
 
@@ -1661,41 +1799,36 @@ int HumdrumRecord::isAllLabelMarker(void) {
 // HumdrumRecord::isStaffNumber --
 //
 
-#define REGEX_ISSTAFFNUMBER "^\\*staff\\d"
-
-int HumdrumRecord::isStaffNumber(int index) { 
+int HumdrumRecord::isStaffNumber(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISSTAFFNUMBER)) {
+   if (matchStaffNumber(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllStaffNumber(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISSTAFFNUMBER, "**kern");
+   return HumdrumRecord::isParticularType(matchStaffNumber, "**kern");
 }
 
 
+
 //////////////////////////////
 //
 // HumdrumRecord::isSysStaffNumber -- Andreas's variant on staff numbering
 //     which is local to a particular system on a specific page.
 //
 
-#define REGEX_ISSYSSTAFFNUMBER "^\\*staff:\\d"
-
-int HumdrumRecord::isSysStaffNumber(int index) { 
+int HumdrumRecord::isSysStaffNumber(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISSYSSTAFFNUMBER)) {
+   if (matchSysStaffNumber(aRecord[index])) {
       return 1;
    }
    return 0;
 }
 
 int HumdrumRecord::isAllSysStaffNumber(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISSYSSTAFFNUMBER, "**kern");
+   return HumdrumRecord::isParticularType(matchSysStaffNumber, "**kern");
 }
 
 
@@ -1991,10 +2124,7 @@ HumdrumRecord& HumdrumRecord::operator=(const HumdrumRecord& aRecord) {
 
    int i;
    type = aRecord.type;
-   if (recordString != NULL) {
-      delete [] recordString;
-      recordString = NULL;
-   }
+   releaseStrings();
    if (aRecord.recordString != NULL) {
       recordString = new char[strlen(aRecord.recordString)+1];
       strcpy(recordString, aRecord.recordString);
@@ -2002,13 +2132,6 @@ HumdrumRecord& HumdrumRecord::operator=(const HumdrumRecord& aRecord) {
    modifiedQ = aRecord.modifiedQ;
    interpretation.setSize(aRecord.interpretation.getSize());
 
-   for (i=0; i<recordFields.getSize(); i++) {
-      if (recordFields[i] != NULL) {
-         delete [] recordFields[i];
-         recordFields[i] = NULL;
-      }
-   }
-
    recordFields.setSize(aRecord.recordFields.getSize());
    spineids.clear();
    spineids.resize(aRecord.spineids.size());
@@ -2232,7 +2355,7 @@ void HumdrumRecord::setExInterp(int index, const char* interpString) {
 //
 
 void HumdrumRecord::setToken(int index, const char* aString) {
-   delete [] recordFields[index];
+   releaseString(recordFields[index]);
    int len = strlen(aString);
    recordFields[index] = new char[len+1];
    strcpy(recordFields[index], aString);
@@ -2252,10 +2375,7 @@ void HumdrumRecord::setToken(int index, const string& aString) {
 //
 
 void HumdrumRecord::setLine(const char* aLine) {
-   if (recordString != NULL) {
-      delete [] recordString;
-      recordString = NULL;
-   }
+   releaseStrings();
    int length = strlen(aLine);
    recordString = new char[length+1];
    strcpy(recordString, aLine);
@@ -2263,18 +2383,50 @@ void HumdrumRecord::setLine(const char* aLine) {
       recordString[length-1] = '\0';
    }
    modifiedQ = 0;
-   int i;
+   storeRecordFields(NULL);
+}
+
 
-   if (recordFields.getSize() != 0) {
-      for (i=0; i<recordFields.getSize(); i++) {
-         if (recordFields[i] != NULL) {
-            delete recordFields[i];
-            recordFields[i] = NULL;
-         }
-      }
-      recordFields.setSize(0);
-   }
 
+//////////////////////////////
+//
+// HumdrumRecord::setArenaLine -- sets the record to a line of text
+//     which is owned by a HumdrumFileBasic object (see
+//     HumdrumFileBasic::read()).  The text is not copied: the record
+//     string points directly at aLine, and the fields are split into
+//     the scratch space of length+1 characters which must follow the
+//     null-terminated line.  Fields which are later changed with
+//     changeField(), setToken(), etc. are copied into separate storage,
+//     so the borrowed text is never resized.  The memory must remain
+//     valid for the lifetime of the record's contents.
+//
+
+void HumdrumRecord::setArenaLine(char* aLine, int length) {
+   releaseStrings();
+   if ((length > 0) && ((aLine[length-1] == 0x0d) ||
+         (aLine[length-1] == 0x0a))) {
+      aLine[length-1] = '\0';
+   }
+   recordString = aLine;
+   arenaStart = aLine;
+   arenaEnd = aLine + 2 * length + 2;
+   modifiedQ = 0;
+   storeRecordFields(aLine + length + 1);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::storeRecordFields -- split the record string into
+//     fields.  If fieldText is NULL, then each field is allocated
+//     separately; otherwise, the record string is copied into fieldText
+//     and the fields are terminated in place.
+//
+
+void HumdrumRecord::storeRecordFields(char* fieldText) {
+   int i;
+   recordFields.setSize(0);
    spineids.clear();
 
    type = determineType(recordString);
@@ -2284,6 +2436,7 @@ void HumdrumRecord::setLine(const char* aLine) {
    if (fieldCount == 0) {
       fieldCount = 1;
    }
+   spineids.reserve(fieldCount);
 
    interpretation.setSize(fieldCount);
    for (i=0; i<fieldCount; i++) {
@@ -2297,7 +2450,21 @@ void HumdrumRecord::setLine(const char* aLine) {
    i = 0;
    char* temp;
    int index;
-   if (fieldCount == 1) {
+   if (fieldText != NULL) {
+      strcpy(fieldText, recordString);
+      recordFields[recordFields.getSize()] = fieldText;
+      spineids.push_back("");
+      if (fieldCount > 1) {
+         while (fieldText[i] != '\0') {
+            if (fieldText[i] == '\t') {
+               fieldText[i] = '\0';
+               recordFields[recordFields.getSize()] = fieldText + i + 1;
+               spineids.push_back("");
+            }
+            i++;
+         }
+      }
+   } else if (fieldCount == 1) {
       temp = new char[strlen(recordString)+1];
       strcpy(temp, recordString);
       index = recordFields.getSize(); 
@@ -4286,10 +4453,7 @@ void HumdrumRecord::makeRecordString(void) {
    }
    temp << recordFields[recordFields.getSize()-1] << ends;
 
-   if (recordString != NULL) {
-      delete [] recordString;
-      recordString = NULL;
-   }
+   releaseString(recordString);
    recordString = new char[strlen(temp.str().c_str()) + 1];
    strcpy(recordString, temp.str().c_str());
    modifiedQ = 0;
@@ -4297,6 +4461,56 @@ void HumdrumRecord::makeRecordString(void) {
 
 
 
+//////////////////////////////
+//
+// HumdrumRecord::isArenaString -- returns true if the string is
+//     stored in text borrowed from a HumdrumFileBasic (see setArenaLine()).
+//     The addresses are compared as integers, since the string may not
+//     be part of the borrowed text.
+//
+
+int HumdrumRecord::isArenaString(const char* aString) const {
+   uintptr_t address = (uintptr_t)aString;
+   return (address >= (uintptr_t)arenaStart) && 
+          (address < (uintptr_t)arenaEnd);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::releaseString -- delete a record or field string
+//     unless it is stored in borrowed text.
+//
+
+void HumdrumRecord::releaseString(char*& aString) {
+   if ((aString != NULL) && !isArenaString(aString)) {
+      delete [] aString;
+   }
+   aString = NULL;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::releaseStrings -- release the record string and all
+//     field strings, and forget any borrowed text.
+//
+
+void HumdrumRecord::releaseStrings(void) {
+   releaseString(recordString);
+   int i;
+   for (i=0; i<recordFields.getSize(); i++) {
+      releaseString(recordFields[i]);
+   }
+   recordFields.setSize(0);
+   arenaStart = NULL;
+   arenaEnd = NULL;
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////
 //
 // generic functions
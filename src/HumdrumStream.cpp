@@ -3,6 +3,7 @@
 // Creation Date: Tue Dec 11 16:09:32 PST 2012
 // Last Modified: Tue Dec 11 16:09:38 PST 2012
 // Last Modified: Fri Mar 11 21:26:18 PST 2016 Changed to STL
+// Last Modified: Sun Oct 18 11:48:20 PDT 2026 Added getFileText()
 // Filename:      ...sig/src/sigInfo/HumdrumStream.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumStream.cpp
 // Syntax:        C++ 
@@ -163,6 +164,27 @@ int HumdrumStream::eof(void) {
 //
 
 int HumdrumStream::getFile(HumdrumFile& infile) {
+   stringstream contents;
+   if (!getFileText(infile, contents)) {
+      return 0;
+   }
+   infile.read(contents);
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStream::getFileText -- extract the text of the next HumdrumFile
+//    in the input stream(s) without parsing it.  The filename and
+//    segment level of the HumdrumFile are set, but its contents are
+//    left empty so that the text can be parsed later (possibly in
+//    another thread).  Returns false if there are no more HumdrumFiles
+//    in the input stream.
+//
+
+int HumdrumStream::getFileText(HumdrumFile& infile, stringstream& contents) {
    infile.clear();
    istream* newinput;
 
@@ -429,13 +451,11 @@ restarting:
    // Universal comments (demoted into Global comments) at the start
    // of the data stream (maybe allow for postpending Universal comments
    // in the future).
-   stringstream contents;
    for (int i=0; i<(int)universals.size(); i++) {
       contents << &(universals[i][1]) << "\n";
    }
    buffer << ends;
    contents << buffer.str();
-   infile.read(contents);
    return 1;
 }
 
@@ -0,0 +1,363 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 11:52:06 PDT 2026
+// Last Modified: Sun Oct 18 11:52:09 PDT 2026
+// Last Modified: Sun Oct 18 21:48:15 PDT 2026 Added text filter
+// Filename:      ...sig/src/sigInfo/HumdrumStreamPool.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumStreamPool.cpp
+// Syntax:        C++11
+//
+// Description:   Process the HumdrumFiles from a HumdrumStream with
+//                multiple threads.  Input is read in order by the
+//                calling thread, then parsed and handed to a callback
+//                function by a pool of worker threads.  Output from the
+//                callback is printed in the original input order.
+//
+//                Example use:
+//
+//                   HumdrumStreamPool pool(options);
+//                   pool.setThreadCount(options.getInteger("threads"));
+//                   pool.run([](HumdrumFile& infile, ostream& out) {
+//                      out << infile.getFilename() << "\t"
+//                          << infile.getNumLines() << endl;
+//                   });
+//
+
+#include "HumdrumStreamPool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+
+//////////////////////////////
+//
+// HumdrumStreamTask -- One HumdrumFile being processed by the pool.
+//
+
+class HumdrumStreamTask {
+   public:
+      HumdrumStreamTask(void) { doneQ = 0; }
+
+      HumdrumFile   infile;     // parsed file given to the callback
+      stringstream  contents;   // unparsed text of the file
+      stringstream  output;     // text printed by the callback
+      int           doneQ;      // set when the callback has finished
+};
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamPool::HumdrumStreamPool --
+//
+
+HumdrumStreamPool::HumdrumStreamPool(void) {
+   threadcount = 0;
+   rhythmQ = 0;
+}
+
+HumdrumStreamPool::HumdrumStreamPool(const vector<string>& list) {
+   threadcount = 0;
+   rhythmQ = 0;
+   setFileList(list);
+}
+
+HumdrumStreamPool::HumdrumStreamPool(Options& options) {
+   threadcount = 0;
+   rhythmQ = 0;
+   vector<string> list;
+   options.getArgList(list);
+   setFileList(list);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamPool::~HumdrumStreamPool --
+//
+
+HumdrumStreamPool::~HumdrumStreamPool() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamPool::setFileList -- Set the list of files to process.
+//    If the list is empty, then standard input will be read.
+//
+
+int HumdrumStreamPool::setFileList(const vector<string>& list) {
+   return streamer.setFileList(list);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamPool::setThreadCount -- Set the number of worker threads.
+//    A value of 0 (the default) will use one thread for each processor
+//    core.  A value of 1 processes the files in the calling thread.
+//
+
+void HumdrumStreamPool::setThreadCount(int count) {
+   if (count < 0) {
+      count = 0;
+   }
+   threadcount = count;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamPool::getThreadCount -- Return the number of threads
+//    which will be used to process the files.
+//
+
+int HumdrumStreamPool::getThreadCount(void) {
+   if (threadcount > 0) {
+      return threadcount;
+   }
+   int cores = (int)thread::hardware_concurrency();
+   if (cores < 1) {
+      cores = 1;
+   }
+   return cores;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamPool::setRhythmAnalysis -- Do HumdrumFile::analyzeRhythm()
+//    on each file in the worker threads before giving it to the callback.
+//    Default values: state = 1, base = "".
+//
+
+void HumdrumStreamPool::setRhythmAnalysis(int state, const string& base) {
+   rhythmQ = state;
+   rhythmbase = base;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamPool::setTextFilter -- Set a function which checks the
+//    unparsed text of each file, such as for a quick search of literal
+//    strings.  Files rejected by the filter are not parsed or given to
+//    the processing callback.
+//
+
+void HumdrumStreamPool::setTextFilter(HumdrumStreamFilter filter) {
+   textfilter = filter;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamPool::run -- Process all HumdrumFiles in the input stream
+//    with the callback function.  Returns the number of files processed.
+//    Default value: out = cout.
+//
+
+int HumdrumStreamPool::run(HumdrumStreamCallback callback, ostream& out) {
+   int threads = getThreadCount();
+   if (threads <= 1) {
+      return runSerial(callback, out);
+   } else {
+      return runParallel(callback, out, threads);
+   }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// private functions
+//
+
+//////////////////////////////
+//
+// HumdrumStreamPool::runSerial -- Process the files one at a time in
+//     the calling thread.
+//
+
+int HumdrumStreamPool::runSerial(HumdrumStreamCallback& callback,
+      ostream& out) {
+   HumdrumFile infile;
+   int count = 0;
+   while (1) {
+      stringstream contents;
+      if (!streamer.getFileText(infile, contents)) {
+         break;
+      }
+      count++;
+      if (!parseText(infile, contents)) {
+         continue;
+      }
+      if (rhythmQ) {
+         infile.analyzeRhythm(rhythmbase.c_str());
+      }
+      callback(infile, out);
+   }
+   return count;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamPool::runParallel -- The calling thread splits the input
+//     into files and prints the results, while the worker threads parse
+//     and process files as they become available.  Workers take the
+//     next waiting file from a shared queue, so a long file does not
+//     hold up the other threads.  Only a limited number of files are
+//     kept in memory at one time.
+//
+
+int HumdrumStreamPool::runParallel(HumdrumStreamCallback& callback,
+      ostream& out, int threads) {
+
+   deque<HumdrumStreamTask*> waiting;   // files not yet started
+   deque<HumdrumStreamTask*> ordered;   // all files not yet printed
+   int inputDoneQ = 0;
+   mutex lock;
+   condition_variable workready;
+   condition_variable workdone;
+   int window = threads * 4;
+
+   auto worker = [&]() {
+      HumdrumStreamTask* task;
+      while (1) {
+         {
+            unique_lock<mutex> guard(lock);
+            workready.wait(guard, [&]() {
+               return inputDoneQ || !waiting.empty();
+            });
+            if (waiting.empty()) {
+               return;
+            }
+            task = waiting.front();
+            waiting.pop_front();
+         }
+
+         if (parseText(task->infile, task->contents)) {
+            if (rhythmQ) {
+               task->infile.analyzeRhythm(rhythmbase.c_str());
+            }
+            callback(task->infile, task->output);
+            task->infile.clear();
+         }
+
+         {
+            lock_guard<mutex> guard(lock);
+            task->doneQ = 1;
+         }
+         workdone.notify_one();
+      }
+   };
+
+   vector<thread> pool;
+   pool.reserve(threads);
+   for (int i=0; i<threads; i++) {
+      pool.push_back(thread(worker));
+   }
+
+   // Print finished files at the start of the queue.  If waitQ is true,
+   // then block until the first file in the queue has been finished.
+   auto flush = [&](int waitQ) {
+      HumdrumStreamTask* task;
+      while (1) {
+         {
+            unique_lock<mutex> guard(lock);
+            if (waitQ) {
+               workdone.wait(guard, [&]() {
+                  return ordered.empty() || ordered.front()->doneQ;
+               });
+            }
+            if (ordered.empty() || !ordered.front()->doneQ) {
+               return;
+            }
+            task = ordered.front();
+            ordered.pop_front();
+         }
+         out << task->output.str();
+         delete task;
+         waitQ = 0;
+      }
+   };
+
+   int count = 0;
+   HumdrumStreamTask* task;
+   while (1) {
+      task = new HumdrumStreamTask;
+      if (!streamer.getFileText(task->infile, task->contents)) {
+         delete task;
+         break;
+      }
+      count++;
+      {
+         lock_guard<mutex> guard(lock);
+         ordered.push_back(task);
+         waiting.push_back(task);
+      }
+      workready.notify_one();
+      flush((int)ordered.size() >= window);
+   }
+
+   {
+      lock_guard<mutex> guard(lock);
+      inputDoneQ = 1;
+   }
+   workready.notify_all();
+
+   while (!ordered.empty()) {
+      flush(1);
+   }
+
+   for (int i=0; i<(int)pool.size(); i++) {
+      pool[i].join();
+   }
+
+   return count;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStreamPool::parseText -- Copy the unparsed text of a file out
+//     of the stream buffer once, check it with the text filter, and then
+//     parse the HumdrumFile from that copy.  Text starting with an
+//     embedded PDF or a URI line is parsed with read() so that it is
+//     handled in the same way as other input streams.  Returns false if
+//     the file was rejected by the text filter.
+//
+
+int HumdrumStreamPool::parseText(HumdrumFile& infile,
+      stringstream& contents) {
+   const string text = contents.str();
+   contents.str("");
+   if (textfilter && !textfilter(text)) {
+      return 0;
+   }
+   string::size_type firstline = text.find('\n');
+   if ((!text.empty() && (text[0] == '%')) ||
+         (text.substr(0, firstline).find("://") != string::npos)) {
+      stringstream input(text);
+      infile.read(input);
+   } else {
+      infile.readMemory(text.data(), (int)text.size());
+   }
+   return 1;
+}
@@ -0,0 +1,177 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 13:05:11 PDT 2026
+// Last Modified: Sun Oct 18 13:05:14 PDT 2026
+// Filename:      ...sig/src/sigInfo/KernToken.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/KernToken.cpp
+// Syntax:        C++
+//
+// Description:   Pre-parsed contents of a single **kern subtoken (one note
+//                of a chord).  Used by HumdrumFile::analyzeKernTokens() so
+//                that analysis loops do not have to re-parse token strings.
+//
+
+#include "KernToken.h"
+#include "Convert.h"
+
+#include <string.h>
+#include <string>
+
+using namespace std;
+
+
+//////////////////////////////
+//
+// KernToken::KernToken --
+//
+
+KernToken::KernToken(void) {
+   clear();
+}
+
+
+KernToken::KernToken(const char* subtoken) {
+   parse(subtoken);
+}
+
+
+
+//////////////////////////////
+//
+// KernToken::~KernToken --
+//
+
+KernToken::~KernToken() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// KernToken::clear --
+//
+
+void KernToken::clear(void) {
+   base40   = -1;
+   midi     = -1;
+   duration = 0;
+   flags    = KT_NULL;
+}
+
+
+
+//////////////////////////////
+//
+// KernToken::parse -- Extract the pitch, duration and markers from a
+//     single **kern subtoken.  The pitch and duration are the same as
+//     the values returned by the equivalent Convert functions.
+//
+
+void KernToken::parse(const char* subtoken) {
+   parse(subtoken, (int)strlen(subtoken));
+}
+
+
+void KernToken::parse(const char* subtoken, int length) {
+   string text(subtoken, length);
+   if (text == ".") {
+      clear();
+      return;
+   }
+
+   flags = 0;
+   for (int i=0; i<length; i++) {
+      switch (subtoken[i]) {
+         case 'r':  flags |= KT_REST;          break;
+         case 'q':  flags |= KT_GRACE;         break;
+         case 'Q':  flags |= KT_GRACE;         break;
+         case '[':  flags |= KT_TIE_START;     break;
+         case '_':  flags |= KT_TIE_CONTINUE;  break;
+         case ']':  flags |= KT_TIE_END;       break;
+         case 'L':  flags |= KT_BEAM_START;    break;
+         case 'J':  flags |= KT_BEAM_END;      break;
+         case '\'': flags |= KT_STACCATO;      break;
+         case '^':  flags |= KT_ACCENT;        break;
+         case '~':  flags |= KT_TENUTO;        break;
+         case ';':  flags |= KT_FERMATA;       break;
+         case '(':  flags |= KT_SLUR_START;    break;
+         case ')':  flags |= KT_SLUR_END;      break;
+         case '{':  flags |= KT_PHRASE_START;  break;
+         case '}':  flags |= KT_PHRASE_END;    break;
+      }
+   }
+
+   base40   = Convert::kernToBase40(text);
+   midi     = Convert::kernToMidiNoteNumber(text);
+   duration = Convert::kernToDurationR(text);
+}
+
+
+
+//////////////////////////////
+//
+// KernToken::getDuration -- Duration in quarter notes as a double.
+//
+
+double KernToken::getDuration(void) const {
+   return duration.getFloat();
+}
+
+
+
+//////////////////////////////
+//
+// KernToken::is* -- Tests for individual flags.
+//
+
+int KernToken::isNull(void) const {
+   return (flags & KT_NULL) ? 1 : 0;
+}
+
+int KernToken::isRest(void) const {
+   return (flags & KT_REST) ? 1 : 0;
+}
+
+int KernToken::isGrace(void) const {
+   return (flags & KT_GRACE) ? 1 : 0;
+}
+
+int KernToken::isTieStart(void) const {
+   return (flags & KT_TIE_START) ? 1 : 0;
+}
+
+int KernToken::isTieContinue(void) const {
+   return (flags & KT_TIE_CONTINUE) ? 1 : 0;
+}
+
+int KernToken::isTieEnd(void) const {
+   return (flags & KT_TIE_END) ? 1 : 0;
+}
+
+int KernToken::isTied(void) const {
+   return (flags & KT_TIE_MASK) ? 1 : 0;
+}
+
+int KernToken::hasFlag(int aFlag) const {
+   return (flags & aFlag) ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// KernToken::isNoteAttack -- True if the token is not a null token,
+//     rest, or the continuation or ending of a tied note.  Matches
+//     the definition used by HumdrumRecord::hasNoteAttack().
+//
+
+int KernToken::isNoteAttack(void) const {
+   if (flags & (KT_NULL | KT_REST | KT_TIE_CONTINUE | KT_TIE_END)) {
+      return 0;
+   }
+   return 1;
+}
+
+
+
@@ -0,0 +1,242 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 17:20:44 PDT 2026
+// Last Modified: Sun Oct 18 17:20:48 PDT 2026
+// Filename:      ...sig/src/sigInfo/KeyCorrelation.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/KeyCorrelation.cpp
+// Syntax:        C++
+//
+// Description:   Krumhansl-Schmuckler style key-finding engine for
+//                sliding-window analyses.  Pitch-class histograms of
+//                consecutive time segments are stored as prefix sums so
+//                that the histogram of any window is calculated in
+//                constant time, and the 24 key profiles are rotated and
+//                mean-centered once so that all Pearson correlations for
+//                a histogram are calculated in one 24x12 product.
+//
+
+#include "KeyCorrelation.h"
+
+#include <math.h>
+#include <string.h>
+
+
+//////////////////////////////
+//
+// KeyCorrelation::KeyCorrelation --
+//
+
+KeyCorrelation::KeyCorrelation(void) {
+   memset(profiles, 0, sizeof(profiles));
+   clearSegments();
+}
+
+
+KeyCorrelation::KeyCorrelation(const double* major, const double* minor) {
+   setProfiles(major, minor);
+   clearSegments();
+}
+
+
+
+//////////////////////////////
+//
+// KeyCorrelation::~KeyCorrelation --
+//
+
+KeyCorrelation::~KeyCorrelation() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// KeyCorrelation::setProfiles -- Set the major and minor key profiles
+//     (12 values each, starting on the tonic).  Key i (0-11) is the
+//     major key with a tonic of pitch class i, and key i+12 is the minor
+//     key with the same tonic.  Each rotated profile is mean-centered
+//     and scaled to unit length, which removes the profile terms from
+//     the Pearson correlation calculation.
+//
+
+void KeyCorrelation::setProfiles(const double* major, const double* minor) {
+   const double* profile;
+   double mean;
+   double sum;
+   int i, j, k;
+   for (k=0; k<24; k++) {
+      profile = (k < 12) ? major : minor;
+      mean = 0.0;
+      for (j=0; j<12; j++) {
+         mean += profile[j];
+      }
+      mean /= 12.0;
+      sum = 0.0;
+      i = k % 12;
+      for (j=0; j<12; j++) {
+         profiles[k][(j+i)%12] = profile[j] - mean;
+         sum += (profile[j] - mean) * (profile[j] - mean);
+      }
+      sum = sqrt(sum);
+      for (j=0; j<12; j++) {
+         profiles[k][j] = (sum > 0.0) ? profiles[k][j] / sum : 0.0;
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// KeyCorrelation::clearSegments -- Remove all segment histograms.
+//
+
+void KeyCorrelation::clearSegments(void) {
+   prefix.resize(12);
+   for (int i=0; i<12; i++) {
+      prefix[i] = 0.0;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// KeyCorrelation::appendSegment -- Add the pitch-class histogram of
+//     the next time segment.
+//
+
+void KeyCorrelation::appendSegment(const double* histogram) {
+   int last = (int)prefix.size() - 12;
+   prefix.resize(prefix.size() + 12);
+   for (int i=0; i<12; i++) {
+      prefix[last+12+i] = prefix[last+i] + histogram[i];
+   }
+}
+
+
+
+//////////////////////////////
+//
+// KeyCorrelation::setSegments -- Store a list of segment histograms
+//     (each with at least 12 values).
+//
+
+void KeyCorrelation::setSegments(Array<Array<double> >& segments) {
+   clearSegments();
+   prefix.reserve((segments.getSize() + 1) * 12);
+   for (int i=0; i<segments.getSize(); i++) {
+      appendSegment(segments[i].getBase());
+   }
+}
+
+
+void KeyCorrelation::setSegments(vector<vector<double> >& segments) {
+   clearSegments();
+   prefix.reserve((segments.size() + 1) * 12);
+   for (int i=0; i<(int)segments.size(); i++) {
+      appendSegment(segments[i].data());
+   }
+}
+
+
+
+//////////////////////////////
+//
+// KeyCorrelation::getSegmentCount -- Return the number of stored
+//     segment histograms.
+//
+
+int KeyCorrelation::getSegmentCount(void) const {
+   return (int)prefix.size() / 12 - 1;
+}
+
+
+
+//////////////////////////////
+//
+// KeyCorrelation::getHistogram -- Return the pitch-class histogram of
+//     count segments starting at segment start.
+//
+
+void KeyCorrelation::getHistogram(double* histogram, int start,
+      int count) const {
+   const double* a = prefix.data() + start * 12;
+   const double* b = prefix.data() + (start + count) * 12;
+   for (int i=0; i<12; i++) {
+      histogram[i] = b[i] - a[i];
+   }
+}
+
+
+
+//////////////////////////////
+//
+// KeyCorrelation::correlate -- Calculate the Pearson correlation of
+//     the histogram with each of the 24 keys, and return the key with
+//     the highest correlation (the first one in case of a tie).  Returns
+//     -1 if the histogram is empty, in which case all scores are 0.
+//     If the histogram is not empty but all of its values are equal,
+//     the correlations are undefined (NaN) and key 0 is returned.
+//
+
+int KeyCorrelation::correlate(double* scores, const double* histogram) const {
+   double centered[12];
+   double sum = 0.0;
+   int i, k;
+   for (i=0; i<12; i++) {
+      sum += histogram[i];
+   }
+   if (sum == 0.0) {
+      for (k=0; k<24; k++) {
+         scores[k] = 0.0;
+      }
+      return -1;
+   }
+
+   double mean = sum / 12.0;
+   double norm = 0.0;
+   for (i=0; i<12; i++) {
+      centered[i] = histogram[i] - mean;
+      norm += centered[i] * centered[i];
+   }
+   norm = sqrt(norm);
+
+   // all rows of the profile matrix are contiguous so that
+   // this loop can be vectorized by the compiler.
+   double dot;
+   for (k=0; k<24; k++) {
+      dot = 0.0;
+      for (i=0; i<12; i++) {
+         dot += profiles[k][i] * centered[i];
+      }
+      scores[k] = dot / norm;
+   }
+
+   int best = 0;
+   for (k=1; k<24; k++) {
+      if (scores[k] > scores[best]) {
+         best = k;
+      }
+   }
+   return best;
+}
+
+
+
+//////////////////////////////
+//
+// KeyCorrelation::correlateWindow -- Calculate the key correlations
+//     for count segments starting at segment start.
+//
+
+int KeyCorrelation::correlateWindow(double* scores, int start,
+      int count) const {
+   double histogram[12];
+   getHistogram(histogram, start, count);
+   return correlate(scores, histogram);
+}
+
+
+
@@ -0,0 +1,179 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 10:02:17 PDT 2026
+// Last Modified: Sun Oct 18 10:02:17 PDT 2026
+// Filename:      ...sig/src/sigInfo/MappedFile.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/MappedFile.cpp
+// Syntax:        C++ 
+//
+// Description:   Read-only view of the complete contents of a file.  The
+//                file is memory-mapped when possible; otherwise it is
+//                read into a single buffer.
+//
+
+#include "MappedFile.h"
+
+#include <stdio.h>
+
+#ifndef VISUAL
+   #include <sys/types.h>
+   #include <sys/stat.h>
+   #include <sys/mman.h>
+   #include <fcntl.h>
+   #include <unistd.h>
+#endif
+
+
+//////////////////////////////
+//
+// MappedFile::MappedFile --
+//
+
+MappedFile::MappedFile(void) {
+   data    = NULL;
+   size    = 0;
+   mappedQ = 0;
+   openQ   = 0;
+}
+
+
+MappedFile::MappedFile(const char* filename) {
+   data    = NULL;
+   size    = 0;
+   mappedQ = 0;
+   openQ   = 0;
+   open(filename);
+}
+
+
+
+//////////////////////////////
+//
+// MappedFile::~MappedFile --
+//
+
+MappedFile::~MappedFile() {
+   close();
+}
+
+
+
+//////////////////////////////
+//
+// MappedFile::open -- Make the contents of a file available through
+//     getData().  Returns 0 if the file could not be opened or read.
+//
+
+int MappedFile::open(const char* filename) {
+   close();
+
+#ifndef VISUAL
+   int fd = ::open(filename, O_RDONLY);
+   if (fd < 0) {
+      return 0;
+   }
+   struct stat info;
+   if ((fstat(fd, &info) != 0) || !S_ISREG(info.st_mode)) {
+      ::close(fd);
+      return 0;
+   }
+   size = (long)info.st_size;
+   if (size == 0) {
+      ::close(fd);
+      openQ = 1;
+      return 1;
+   }
+   void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   ::close(fd);
+   if (mapping != MAP_FAILED) {
+      #ifdef MADV_SEQUENTIAL
+         madvise(mapping, size, MADV_SEQUENTIAL);
+      #endif
+      data    = (const char*)mapping;
+      mappedQ = 1;
+      openQ   = 1;
+      return 1;
+   }
+   size = 0;
+#endif
+
+   // memory mapping not available, so read the file into a buffer.
+   FILE* input = fopen(filename, "rb");
+   if (input == NULL) {
+      return 0;
+   }
+   fseek(input, 0, SEEK_END);
+   size = ftell(input);
+   fseek(input, 0, SEEK_SET);
+   if (size < 0) {
+      size = 0;
+      fclose(input);
+      return 0;
+   }
+   char* buffer = new char[size + 1];
+   size = (long)fread(buffer, 1, size, input);
+   fclose(input);
+   data  = buffer;
+   openQ = 1;
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// MappedFile::close -- Release the file contents.
+//
+
+void MappedFile::close(void) {
+   if (data != NULL) {
+      if (mappedQ) {
+         #ifndef VISUAL
+            munmap((void*)data, size);
+         #endif
+      } else {
+         delete [] data;
+      }
+   }
+   data    = NULL;
+   size    = 0;
+   mappedQ = 0;
+   openQ   = 0;
+}
+
+
+
+//////////////////////////////
+//
+// MappedFile::isOpen -- Returns true if a file is available.
+//
+
+int MappedFile::isOpen(void) const {
+   return openQ;
+}
+
+
+
+//////////////////////////////
+//
+// MappedFile::getData -- Returns the start of the file contents.  The
+//     contents are not null-terminated.  Returns NULL for an empty file.
+//
+
+const char* MappedFile::getData(void) const {
+   return data;
+}
+
+
+
+//////////////////////////////
+//
+// MappedFile::getSize -- Returns the number of bytes in the file.
+//
+
+long MappedFile::getSize(void) const {
+   return size;
+}
+
+
+
@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Thu Jun  3 14:08:25 PDT 2010
 // Last Modified: Tue Jun 15 14:15:42 PDT 2010 (added tied note functionality)
+// Last Modified: Sun Oct 18 22:14:31 PDT 2026 (sorted time sequence)
+// Last Modified: Sun Oct 18 22:47:20 PDT 2026 (removed regexs from analyses)
 // Filename:      ...sig/src/sigInfo/MuseData.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/MuseData.cpp
 // Syntax:        C++ 
@@ -18,6 +20,7 @@
 #include <string.h>
 #include <cctype>
 #include <stdlib.h>
+#include <algorithm>
 
 #ifndef OLDCPP
    #include <sstream>
@@ -36,6 +39,15 @@
    #define CSTRING str()
 #endif
    
+// (absolute time, line index) pairs for sorting lines into time order:
+typedef struct {
+   RationalNumber time;
+   int            line;
+} _MuseTimeLine;
+
+static bool timelinecompare(const _MuseTimeLine& a, const _MuseTimeLine& b);
+static int  getQValue      (const char* line, int& value);
+
 
 ///////////////////////////////////////////////////////////////////////////
 //
@@ -128,6 +140,10 @@ RationalNumber MuseEventSet::getTime(void) {
 //
 
 void MuseEventSet::appendRecord(MuseRecord* arecord) { 
+   if (events.getSize() >= events.getAllocSize()) {
+      // double the storage size for events with many records
+      events.grow(events.getSize() > 20 ? events.getSize() : 20);
+   }
    events.append(arecord);
 }
 
@@ -394,15 +410,19 @@ void MuseData::read(istream& input) {
    int  isnewline;
    char lastvalue = 0;
 
-   while (!input.eof()) {
-      character = input.get();
-      if (input.eof()) {
+   // read characters directly from the stream buffer, which is much
+   // faster than istream::get():
+   streambuf* buffer = input.rdbuf();
+   while (1) {
+      character = buffer->sbumpc();
+      if (character == EOF) {
          // end of file found without a newline termination on last line.
-         if ((dataline.getSize() > 0) && (strlen(dataline.getBase()) > 0)) {
+         if ((dataline.getSize() > 0) && (dataline[0] != '\0')) {
             MuseData::append(dataline);
             dataline.setSize(0);
-            break;
          }
+         input.setstate(ios::eofbit);
+         break;
       }
       value = (char)character;
       if ((value == 0x0d) || (value == 0x0a)) {
@@ -552,7 +572,7 @@ void MuseData::processTie(int eindex, int rindex, int lastindex) {
 
    // The pitch of the tied note should match this one; otherwise, it
    // would not be a tied note...
-   int base40 = data[lineindex]->getPitch();
+   int base40 = data[lineindex]->getMarkupPitch();
 
    // The tied note will preferrably be found in the same track as the
    // current note (but there could be a cross-track tie occurring, so
@@ -598,7 +618,8 @@ void MuseData::processTie(int eindex, int rindex, int lastindex) {
 // 
 //   Will also have to separate by category, so that grace notes are
 //   searched for separately from regular notes / chord notes, and 
-//   cue notes as well.
+//   cue notes as well.  Uses the base-40 pitches stored by
+//   analyzePitch(), so that the note fields are only decoded once.
 //
 
 int MuseData::searchForPitch(int eventindex, int b40, int track) {
@@ -618,7 +639,7 @@ int MuseData::searchForPitch(int eventindex, int b40, int track) {
       if ((track >= 0) && (track != targettrack)) {
          continue;
       }
-      targetpitch = getEvent(eventindex)[j].getPitch();
+      targetpitch = getEvent(eventindex)[j].getMarkupPitch();
       if (targetpitch == b40) {
          return j;
       }
@@ -635,19 +656,27 @@ int MuseData::searchForPitch(int eventindex, int b40, int track) {
 //   absolute time value.  The starting index is given first, and it
 //   is assumed that the target absolute time occurs on or after the 
 //   starting index value.  Returns -1 if that absolute time is not
-//   found in the data (or occurs before the start index.
+//   found in the data (or occurs before the start index.  The event
+//   times are unique and sorted, so a binary search is used.
 //
 
 int MuseData::getNextEventIndex(int startindex, RationalNumber target) {
-   int i;
-   int output = -1;
-   for (i=startindex; i<sequence.getSize(); i++) {
-      if (sequence[i]->getTime() == target) {
-         output = i;
-         break;
+   int low  = startindex < 0 ? 0 : startindex;
+   int high = sequence.getSize() - 1;
+   int mid;
+   RationalNumber mtime;
+   while (low <= high) {
+      mid = (low + high) / 2;
+      mtime = sequence[mid]->getTime();
+      if (mtime == target) {
+         return mid;
+      } else if (mtime < target) {
+         low = mid + 1;
+      } else {
+         high = mid - 1;
       }
    }
-   return output;
+   return -1;
 }
 
 
@@ -780,17 +809,13 @@ void MuseData::analyzeRhythm(void) {
    RationalNumber cumulative(0,1);
    RationalNumber linedur(0,1);
    int tpq = 1;
-   PerlRegularExpression pre;
-   char buffer[128] = {0};
 
    RationalNumber primarychordnoteduration(0,1);  // needed for chord notes
   
    int i;
    for (i=0; i<data.getSize(); i++) {
       if (data[i]->getType() == E_muserec_musical_attributes) {
-         if (pre.search(data[i]->getLine(), "Q:(\\d+)", "")) {
-            tpq = atoi(pre.getSubmatch(1));
-         }
+         getQValue(data[i]->getLine(), tpq);
       }
 
       if (data[i]->getType() == E_muserec_note_chord) {
@@ -803,8 +828,7 @@ void MuseData::analyzeRhythm(void) {
 	 // set the note duration to the duration of the primary chord
 	 // note (first note before the current note which is not a chord
 	 // note).
-	 data[i]->getTickDurationField(buffer);
-	 if (pre.search(buffer, "\\d", "")) {
+	 if (data[i]->tickDurationQ()) {
             data[i]->setNoteDuration(data[i]->getNoteTickDuration(), tpq);
          } else {
             data[i]->setNoteDuration(primarychordnoteduration);
@@ -850,7 +874,6 @@ int MuseData::getInitialTPQ(void) {
    if (data.getSize() == 0) {
       return output;
    }
-   PerlRegularExpression pre;
    int i;
    if (data[0]->getType() == E_muserec_unknown) {
       // search for first line which starts with '$':
@@ -859,18 +882,14 @@ int MuseData::getInitialTPQ(void) {
             continue;
          }
          if ((*data[i])[0] == '$') {
-            if (pre.search(data[i]->getLine(), "Q:(\\d+)", "")) {
-               output = atoi(pre.getSubmatch(1));
-            }
+            getQValue(data[i]->getLine(), output);
             break;
          }
       }
    } else {
       for (i=0; i<data.getSize(); i++) {
          if (data[i]->getType() == E_muserec_musical_attributes) {
-            if (pre.search(data[i]->getLine(), "Q:(\\d+)", "")) {
-               output = atoi(pre.getSubmatch(1));
-            }
+            getQValue(data[i]->getLine(), output);
             break;
          }
       }
@@ -884,18 +903,48 @@ int MuseData::getInitialTPQ(void) {
 //////////////////////////////
 //
 // constructTimeSequence -- Make a list of the lines in the file
-//    sorted by the absolute time at which they occur.
+//    sorted by the absolute time at which they occur.  The lines are
+//    sorted once by time (and then by line index, so that records
+//    at the same time stay in file order), and then grouped into one
+//    event set for each unique time.
 //
 
 void MuseData::constructTimeSequence(void) {
    int i;
 
-   // * clear old event set
-   // * allocate the size to match number of lines (* 2 probably).
+   for (i=0; i<sequence.getSize(); i++) {
+      delete sequence[i];
+      sequence[i] = NULL;
+   }
+   sequence.setSize(0);
 
    MuseData& thing = *this;
-   for (i=0; i<data.getSize(); i++) {
-      insertEventBackwards(thing[i].getAbsBeatR(), &thing[i]);
+   int count = data.getSize();
+   Array<_MuseTimeLine> timeline;
+   timeline.setSize(count);
+   int sortedQ = 1;
+   for (i=0; i<count; i++) {
+      timeline[i].time = thing[i].getAbsBeatR();
+      timeline[i].line = i;
+      if (sortedQ && (i > 0) && (timeline[i].time < timeline[i-1].time)) {
+         sortedQ = 0;
+      }
+   }
+   // backups in multi-voice parts are the only source of unsorted lines
+   if (!sortedQ) {
+      std::sort(timeline.getBase(), timeline.getBase() + count,
+            timelinecompare);
+   }
+
+   sequence.setSize(count);
+   sequence.setSize(0);
+   MuseEventSet* anevent = NULL;
+   for (i=0; i<count; i++) {
+      if ((anevent == NULL) || !(anevent->getTime() == timeline[i].time)) {
+         anevent = new MuseEventSet(timeline[i].time);
+         sequence.append(anevent);
+      }
+      anevent->appendRecord(&thing[timeline[i].line]);
    }
 }
 
@@ -931,67 +980,6 @@ MuseEventSet& MuseData::getEvent(int eindex) {
 
 
 
-//////////////////////////////
-//
-// MuseData::insertEventBackwards -- insert an event into a time-sorted
-//    organization of the file. Searches for the correct time location to
-//    insert event starting at the end of the list (since MuseData files
-//    are mostly sorted in time.
-//
-//
-
-void printSequenceTimes(Array<MuseEventSet*>& sequence) {
-   int i;
-   for (i=0; i<sequence.getSize(); i++) {
-      cout << sequence[i]->getTime().getFloat() << " ";
-   }
-   cout << endl;
-}
-
-
-void MuseData::insertEventBackwards(RationalNumber atime, MuseRecord* arecord) {
-   int i, j;
-
-   if (sequence.getSize() == 0) {
-      MuseEventSet* anevent = new MuseEventSet;
-      anevent->setTime(atime);
-      anevent->appendRecord(arecord);
-      sequence.append(anevent);
-      return;
-   }
-
-   for (i=sequence.getSize()-1; i>=0; i--) {
-      if (sequence[i]->getTime() == atime) {
-         sequence[i]->appendRecord(arecord);
-         return;
-      } else if (sequence[i]->getTime() < atime) {
-         // insert new event entry after the current one since it occurs later.
-         MuseEventSet* anevent = new MuseEventSet;
-         anevent->setTime(atime);
-         anevent->appendRecord(arecord);
-         if (i == sequence.getSize()-1) {
-            // just append the event at the end of the list
-            sequence.append(anevent);
-	    return;
-         } else {
-            // event has to be inserted before end of list, so move
-            // later ones up in list.
-            sequence.setSize(sequence.getSize()+1);
-            for (j=sequence.getSize()-1; j>i+1; j--) {
-               sequence[j] = sequence[j-1];
-            }
-            // store the newly created event entry in sequence:
-            sequence[i+1] = anevent;
-            return;
-         }
-      }
-   }
-
-   cerr << "FUNNY ERROR OCCURED at time " << atime << endl;
-   exit(1);
-}
-
-
 //////////////////////////////
 //
 // MuseData::getTiedDuration -- these version acess the record lines
@@ -1371,6 +1359,41 @@ ostream& operator<<(ostream& out, MuseData& musedata) {
 
 
 
+//////////////////////////////
+//
+// timelinecompare -- sort by time, and then by line index.
+//
+
+static bool timelinecompare(const _MuseTimeLine& a, const _MuseTimeLine& b) {
+   if (a.time < b.time) {
+      return true;
+   }
+   if (b.time < a.time) {
+      return false;
+   }
+   return a.line < b.line;
+}
+
+
+
+//////////////////////////////
+//
+// getQValue -- Find the ticks-per-quarter value in the "Q:" field of
+//    a musical attributes record.  Returns false if there is no Q:
+//    field (with digits) on the line, in which case value is unchanged.
+//
+
+static int getQValue(const char* line, int& value) {
+   const char* ptr = strstr(line, "Q:");
+   while (ptr != NULL) {
+      if (std::isdigit(ptr[2])) {
+         value = atoi(ptr + 2);
+         return 1;
+      }
+      ptr = strstr(ptr + 1, "Q:");
+   }
+   return 0;
+}
 
 
 
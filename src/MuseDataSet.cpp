@@ -3,18 +3,25 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Thu Jun 17 13:27:39 PDT 2010
 // Last Modified: Thu Jun 17 13:27:46 PDT 2010
+// Last Modified: Sun Oct 18 22:31:12 PDT 2026 (threaded reading, time index)
 // Filename:      ...sig/src/sigInfo/MuseDataSet.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/MuseDataSet.cpp
-// Syntax:        C++ 
+// Syntax:        C++11
 // 
 // Description:   A class that stores a collection of MuseDataSet files
-//                representing parts for the same score.
+//                representing parts for the same score.  Parts from
+//                a multi-part file are read and analyzed in parallel,
+//                and a time index merges the event times of all parts.
 //
 
 #include "MuseDataSet.h"
 #include "PerlRegularExpression.h"
 #include <string.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #ifndef OLDCPP
    #include <sstream>
    #include <fstream>
@@ -48,6 +55,8 @@ MuseDataSet::MuseDataSet (void) {
    part.setSize(100);
    part.setSize(0);
    part.setGrowth(1000);
+   threadcount = 0;
+   timeindexQ = 0;
 }
 
 
@@ -62,7 +71,40 @@ void MuseDataSet::clear(void) {
    for (i=0; i<part.getSize(); i++) {
       delete part[i];
    }
+   part.setSize(0);
+   timelist.setSize(0);
+   timeindex.setSize(0);
+   timeindexQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// MuseDataSet::setThreadCount -- Set the number of threads used to
+//    read and analyze the parts of a multi-part file.  A value of 0
+//    (the default) will use one thread for each processor core.  A
+//    value of 1 reads the parts in the calling thread.
+//
 
+void MuseDataSet::setThreadCount(int count) {
+   threadcount = count < 0 ? 0 : count;
+}
+
+
+
+//////////////////////////////
+//
+// MuseDataSet::getThreadCount -- Return the number of threads which
+//    will be used to read parts.
+//
+
+int MuseDataSet::getThreadCount(void) {
+   if (threadcount > 0) {
+      return threadcount;
+   }
+   int cores = (int)std::thread::hardware_concurrency();
+   return cores > 0 ? cores : 1;
 }
 
 
@@ -141,19 +183,60 @@ void MuseDataSet::read(istream& infile) {
    startindex.setSize(0);
    stopindex.setSize(0);
    analyzePartSegments(startindex, stopindex, datalines);
+   readParts(datalines, startindex, stopindex);
+}
 
-   int i, j;
-   SSTREAM* sstream;
-   MuseData* md;
-   for (i=0; i<startindex.getSize(); i++) {
-      sstream = new SSTREAM;
-      for (j=startindex[i]; j<=stopindex[i]; j++) {
-          (*sstream) << datalines[j] << '\n';
+
+
+//////////////////////////////
+//
+// MuseDataSet::readParts -- Read and analyze each segment of lines
+//    as a separate part.  The parts are independent of each other, so
+//    they are processed by a pool of threads, and then appended to
+//    the part list in file order.
+//
+
+void MuseDataSet::readParts(Array<string>& lines, Array<int>& startindex, 
+      Array<int>& stopindex) {
+   int count = startindex.getSize();
+   Array<MuseData*> newparts;
+   newparts.setSize(count);
+   newparts.setAll(NULL);
+
+   std::atomic<int> nextpart(0);
+   auto worker = [&]() {
+      int i, j;
+      while ((i = nextpart++) < count) {
+         SSTREAM sstream;
+         for (j=startindex[i]; j<=stopindex[i]; j++) {
+             sstream << lines[j] << '\n';
+         }
+         newparts[i] = new MuseData;
+         newparts[i]->read(sstream);
+      }
+   };
+
+   int threads = getThreadCount();
+   if (threads > count) {
+      threads = count;
+   }
+   if (threads <= 1) {
+      worker();
+   } else {
+      std::vector<std::thread> pool;
+      pool.reserve(threads);
+      int i;
+      for (i=0; i<threads; i++) {
+         pool.push_back(std::thread(worker));
+      }
+      for (i=0; i<threads; i++) {
+         pool[i].join();
       }
-      md = new MuseData;
-      md->read(*sstream);
-      appendPart(md);
-      delete sstream;
+   }
+
+   int i;
+   for (i=0; i<count; i++) {
+      appendPart(newparts[i]);
    }
 }
 
@@ -169,6 +252,7 @@ int MuseDataSet::appendPart(MuseData* musedata) {
    int index = part.getSize();
    part.setSize(part.getSize()+1);
    part[index] = musedata;
+   timeindexQ = 0;
    return index;
 }
 
@@ -181,7 +265,7 @@ int MuseDataSet::appendPart(MuseData* musedata) {
 //
 
 void MuseDataSet::analyzePartSegments(Array<int>& startindex, 
-      Array<int>& stopindex, Array<string> lines) {
+      Array<int>& stopindex, Array<string>& lines) {
  
    startindex.setSize(1000);
    startindex.setSize(0);
@@ -342,6 +426,7 @@ void MuseDataSet::deletePart(int index) {
       part[i-1] = part[i];
    }
    part.setSize(part.getSize()-1);
+   timeindexQ = 0;
 }
 
 
@@ -360,6 +445,137 @@ void MuseDataSet::cleanLineEndings(void) {
 
 
 
+//////////////////////////////
+//
+// MuseDataSet::getTimeCount -- return the number of unique event
+//     times in all parts.
+//
+
+int MuseDataSet::getTimeCount(void) {
+   if (!timeindexQ) {
+      buildTimeIndex();
+   }
+   return timelist.getSize();
+}
+
+
+
+//////////////////////////////
+//
+// MuseDataSet::getTime -- return the absolute time of the given
+//     time index.
+//
+
+RationalNumber MuseDataSet::getTime(int tindex) {
+   if (!timeindexQ) {
+      buildTimeIndex();
+   }
+   return timelist[tindex];
+}
+
+
+
+//////////////////////////////
+//
+// MuseDataSet::getTimeIndex -- return the time index of an event in
+//     the given part.
+//
+
+int MuseDataSet::getTimeIndex(int partindex, int eindex) {
+   if (!timeindexQ) {
+      buildTimeIndex();
+   }
+   return timeindex[partindex][eindex];
+}
+
+
+
+//////////////////////////////
+//
+// MuseDataSet::getEventIndex -- return the event index in the given
+//     part which occurs at the time index, or -1 if the part does not
+//     have an event at that time.
+//
+
+int MuseDataSet::getEventIndex(int tindex, int partindex) {
+   if (!timeindexQ) {
+      buildTimeIndex();
+   }
+   Array<int>& tlist = timeindex[partindex];
+   int low  = 0;
+   int high = tlist.getSize() - 1;
+   int mid;
+   while (low <= high) {
+      mid = (low + high) / 2;
+      if (tlist[mid] == tindex) {
+         return mid;
+      } else if (tlist[mid] < tindex) {
+         low = mid + 1;
+      } else {
+         high = mid - 1;
+      }
+   }
+   return -1;
+}
+
+
+
+//////////////////////////////
+//
+// MuseDataSet::buildTimeIndex -- Merge the time-sorted event lists of
+//     all parts into one list of unique times, and store the time index
+//     of each event in each part.
+//
+
+void MuseDataSet::buildTimeIndex(void) {
+   int pcount = part.getSize();
+   int i, p;
+   int total = 0;
+
+   Array<int> position;
+   position.setSize(pcount);
+   position.setAll(0);
+   timeindex.setSize(pcount);
+   for (p=0; p<pcount; p++) {
+      timeindex[p].setSize(part[p]->getEventCount());
+      total += part[p]->getEventCount();
+   }
+   timelist.setSize(total);
+   timelist.setSize(0);
+
+   RationalNumber mintime;
+   RationalNumber etime;
+   int foundQ;
+   while (1) {
+      foundQ = 0;
+      for (p=0; p<pcount; p++) {
+         if (position[p] >= part[p]->getEventCount()) {
+            continue;
+         }
+         etime = part[p]->getEvent(position[p]).getTime();
+         if (!foundQ || (etime < mintime)) {
+            mintime = etime;
+            foundQ = 1;
+         }
+      }
+      if (!foundQ) {
+         break;
+      }
+      i = timelist.getSize();
+      timelist.append(mintime);
+      for (p=0; p<pcount; p++) {
+         if ((position[p] < part[p]->getEventCount()) &&
+               (part[p]->getEvent(position[p]).getTime() == mintime)) {
+            timeindex[p][position[p]++] = i;
+         }
+      }
+   }
+
+   timeindexQ = 1;
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////
 
 //////////////////////////////
@@ -4,6 +4,7 @@
 // Creation Date: Tue Jun 30 22:41:24 PDT 1998
 // Last Modified: Sat Dec 25 11:50:24 PST 2010 added more functions
 // Last Modified: Wed Oct 12 23:06:08 PDT 2011 fixed prob in setNoteheadShape
+// Last Modified: Sun Oct 18 22:47:20 PDT 2026 decode durations from columns
 // Filename:      ...sig/src/sigInfo/MuseRecord.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/MuseRecord.cpp
 // Syntax:        C++ 
@@ -470,9 +471,8 @@ int MuseRecord::getLineTickDuration(void) {
       return 0;
    }
 
-   char recordInfo[16];
-   getTickDuration(recordInfo);
-   int value = atoi(recordInfo);
+   int digitQ;
+   int value = decodeTickDuration(digitQ);
    if (getType() == E_muserec_backspace) {
       return -value;
    }
@@ -491,9 +491,8 @@ int MuseRecord::getTicks(void) {
 //
 
 int MuseRecord::getNoteTickDuration(void) {
-   char recordInfo[16];
-   getTickDuration(recordInfo);
-   int value = atoi(recordInfo);
+   int digitQ;
+   int value = decodeTickDuration(digitQ);
    if (getType() == E_muserec_backspace) {
       return -value;
    }
@@ -502,6 +501,61 @@ int MuseRecord::getNoteTickDuration(void) {
 
 
 
+//////////////////////////////
+//
+// MuseRecord::tickDurationQ -- returns true if the duration field
+//    (columns 6-9) contains any digits.  Secondary chord notes without
+//    a duration take the duration of the primary chord note.
+//
+
+int MuseRecord::tickDurationQ(void) {
+   int digitQ;
+   decodeTickDuration(digitQ);
+   return digitQ;
+}
+
+
+
+//////////////////////////////
+//
+// MuseRecord::decodeTickDuration -- read the tick value in columns 6-9
+//    directly from the record, for the record types which have a
+//    duration field (returning 0 for other types).  This is the same
+//    value as atoi() of the string from getTickDuration().  The digitQ
+//    parameter is set to true if the field contains any digits.
+//
+
+int MuseRecord::decodeTickDuration(int& digitQ) {
+   digitQ = 0;
+   switch (getType()) {
+      case E_muserec_figured_harmony:
+      case E_muserec_note_regular:
+      case E_muserec_note_chord:
+      case E_muserec_rest:
+      case E_muserec_backward:
+      case E_muserec_forward:
+         break;
+      default:
+         return 0;
+   }
+
+   char field[5];
+   const char* line = recordString.getBase();
+   int length = getLength();
+   int i;
+   for (i=0; i<4; i++) {
+      field[i] = (i + 6 <= length) ? line[i + 5] : ' ';
+      if (std::isdigit(field[i])) {
+         digitQ = 1;
+      }
+   }
+   field[4] = '\0';
+
+   return digitQ ? atoi(field) : 0;
+}
+
+
+
 //////////////////////////////
 //
 // MuseRecord::setDots -- Only one or two dots allowed
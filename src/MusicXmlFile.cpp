@@ -39,6 +39,10 @@
 //                figure out how beaming is indicated with chords.
 //                fix dynamic spine syntax when dynamic comes between notes
 //                fix assemble code so that grace notes are aligned correctly
+//                streaming import which keeps only the current measure of
+//                   each part in memory.  The part items store pointers
+//                   into the CXMLObject tree, which is read in whole and
+//                   kept until createHumdrumFile() is finished.
 //
 // Done:
 //                lyrics (convert to spines to right of music spine)
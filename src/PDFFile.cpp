@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue May 11 21:51:09 PDT 2010
 // Last Modified: Tue May 11 21:51:24 PDT 2010
+// Last Modified: Sun Oct 18 23:06:45 PDT 2026 (bulk stream reads, FlateDecode)
 // Filename:      ...sig/src/sigInfo/PDFFile.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/PDFFile.cpp
 // Syntax:        C++ 
@@ -14,6 +15,8 @@
 #include "PDFFile.h"
 #include "PerlRegularExpression.h"
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #ifndef OLDCPP
    #include <fstream>
@@ -231,18 +234,6 @@ int PDFFile::isEmbeddedHumdrumFile(int index) {
 //
 
 void PDFFile::getEmbeddedFileContents(int embedindex, Array<char>& out) {
-   SSTREAM tempstream;
-   getEmbeddedFileContents(embedindex, tempstream);
-   out.setSize(tempstream.str().length()+1);
-   int i;
-   for (i=0; i<out.getSize()-1; i++) {
-      out.getBase()[i] = tempstream.str()[i];
-   }
-   out[out.getSize()-1] = '\0';
-}
-
-
-void PDFFile::getEmbeddedFileContents(int embedindex, ostream& out) {
    int fileheaderindex = getEmbeddedFileObject(embedindex);
    Array<char> fileheaderdict;
    getObjectDictionary(fileheaderindex, fileheaderdict);
@@ -252,22 +243,50 @@ void PDFFile::getEmbeddedFileContents(int embedindex, ostream& out) {
          "/EF\\s*<<[^>]*/F\\s+(\\d+)\\s+(\\d+)\\s+R", "m")) {
       streamobject = atol(pre.getSubmatch(1));
       getStreamData(streamobject, out);
+   } else {
+      out.setSize(1);
+      out[0] = '\0';
    }
 }
 
 
+void PDFFile::getEmbeddedFileContents(int embedindex, ostream& out) {
+   Array<char> contents;
+   getEmbeddedFileContents(embedindex, contents);
+   out.write(contents.getBase(), contents.getSize()-1);
+}
+
+
 
 //////////////////////////////
 //
-// PDFFile::getStreamData --
+// PDFFile::getStreamData -- Read the contents of a stream object with
+//    a single read from the file, using the /Length entry of the
+//    stream's dictionary (which may be an indirect object).  Streams
+//    compressed with the FlateDecode filter are decompressed; other
+//    filters are not removed.  The Array version adds a null character
+//    after the data (which is not counted as part of the data).
 //
 
 void PDFFile::getStreamData(int streamobject, ostream& out) {
+   Array<char> data;
+   getStreamData(streamobject, data);
+   out.write(data.getBase(), data.getSize()-1);
+}
+
+
+void PDFFile::getStreamData(int streamobject, Array<char>& out) {
+   out.setSize(1);
+   out[0] = '\0';
+
    Array<char> dictionary;
    int dictend = getObjectDictionary(streamobject, dictionary);
    PerlRegularExpression pre;
    int ssize = -1;
-   if (pre.search(dictionary.getBase(), "/Length\\s+(\\d+)", "m")) {
+   if (pre.search(dictionary.getBase(), 
+         "/Length\\s+(\\d+)\\s+(\\d+)\\s+R", "m")) {
+      ssize = getIntegerObject(atol(pre.getSubmatch(1)));
+   } else if (pre.search(dictionary.getBase(), "/Length\\s+(\\d+)", "m")) {
       ssize = atol(pre.getSubmatch(1));
    }
 
@@ -316,14 +335,62 @@ void PDFFile::getStreamData(int streamobject, ostream& out) {
       file.get(ch);
    }
 
-   int i;
-   for (i=0; i<ssize; i++) {
-      file.get(ch);
-      if (file.eof()) {
-         break;
-      }
-      out << ch;
+   Array<char> data;
+   data.setSize(ssize + 1);
+   file.read(data.getBase(), ssize);
+   int count = (int)file.gcount();
+   if (file.eof()) {
+      file.clear();
    }
+
+   if (strstr(dictionary.getBase(), "/FlateDecode") == NULL) {
+      data.setSize(count + 1);
+      data[count] = '\0';
+      out = data;
+      return;
+   }
+
+   if (!flateDecode(out, data.getBase(), count)) {
+      cerr << "ERROR: could not decompress stream in object " 
+           << streamobject << endl;
+      exit(1);
+   }
+   out.setSize(out.getSize() + 1);
+   out[out.getSize() - 1] = '\0';
+}
+
+
+
+//////////////////////////////
+//
+// PDFFile::getIntegerObject -- return the value of an indirect object
+//    which is an integer (such as the /Length of a stream).  Returns -1
+//    if the object is not an integer.
+//
+
+int PDFFile::getIntegerObject(int objectindex) {
+   if ((objectindex < 0) || (objectindex >= getObjectCount())) {
+      return -1;
+   }
+   int offset = getObjectOffset(objectindex);
+   if (offset < 0) {
+      return -1;
+   }
+
+   istream& file = *pdfdatastream;
+   char buffer[128] = {0};
+   file.seekg(offset, ios::beg);
+   file.read(buffer, 127);
+   buffer[file.gcount()] = '\0';
+   if (file.eof()) {
+      file.clear();
+   }
+
+   int number, version, value;
+   if (sscanf(buffer, "%d %d obj %d", &number, &version, &value) != 3) {
+      return -1;
+   }
+   return value;
 }
 
 
@@ -1179,4 +1246,393 @@ void PDFFile::makeEmbeddedFileList(void) {
 
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// FlateDecode (zlib/deflate, RFC 1950/1951) decompression of streams.
+//
+
+// current state of the decompression:
+typedef struct {
+   const unsigned char* input;     // compressed data
+   int                  insize;    // number of bytes in input
+   int                  inpos;     // index of next byte to read
+   unsigned int         bitbuf;    // bits read but not yet used
+   int                  bitcount;  // number of bits in bitbuf
+   Array<char>*         output;    // decompressed data
+   int                  outpos;    // number of bytes decompressed
+   int                  errorQ;    // true if ran out of input
+} _InflateState;
+
+// canonical Huffman code: the number of codes of each length, and
+// the symbols sorted by code:
+typedef struct {
+   short count[16];
+   short symbol[288];
+} _InflateHuffman;
+
+static const short inflateLengthBase[29] = {
+   3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+   35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const short inflateLengthExtra[29] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+   3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const short inflateDistanceBase[30] = {
+   1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+   257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+   8193, 12289, 16385, 24577 };
+static const short inflateDistanceExtra[30] = {
+   0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+   7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+
+//////////////////////////////
+//
+// inflateBits -- read the given number of bits from the input (least
+//    significant bit first).
+//
+
+static int inflateBits(_InflateState& s, int need) {
+   while (s.bitcount < need) {
+      if (s.inpos >= s.insize) {
+         s.errorQ = 1;
+         return 0;
+      }
+      s.bitbuf |= (unsigned int)s.input[s.inpos++] << s.bitcount;
+      s.bitcount += 8;
+   }
+   int value = (int)(s.bitbuf & ((1u << need) - 1));
+   s.bitbuf >>= need;
+   s.bitcount -= need;
+   return value;
+}
+
+
+
+//////////////////////////////
+//
+// inflateReserve -- make room for count more bytes in the output.
+//
+
+static char* inflateReserve(_InflateState& s, int count) {
+   Array<char>& out = *s.output;
+   if (s.outpos + count > out.getSize()) {
+      int newsize = out.getSize() * 2;
+      if (newsize < s.outpos + count) {
+         newsize = s.outpos + count;
+      }
+      out.setSize(newsize);
+   }
+   return out.getBase() + s.outpos;
+}
+
+
+
+//////////////////////////////
+//
+// inflateConstruct -- build a Huffman code from a list of code lengths.
+//    Returns a negative value if the code is over-subscribed.
+//
+
+static int inflateConstruct(_InflateHuffman& h, const short* length, int n) {
+   int symbol;
+   int len;
+   short offs[16];
+
+   for (len=0; len<16; len++) {
+      h.count[len] = 0;
+   }
+   for (symbol=0; symbol<n; symbol++) {
+      h.count[length[symbol]]++;
+   }
+   if (h.count[0] == n) {
+      return 0;
+   }
+
+   int left = 1;
+   for (len=1; len<16; len++) {
+      left <<= 1;
+      left -= h.count[len];
+      if (left < 0) {
+         return left;
+      }
+   }
+
+   offs[1] = 0;
+   for (len=1; len<15; len++) {
+      offs[len+1] = offs[len] + h.count[len];
+   }
+   for (symbol=0; symbol<n; symbol++) {
+      if (length[symbol] != 0) {
+         h.symbol[offs[length[symbol]]++] = symbol;
+      }
+   }
+   return left;
+}
+
+
+
+//////////////////////////////
+//
+// inflateDecode -- read one symbol from the input using a Huffman code.
+//    Returns -1 on an error.
+//
+
+static int inflateDecode(_InflateState& s, const _InflateHuffman& h) {
+   int code  = 0;   // bits read so far
+   int first = 0;   // first code of the current length
+   int index = 0;   // index of the first code of the current length
+   int count;
+   int len;
+   for (len=1; len<16; len++) {
+      code |= inflateBits(s, 1);
+      if (s.errorQ) {
+         return -1;
+      }
+      count = h.count[len];
+      if (code - count < first) {
+         return h.symbol[index + (code - first)];
+      }
+      index += count;
+      first += count;
+      first <<= 1;
+      code  <<= 1;
+   }
+   return -1;
+}
+
+
+
+//////////////////////////////
+//
+// inflateStored -- copy an uncompressed block to the output.
+//
+
+static int inflateStored(_InflateState& s) {
+   s.bitbuf = 0;
+   s.bitcount = 0;
+   if (s.inpos + 4 > s.insize) {
+      return 0;
+   }
+   int len  = s.input[s.inpos] | (s.input[s.inpos+1] << 8);
+   int nlen = s.input[s.inpos+2] | (s.input[s.inpos+3] << 8);
+   s.inpos += 4;
+   if ((len != (~nlen & 0xffff)) || (s.inpos + len > s.insize)) {
+      return 0;
+   }
+   memcpy(inflateReserve(s, len), s.input + s.inpos, len);
+   s.inpos  += len;
+   s.outpos += len;
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// inflateCodes -- decode the data of a compressed block.
+//
+
+static int inflateCodes(_InflateState& s, const _InflateHuffman& lencode,
+      const _InflateHuffman& distcode) {
+   int symbol;
+   int len;
+   int dist;
+   char* out;
+   const char* from;
+   int i;
+   while (1) {
+      symbol = inflateDecode(s, lencode);
+      if (symbol < 0) {
+         return 0;
+      }
+      if (symbol < 256) {
+         *inflateReserve(s, 1) = (char)symbol;
+         s.outpos++;
+         continue;
+      }
+      if (symbol == 256) {
+         return 1;
+      }
+      symbol -= 257;
+      if (symbol >= 29) {
+         return 0;
+      }
+      len = inflateLengthBase[symbol] + 
+            inflateBits(s, inflateLengthExtra[symbol]);
+      symbol = inflateDecode(s, distcode);
+      if ((symbol < 0) || (symbol >= 30)) {
+         return 0;
+      }
+      dist = inflateDistanceBase[symbol] + 
+             inflateBits(s, inflateDistanceExtra[symbol]);
+      if (s.errorQ || (dist > s.outpos)) {
+         return 0;
+      }
+      // copy byte by byte since the source may overlap the destination:
+      out  = inflateReserve(s, len);
+      from = out - dist;
+      for (i=0; i<len; i++) {
+         out[i] = from[i];
+      }
+      s.outpos += len;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// inflateFixed -- decode a block compressed with the fixed Huffman codes.
+//
+
+static int inflateFixed(_InflateState& s) {
+   _InflateHuffman lencode;
+   _InflateHuffman distcode;
+   short lengths[288];
+   int i;
+   for (i=0; i<144; i++) { lengths[i] = 8; }
+   for (   ; i<256; i++) { lengths[i] = 9; }
+   for (   ; i<280; i++) { lengths[i] = 7; }
+   for (   ; i<288; i++) { lengths[i] = 8; }
+   inflateConstruct(lencode, lengths, 288);
+   for (i=0; i<30; i++) {
+      lengths[i] = 5;
+   }
+   inflateConstruct(distcode, lengths, 30);
+   return inflateCodes(s, lencode, distcode);
+}
+
+
+
+//////////////////////////////
+//
+// inflateDynamic -- decode a block compressed with Huffman codes which
+//    are stored at the start of the block.
+//
+
+static int inflateDynamic(_InflateState& s) {
+   static const short order[19] = 
+         {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+   short lengths[320];
+   _InflateHuffman lencode;
+   _InflateHuffman distcode;
+   int index;
+   int symbol;
+   int len;
+
+   int nlen  = inflateBits(s, 5) + 257;
+   int ndist = inflateBits(s, 5) + 1;
+   int ncode = inflateBits(s, 4) + 4;
+   if (s.errorQ || (nlen > 286) || (ndist > 30)) {
+      return 0;
+   }
+
+   for (index=0; index<ncode; index++) {
+      lengths[order[index]] = inflateBits(s, 3);
+   }
+   for ( ; index<19; index++) {
+      lengths[order[index]] = 0;
+   }
+   if (s.errorQ || (inflateConstruct(lencode, lengths, 19) != 0)) {
+      return 0;
+   }
+
+   index = 0;
+   while (index < nlen + ndist) {
+      symbol = inflateDecode(s, lencode);
+      if (symbol < 0) {
+         return 0;
+      }
+      if (symbol < 16) {
+         lengths[index++] = symbol;
+         continue;
+      }
+      len = 0;
+      if (symbol == 16) {
+         if (index == 0) {
+            return 0;
+         }
+         len = lengths[index - 1];
+         symbol = 3 + inflateBits(s, 2);
+      } else if (symbol == 17) {
+         symbol = 3 + inflateBits(s, 3);
+      } else {
+         symbol = 11 + inflateBits(s, 7);
+      }
+      if (s.errorQ || (index + symbol > nlen + ndist)) {
+         return 0;
+      }
+      while (symbol--) {
+         lengths[index++] = len;
+      }
+   }
+
+   if (lengths[256] == 0) {
+      // no end-of-block code
+      return 0;
+   }
+   if (inflateConstruct(lencode, lengths, nlen) < 0) {
+      return 0;
+   }
+   if (inflateConstruct(distcode, lengths + nlen, ndist) < 0) {
+      return 0;
+   }
+   return inflateCodes(s, lencode, distcode);
+}
+
+
+
+//////////////////////////////
+//
+// PDFFile::flateDecode -- decompress data compressed with the FlateDecode
+//    filter (a zlib stream, or raw deflate data without the zlib
+//    header).  Returns false if the data could not be decompressed, in
+//    which case output contains the data decompressed before the error.
+//    The Adler-32 checksum at the end of the data is not verified.
+//
+
+int PDFFile::flateDecode(Array<char>& output, const char* data, int size) {
+   _InflateState s;
+   s.input    = (const unsigned char*)data;
+   s.insize   = size;
+   s.inpos    = 0;
+   s.bitbuf   = 0;
+   s.bitcount = 0;
+   s.output   = &output;
+   s.outpos   = 0;
+   s.errorQ   = 0;
+
+   output.setSize(size * 4 + 1024);
+
+   if ((size >= 2) && ((s.input[0] & 0x0f) == 8) &&
+         (((s.input[0] << 8) | s.input[1]) % 31 == 0)) {
+      // skip zlib header (and preset dictionary id, which is not used
+      // in PDF files).
+      s.inpos = (s.input[1] & 0x20) ? 6 : 2;
+   }
+
+   int lastQ = 0;
+   int type;
+   int status = 1;
+   while (status && !lastQ) {
+      lastQ = inflateBits(s, 1);
+      type  = inflateBits(s, 2);
+      if (s.errorQ) {
+         status = 0;
+         break;
+      }
+      switch (type) {
+         case 0:  status = inflateStored(s);  break;
+         case 1:  status = inflateFixed(s);   break;
+         case 2:  status = inflateDynamic(s); break;
+         default: status = 0;
+      }
+   }
+
+   output.setSize(s.outpos);
+   return status;
+}
+
+
+
 // md5sum: 3997e8805220a29acf9afd717bf8dd20 PDFFile.cpp [20001204]
@@ -1,6 +1,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun 29 14:25:53 PDT 2009
 // Last Modified: Mon Jun 29 14:26:01 PDT 2009
+// Last Modified: Sun Oct 18 12:31:44 PDT 2026 Added compiled pattern cache
 // Filename:      ...sig/src/sig/PerlRegularExpression.cpp
 // Web Address:   http://sig.sapp.org/src/sig/PerlRegularExpression.cpp
 // Syntax:        C++; Perl Compatible Regular Expressions (http://www.pcre.org)
@@ -164,12 +165,18 @@
 #include <sstream>
 #include <vector>
 #include <string>
+#include <map>
+#include <mutex>
 
 #include "PerlRegularExpression.h"
 #include "Array.h"
 
 using namespace std;
 
+// Maximum number of compiled patterns to keep in the process-wide cache.
+// Patterns after this limit are compiled separately for each object.
+#define PCRE_CACHE_LIMIT 2000
+
 
 //////////////////////////////
 //
@@ -183,6 +190,7 @@ PerlRegularExpression::PerlRegularExpression(void) {
    ignorecaseQ = 0;
    studyQ      = 0;
    anchorQ     = 0;
+   cachedQ     = 0;
 
    output_substrings.setSize(3 * 100);  // has to be a multiple of 3
    output_substrings.setAll(0);
@@ -211,11 +219,7 @@ PerlRegularExpression::PerlRegularExpression(void) {
 //
 
 PerlRegularExpression::~PerlRegularExpression() {
-   if (pre != NULL) {
-      pcre_free(pre);
-      pre = NULL;
-   }
-	 
+   releasePattern();
 }
 
 
@@ -453,9 +457,14 @@ void PerlRegularExpression::initializeSearch(void) {
       compflags |= PCRE_ANCHORED;
    }
 
-   if (pre != NULL) {
-      pcre_free(pre);
-      pre = NULL;
+   releasePattern();
+
+   if (getCachedPattern(search_string.getBase(), compflags, pre, pe)) {
+      // Compiled and studied pattern shared with other objects.
+      cachedQ = 1;
+      valid = 1;
+      studyQ = 1;
+      return;
    }
 
    pre = pcre_compile(search_string.getBase(), compflags, &compile_error,
@@ -481,6 +490,82 @@ void PerlRegularExpression::initializeSearch(void) {
 
 
 
+//////////////////////////////
+//
+// PerlRegularExpression::releasePattern -- free the compiled pattern
+//    unless it belongs to the pattern cache.
+//
+
+void PerlRegularExpression::releasePattern(void) {
+   if (!cachedQ) {
+      if (pe != NULL) {
+         pcre_free_study(pe);
+      }
+      if (pre != NULL) {
+         pcre_free(pre);
+      }
+   }
+   pre = NULL;
+   pe = NULL;
+   cachedQ = 0;
+   studyQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerlRegularExpression::getCachedPattern -- return a compiled and
+//    studied version of the search string, compiling it on the first
+//    request.  The cache is shared by all threads and the patterns
+//    in it are never freed.  Compiled patterns are only read by
+//    pcre_exec(), so they can be used by several threads at once.
+//    Returns false if the pattern is not in the cache and could not
+//    be added (either the cache is full or the pattern is invalid).
+//
+
+int PerlRegularExpression::getCachedPattern(const char* searchstring,
+      int flags, pcre*& code, pcre_extra*& study) {
+   static map<string, pair<pcre*, pcre_extra*> > cache;
+   static mutex cachelock;
+
+   string key;
+   key.reserve(strlen(searchstring) + 16);
+   key += to_string(flags);
+   key += ':';
+   key += searchstring;
+
+   lock_guard<mutex> guard(cachelock);
+   auto it = cache.find(key);
+   if (it != cache.end()) {
+      code  = it->second.first;
+      study = it->second.second;
+      return 1;
+   }
+
+   if ((int)cache.size() >= PCRE_CACHE_LIMIT) {
+      return 0;
+   }
+
+   const char* error = NULL;
+   int offset = 0;
+   pcre* newcode = pcre_compile(searchstring, flags, &error, &offset, NULL);
+   if (newcode == NULL) {
+      // let the caller report the error
+      return 0;
+   }
+   pcre_extra* newstudy = pcre_study(newcode, 0, &error);
+   if (error != NULL) {
+      newstudy = NULL;
+   }
+   cache[key] = make_pair(newcode, newstudy);
+   code  = newcode;
+   study = newstudy;
+   return 1;
+}
+
+
+
 //////////////////////////////
 //
 // PerlRegularExpression::initializeSearchAndStudy --
@@ -538,7 +623,7 @@ void PerlRegularExpression::studySearch() {
    if (studyQ == 0) {
       const char* statusMessage = "";
       studyQ = 1;
-      // how should any old structure that pe points to be disposed?
+      // any old study data is freed in releasePattern()
       pe = pcre_study(pre, 0, &statusMessage);
       if (statusMessage != NULL) {
          cerr << "WARNING: problem studying regular expression: " << endl;
@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Wed May 19 21:10:47 PDT 2010
 // Last Modified: Wed May 19 21:10:51 PDT 2010
+// Last Modified: Sun Oct 18 16:20:05 PDT 2026 64-bit storage, binary gcd
 // Filename:      ...sig/maint/code/base/RationalNumber/RationalNumber.cpp
 // Web Address:   http://sig.sapp.org/src/sigBase/RationalNumber.cpp
 // Syntax:        C++ 
@@ -14,6 +15,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 //////////////////////////////
 //
@@ -21,14 +23,16 @@
 //     default values: _a = 0, _b = 1
 //
 
-RationalNumber::RationalNumber(int _a, int _b) {
+RationalNumber::RationalNumber(long long _a, long long _b) {
    _num = _a;
    _den = _b;
    if (_den == 0) {
       _error_msg("denominator can't be zero.");
       assert(_den != 0);
    }
-   simplify(*this);
+   if (_den != 1) {
+      simplify(*this);
+   }
 }
 
 
@@ -38,7 +42,7 @@ RationalNumber::RationalNumber(int _a, int _b) {
 // RationalNumber::operator= --
 //
 
-RationalNumber RationalNumber::operator=(const RationalNumber &r) {
+RationalNumber& RationalNumber::operator=(const RationalNumber &r) {
    this->_num = r._num;
    this->_den = r._den;
    return *this;
@@ -72,7 +76,9 @@ RationalNumber RationalNumber::operator-(void) const {
 
 //////////////////////////////
 //
-// RationalNumber::operator+ --
+// RationalNumber::operator+ -- Numbers with the same denominator or
+//     with an integer value are added without finding the least common
+//     multiple of the denominators.
 //
 
 RationalNumber RationalNumber::operator+(const RationalNumber &r) const {
@@ -84,13 +90,31 @@ RationalNumber RationalNumber::operator+(const RationalNumber &r) const {
    }
 
    RationalNumber temp;
-   int lcm_val = lcm( this->_den, r._den );
-   int a = this->_num * ( lcm_val / this->_den );
-   int c = r._num * ( lcm_val / r._den );
-   // int b = lcm_val; 
-   // int d = b;
-   temp._num = a + c;
-   temp._den = lcm_val;
+   if (this->_den == r._den) {
+      temp._num = add(this->_num, r._num);
+      temp._den = this->_den;
+      if (temp._den != 1) {
+         simplify(temp);
+      }
+      return temp;
+   }
+   if (r._den == 1) {
+      // a/b + c = (a + c*b)/b which has no common factors
+      temp._num = add(this->_num, multiply(r._num, this->_den));
+      temp._den = this->_den;
+      return temp;
+   }
+   if (this->_den == 1) {
+      temp._num = add(multiply(this->_num, r._den), r._num);
+      temp._den = r._den;
+      return temp;
+   }
+
+   long long gcd_val = gcd(this->_den, r._den);
+   long long a = multiply(this->_num, r._den / gcd_val);
+   long long c = multiply(r._num, this->_den / gcd_val);
+   temp._num = add(a, c);
+   temp._den = multiply(this->_den, r._den / gcd_val);
    simplify(temp);
    return temp;
 }
@@ -126,19 +150,23 @@ RationalNumber RationalNumber::operator*(const RationalNumber &r) const {
       return temp;
    }
 
-
-   int a = this->_num;
-   int b = this->_den;
-   int c = r._num;
-   int d = r._den;
-   int gcd_val = gcd( a, d );
-   int gcd_val2 = gcd( b, c );
+   long long a = this->_num;
+   long long b = this->_den;
+   long long c = r._num;
+   long long d = r._den;
+   if ((b == 1) && (d == 1)) {
+      temp._num = multiply(a, c);
+      temp._den = 1;
+      return temp;
+   }
+   long long gcd_val = gcd( a, d );
+   long long gcd_val2 = gcd( b, c );
    a /= gcd_val;
    d /= gcd_val;
    b /= gcd_val2;
    c /= gcd_val2;
-   temp._num = a * c;
-   temp._den = b * d;
+   temp._num = multiply(a, c);
+   temp._den = multiply(b, d);
    return temp;
 }
 
@@ -151,19 +179,6 @@ RationalNumber RationalNumber::operator*(const RationalNumber &r) const {
 
 RationalNumber RationalNumber::operator/(const RationalNumber &r) const {
    RationalNumber temp;
-   /*int a = this->_num;
-   int b = this->_den;
-   int c = r._num;
-   int d = r._den;
-   int gcd_val = gcd( a, c );
-   int gcd_val2 = gcd( b, d );
-   a /= gcd_val;
-   c /= gcd_val;
-   b /= gcd_val2;
-   d /= gcd_val2;
-   temp._num = a * d;
-   temp._den = b * c;
-   simplify(temp);*/
    temp._num = r._den;
    temp._den = r._num;
    temp *= *this;
@@ -177,7 +192,7 @@ RationalNumber RationalNumber::operator/(const RationalNumber &r) const {
 // RationalNumber::operator+= --
 //
 
-RationalNumber RationalNumber::operator+=(const RationalNumber &r) {
+RationalNumber& RationalNumber::operator+=(const RationalNumber &r) {
    *this = *this + r;
    return *this;
 }
@@ -189,7 +204,7 @@ RationalNumber RationalNumber::operator+=(const RationalNumber &r) {
 // RationalNumber::operator-= --
 //
 
-RationalNumber RationalNumber::operator-=(const RationalNumber &r) {
+RationalNumber& RationalNumber::operator-=(const RationalNumber &r) {
    *this = *this - r;
    return *this;
 }
@@ -201,7 +216,7 @@ RationalNumber RationalNumber::operator-=(const RationalNumber &r) {
 // RationalNumber::operator*= --
 //
 
-RationalNumber RationalNumber::operator*=(const RationalNumber &r) {
+RationalNumber& RationalNumber::operator*=(const RationalNumber &r) {
    *this = *this * r;
    return *this;
 }
@@ -213,7 +228,7 @@ RationalNumber RationalNumber::operator*=(const RationalNumber &r) {
 // RationalNumber::operator/= --
 //
 
-RationalNumber RationalNumber::operator/=(const RationalNumber &r) {
+RationalNumber& RationalNumber::operator/=(const RationalNumber &r) {
    *this = *this / r;
    return *this;
 }
@@ -295,7 +310,7 @@ int RationalNumber::operator ==(const RationalNumber &r) const {
 // RationalNumber::isEqualTo -- dual integer version of operator==
 //
 
-int RationalNumber::isEqualTo(int top, int bot) const {
+int RationalNumber::isEqualTo(long long top, long long bot) const {
    if (this->getNumerator() == top) {
       if (this->getDenominator() == bot) {
          return 1;
@@ -312,7 +327,7 @@ int RationalNumber::isEqualTo(int top, int bot) const {
 //
 
 int RationalNumber::operator!=(const RationalNumber &r) const {
-   return ((this->_num != r._num) || (this->_den != r._den));
+   return !(*this == r);
 }
 
 
@@ -323,7 +338,7 @@ int RationalNumber::operator!=(const RationalNumber &r) const {
 //
 
 int RationalNumber::operator>(const RationalNumber &r) const {
-   return this->getFloat() > r.getFloat();
+   return compare(*this, r) > 0;
 }
 
 
@@ -334,7 +349,7 @@ int RationalNumber::operator>(const RationalNumber &r) const {
 //
 
 int RationalNumber::operator<(const RationalNumber &r) const {
-   return this->getFloat() < r.getFloat();
+   return compare(*this, r) < 0;
 }
 
 
@@ -345,18 +360,54 @@ int RationalNumber::operator<(const RationalNumber &r) const {
 //
 
 int RationalNumber::operator>=(const RationalNumber &r) const {
-   return this->getFloat() >= r.getFloat();
+   return compare(*this, r) >= 0;
 }
 
 
 
 //////////////////////////////
 //
-// RationalNumber::operator<= -- ???
+// RationalNumber::operator<= --
 //
 
 int RationalNumber::operator<=(const RationalNumber &r) const {
-   return this->getFloat() <= r.getFloat();
+   return compare(*this, r) <= 0;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber::compare -- returns -1 if p < q, 0 if p == q, and +1
+//     if p > q.  The numbers are compared exactly by cross multiplication
+//     unless the products would overflow, in which case the floating-point
+//     values are compared.  (static function)
+//
+
+int RationalNumber::compare(const RationalNumber &p, const RationalNumber &q) {
+   if (p._den == q._den) {
+      return (p._num < q._num) ? -1 : ((p._num > q._num) ? 1 : 0);
+   }
+   long long gcd_val = gcd(p._den, q._den);
+   long long pd = q._den / gcd_val;
+   long long qd = p._den / gcd_val;
+   long long a, b;
+   if ((pd != 0) && (qd != 0) &&
+         (llabs(p._num) <= LLONG_MAX / llabs(pd)) &&
+         (llabs(q._num) <= LLONG_MAX / llabs(qd))) {
+      a = p._num * pd;
+      b = q._num * qd;
+      if (p._den < 0) {
+         a = -a;
+      }
+      if (q._den < 0) {
+         b = -b;
+      }
+      return (a < b) ? -1 : ((a > b) ? 1 : 0);
+   }
+   long double x = (long double)p._num / p._den;
+   long double y = (long double)q._num / q._den;
+   return (x < y) ? -1 : ((x > y) ? 1 : 0);
 }
 
 
@@ -366,7 +417,7 @@ int RationalNumber::operator<=(const RationalNumber &r) const {
 // RationalNumber::setValue --
 //
 
-void RationalNumber::setValue(int num, int den) {
+void RationalNumber::setValue(long long num, long long den) {
    _num = num;
    _den = den;
    simplify(*this);
@@ -376,23 +427,41 @@ void RationalNumber::setValue(int num, int den) {
 
 //////////////////////////////
 //
-// RationalNumber::gcd -- Greatest common denominator. (static function)
+// RationalNumber::gcd -- Greatest common divisor, calculated with the 
+//     binary GCD algorithm.  Returns 1 if both values are zero.
+//     (static function)
 //
 
-int RationalNumber::gcd(int _x, int _y) {
-   int x = _x;
-   int y = _y;
-   if (x < 0) x = -x;
-   if (y < 0) y = -y;
-   if (_x > _y) swap(x, y);
-   int i;
-   for (i=x; i>1; i--) {
-      if (!(x%i) && !(y%i)) break;
+long long RationalNumber::gcd(long long _x, long long _y) {
+   unsigned long long x = (_x < 0) ? -(unsigned long long)_x : _x;
+   unsigned long long y = (_y < 0) ? -(unsigned long long)_y : _y;
+   if (x == 0) {
+      return (y == 0) ? 1 : (long long)y;
    }
-   if (i==0) {
-      i++;
+   if (y == 0) {
+      return (long long)x;
+   }
+   int shift = 0;
+   while (((x | y) & 1) == 0) {
+      x >>= 1;
+      y >>= 1;
+      shift++;
+   }
+   while ((x & 1) == 0) {
+      x >>= 1;
+   }
+   while (y != 0) {
+      while ((y & 1) == 0) {
+         y >>= 1;
+      }
+      if (x > y) {
+         unsigned long long t = x;
+         x = y;
+         y = t;
+      }
+      y -= x;
    }
-   return i;
+   return (long long)(x << shift);
 }
 
 
@@ -402,13 +471,50 @@ int RationalNumber::gcd(int _x, int _y) {
 // RationalNumber::lcm -- Least Common Multiple. (static function)
 //
 
-int RationalNumber::lcm(int _x, int _y) {
-   int gcd_val = gcd(_x, _y);
-   int prod = _x * _y;
+long long RationalNumber::lcm(long long _x, long long _y) {
+   long long gcd_val = gcd(_x, _y);
+   long long prod = multiply(_x / gcd_val, _y);
    if (prod < 0) {
       prod = -prod;
    }
-   return (prod / gcd_val);
+   return prod;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber::multiply -- Multiply two integers, giving an error
+//     if the result does not fit into 64 bits. (static function)
+//
+
+long long RationalNumber::multiply(long long _x, long long _y) {
+   if ((_x == 0) || (_y == 0)) {
+      return 0;
+   }
+   if ((_x == LLONG_MIN) || (_y == LLONG_MIN) ||
+         (llabs(_x) > LLONG_MAX / llabs(_y))) {
+      _error_msg("rational number overflow.");
+      assert(0);
+   }
+   return _x * _y;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber::add -- Add two integers, giving an error if the 
+//     result does not fit into 64 bits. (static function)
+//
+
+long long RationalNumber::add(long long _x, long long _y) {
+   if (((_y > 0) && (_x > LLONG_MAX - _y)) || 
+       ((_y < 0) && (_x < LLONG_MIN - _y))) {
+      _error_msg("rational number overflow.");
+      assert(0);
+   }
+   return _x + _y;
 }
 
 
@@ -420,7 +526,7 @@ int RationalNumber::lcm(int _x, int _y) {
 //
 
 void RationalNumber::simplify(RationalNumber &r) {
-   int gcd_val = gcd(r._num, r._den);
+   long long gcd_val = gcd(r._num, r._den);
    if (r._den < 0) {
       r._num = -r._num;
       r._den = -r._den;
@@ -488,8 +594,8 @@ RationalNumber RationalNumber::convert_to_fraction(char *strNum) {
    int i = 0;
    int isdecimal = false;
    char *str = strNum;
-   char *temp = new char[20];
-   while (*str) {
+   char temp[32];
+   while (*str && (i < (int)sizeof(temp) - 1)) {
       if (*str == '.') { 
          isdecimal = true; 
          pos = counter; 
@@ -501,13 +607,12 @@ RationalNumber RationalNumber::convert_to_fraction(char *strNum) {
    }
    temp[i] = 0;
    if (isdecimal) {
-      this->_num = atol(temp);
-      this->_den = (int)pow(10, counter - pos - 1 );
+      this->_num = atoll(temp);
+      this->_den = (long long)pow(10, counter - pos - 1 );
    } else {
-      this->_num = atol(temp);
+      this->_num = atoll(temp);
       this->_den = 1;
    }
-   delete[] temp;
    return *this;
 }
 
@@ -542,8 +647,8 @@ RationalNumber RationalNumber::getInversion(void) const {
 //
 
 void RationalNumber::invert(void) {
-   int top = getNumerator();
-   int bot = getDenominator();
+   long long top = getNumerator();
+   long long bot = getDenominator();
 
    if (top == 0) {
       return;
@@ -697,8 +802,8 @@ ostream& operator<<(ostream& out, RationalNumber p) {
 //
 
 ostream& RationalNumber::printTwoPart(ostream& out, const char* spacer) const {
-   int tnum = _num;
-   int tden = _den;
+   long long tnum = _num;
+   long long tden = _den;
    int sign = 1;
    if (tnum < 0) {
       tnum = -tnum;
@@ -714,7 +819,7 @@ ostream& RationalNumber::printTwoPart(ostream& out, const char* spacer) const {
       return out;
    }
 
-   int integ = tnum / tden;
+   long long integ = tnum / tden;
    tnum = tnum - tden * integ;
 
    if (sign < 0) {
@@ -766,8 +871,9 @@ ostream& RationalNumber::printRecip(ostream& out, const char* spacer) {
 //
 
 istream& operator>>(istream& input, RationalNumber &p ) {
-   char *buff = new char[20];
-   char *tmp  = new char[20];
+   char buff[20];
+   char tmp[20];
+   input.width(sizeof(buff));
    input >> buff;
    char *str = buff;
    int is_fraction = false;
@@ -804,8 +910,6 @@ istream& operator>>(istream& input, RationalNumber &p ) {
       Q.convert_to_fraction(tmp);
    }
    p = P/Q;
-   delete [] tmp; 
-	delete [] buff;
    return input;
 } 
 
@@ -7,6 +7,8 @@
 // Last Modified: Tue Mar 31 16:14:05 PST 2009 Updates for winscore version
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 Renamed SigCollection class
 // Last Modified: Sun Aug 26 00:55:11 PDT 2012 Renovated
+// Last Modified: Sun Oct 18 23:31:02 PDT 2026 Buffered binary reading/writing
+// Last Modified: Mon Oct 19 03:31:40 PDT 2026 Read 4-byte counters, trailer order
 // Filename:      ...sig/src/sigInfo/ScorePageBase.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/ScorePageBase.h
 // Syntax:        C++ 
@@ -18,6 +20,7 @@
 //
 
 #include "ScorePageBase.h"
+#include "MappedFile.h"
 
 #include <string.h>
 #include <math.h>
@@ -344,7 +347,8 @@ void ScorePageBase::readFile(const char* filename, int verboseQ) {
    testfile.seekg(0, ios::beg);
 
    if (binaryQ) {
-      readBinary(testfile, verboseQ);
+      testfile.close();
+      readBinary(filename, verboseQ);
    } else {
       readAscii(testfile, verboseQ);
    }
@@ -456,31 +460,19 @@ void ScorePageBase::readAsciiScoreLine(istream& infile, ScoreRecord& record,
 //////////////////////////////
 //
 // ScorePageBase::readBinary -- Read a single SCORE page in the binary
-//     data format.
+//     data format.  The file is memory-mapped and decoded with
+//     readBinaryMemory().
 //     default value: verboseQ = 0;
 //
 
 void ScorePageBase::readBinary(const char* filename, int verboseQ) {
-   #ifndef OLDCPP
-      #ifdef VISUAL
-         fstream infile(filename, ios::in | ios::binary);
-      #else
-         fstream infile(filename, ios::in);
-      #endif
-   #else
-      #ifdef VISUAL
-         fstream infile(filename, ios::in | ios::nocreate | ios::binary);
-      #else
-         fstream infile(filename, ios::in | ios::nocreate);
-      #endif
-   #endif
-
-   if (!infile.is_open()) {
+   MappedFile mapped;
+   if (!mapped.open(filename)) {
       cerr << "Error: cannot open file: " << filename << endl;
       exit(1);
    }
 
-   readBinary(infile, verboseQ);
+   readBinaryMemory(mapped.getData(), mapped.getSize(), verboseQ);
 }
 
 
@@ -488,30 +480,82 @@ void ScorePageBase::readBinary(const char* filename, int verboseQ) {
 //////////////////////////////
 //
 // ScorePageBase::readBinary --  Read a single SCORE page in the binary
-//      data format from an input stream.
+//      data format from an input stream.  The stream is read into a
+//      single buffer which is decoded with readBinaryMemory().
 //
 
 void ScorePageBase::readBinary(istream& infile, int verboseQ) {
+   infile.seekg(0, ios::end);
+   long size = (long)infile.tellg();
+   infile.seekg(0, ios::beg);
+   if (size < 0) {
+      size = 0;
+   }
+
+   Array<char> buffer;
+   buffer.setSize(size + 1);
+   infile.read(buffer.getBase(), size);
+   readBinaryMemory(buffer.getBase(), (long)infile.gcount(), verboseQ);
+}
+
+
+
+//////////////////////////////
+//
+// ScorePageBase::readBinaryMemory --  Read a single SCORE page in the 
+//      binary data format from a block of memory.  All 4-byte numbers
+//      after the initial count of numbers are decoded in a single pass into
+//      a parameter pool, and each item is then copied from its section of 
+//      the pool.  The count of numbers at the start of the data is either
+//      a 2-byte or (WinScore) 4-byte integer; the numbers after it are all
+//      4 bytes long, so the size of the data shows which one is used.
+//      default value: verboseQ = 0;
+//
+
+void ScorePageBase::readBinaryMemory(const char* bytes, long size, 
+      int verboseQ) {
    clear();
 
+   if (size < 10) {
+      cerr << "Error: binary SCORE data is too short: " << size 
+           << " bytes" << endl;
+      exit(1);
+   }
+
    // first read the count of 4-byte numbers/text chunks in the data file.
-   int numbercount = readLittleShort(infile);
+   int headersize = ((size - 2) % 4 == 0) ? 2 : 4;
+   int numbercount = 0;
+   int i;
+   for (i=headersize-1; i>=0; i--) {
+      numbercount = (numbercount << 8) | (unsigned char)bytes[i];
+   }
    int readcount = 0;   // number of numbers which have been read
    if (verboseQ) {
       cout << "#NUMBER COUNT OF FILE IS " << numbercount << endl;
    }
 
    // now read the count of numbers in the trailer
-   infile.seekg(-8, ios::end);
-   int trailerSize = (int)readLittleFloat(infile);
-
-   // go back to the start of the file, after the first number
-   infile.seekg(2, ios::beg);
-
+   float lastnumbers[2];
+   ScoreRecord::decodeLittleFloats(lastnumbers, bytes + size - 8, 2);
+   int trailerSize = (int)lastnumbers[0];
+
+   // decode all numbers after the first number.  Text in P1=16 items
+   // is stored in 4-byte chunks, so it does not interrupt the sequence
+   // of numbers.
+   int wordcount = (int)((size - headersize) / 4);
+   const char* words = bytes + headersize;
+   Array<float> pool;
+   pool.setSize(wordcount);
+   ScoreRecord::decodeLittleFloats(pool.getBase(), words, wordcount);
+
+   int index = 0;        // index of the next number in the pool
+   int pcount;
    double number = 0.0;
-   data.allowGrowth(1);
+   // each item contains at least two numbers:
+   data.setSize(wordcount / 2 + 1);
+   data.setSize(0);
    // now read each data number and store
-   while (!infile.eof()) {
+   while (index < wordcount) {
       if (numbercount - readcount - trailerSize - 1 == 0) {
          break;
       } else if (numbercount - readcount - trailerSize - 1< 0) {
@@ -520,9 +564,9 @@ void ScorePageBase::readBinary(istream& infile, int verboseQ) {
               << endl;
          exit(1);
       } else {
-         number = readLittleFloat(infile);
-         number = ScoreParameters::roundFractionDigits(number, 3);
+         number = ScoreParameters::roundFractionDigits(pool[index], 3);
          readcount++;
+         index++;
          if (verboseQ) {
             if (number - (int)number > 0.0) {
                cout << "# Error in number parameter count: " << number << endl;
@@ -530,8 +574,18 @@ void ScorePageBase::readBinary(istream& infile, int verboseQ) {
             }
          }
 
-         readcount += (int)number;
-         data[data.getSize()]->readBinary(infile, (int)number);
+         pcount = (int)number;
+         if (index + pcount > wordcount) {
+            cerr << "Error reading file: item with " << pcount 
+                 << " parameters extends past the end of the data" << endl;
+            exit(1);
+         }
+         readcount += pcount;
+         data.increase(1);
+         data.last() = new ScoreRecord;
+         data.last()->readBinary(pool.getBase() + index, 
+               words + index * 4, pcount);
+         index += pcount;
       }
    }
 
@@ -540,14 +594,26 @@ void ScorePageBase::readBinary(istream& infile, int verboseQ) {
       cout << "#READING Trailer: " << endl;
    }
 
-   while (number != -9999.0 && !infile.eof()) {
-      number = readLittleFloat(infile);
-      trailer.append(number);
+   // The trailer is stored backwards before its size and the end-of-file
+   // marker.  Keep it in the same order as initializeTrailer() so that it
+   // is written back unchanged.  Short trailers are padded with zeros.
+   int tcount = trailerSize - 1;
+   if ((tcount < 0) || (index + tcount + 2 > wordcount)) {
+      cerr << "Error reading file: invalid trailer size: " << trailerSize 
+           << endl;
+      exit(1);
+   }
+   trailer.setSize(tcount < 4 ? 4 : tcount);
+   trailer.setAll(0.0);
+   for (i=0; i<tcount; i++) {
+      trailer[tcount-1-i] = pool[index++];
       if (verboseQ) {
-         cout << "#TRAILER NUMBER: " << number << endl;
+         cout << "#TRAILER NUMBER: " << trailer[tcount-1-i] << endl;
       }
-      readcount++;
    }
+   // skip over the trailer size and the end-of-file marker
+   index += 2;
+   readcount += tcount + 2;
 
    if (readcount != numbercount) {
       cerr << "#Warning: expecting " << numbercount << " number in file "
@@ -557,43 +623,6 @@ void ScorePageBase::readBinary(istream& infile, int verboseQ) {
 
 
 
-//////////////////////////////
-//
-// ScorePageBase::readLittleShort -- read a short int in little endian form.
-//     Number is read as an unsigned short int.
-//
-
-int ScorePageBase::readLittleShort(istream& input) {
-   unsigned char byteinfo[2];
-   input.read((char*)byteinfo, 2);
-   int output = 0;
-   output = byteinfo[1];
-   output = (output << 8) | byteinfo[0];
-   return output;
-}
-
-
-
-//////////////////////////////
-//
-// ScorePageBase::readLittleFloat -- Read a 4-byte float in little-endian
-//      format.
-//
-
-float ScorePageBase::readLittleFloat(istream& instream) { 
-   unsigned char byteinfo[4];
-   instream.read((char*)byteinfo, 4);
-   union { float f; unsigned int i; } num;
-   num.i = 0;
-   num.i = byteinfo[3];
-   num.i = (num.i << 8) | byteinfo[2];
-   num.i = (num.i << 8) | byteinfo[1];
-   num.i = (num.i << 8) | byteinfo[0];
-   return num.f;
-}
-
-
-
 //////////////////////////////
 //
 // ScorePageBase::writeBinary --  Write SCORE data to a binary files.
@@ -629,66 +658,57 @@ void ScorePageBase::writeBinary(const char* filename) {
 //////////////////////////////
 //
 // ScorePageBase::writeBinary --  Write SCORE data to a binary output stream.
-//    This function should be changed to write out in the print order
-//    rather than the data order.
+//    The data is stored in a single buffer which is written with one call,
+//    so the output stream does not need to be seekable.  This function 
+//    should be changed to write out in the print order rather than the 
+//    data order.
 //
 
 ostream& ScorePageBase::writeBinary(ostream& outfile) {
    float version = getVersion();
+   int headersize = (version < 6) ? 2 : 4;
 
-   // first write the number of numbers in the data file.
-   // use a dummy value of 0 for now
-   char dummy[4] = {0};
-   if (version < 6) {
-      outfile.write(dummy, 2);
-   } else {
-      outfile.write(dummy, 4);
+   // calculate the total count of numbers in the data file.
+   int writecount = 0;
+   int i;
+   for (i=0; i<data.getSize(); i++) {
+      writecount += data[i]->prepareBinary();
    }
-   int writecount = 0;   // number of numbers which have been read
+   writecount += trailer.getSize() + 2;
 
-   int i;
+   Array<char> buffer;
+   buffer.setSize(headersize + writecount * 4);
+   char* ptr = buffer.getBase() + headersize;
    for (i=0; i<data.getSize(); i++) {
-      writecount += data[i]->writeBinary(outfile);
+      ptr += data[i]->writeBinary(ptr) * 4;
    }
 
    // write the trailer
    for (i=trailer.getSize()-1; i>=0; i--) {
-      writeLittleFloat(outfile, trailer[i]);
-      writecount++;
+      ScoreRecord::encodeLittleFloats(ptr, &trailer[i], 1);
+      ptr += 4;
    }
    // write the size of the trailer (plus one more for this field)
-   writeLittleFloat(outfile, trailer.getSize() + 1);
-   writecount++;
+   double number = trailer.getSize() + 1;
+   ScoreRecord::encodeLittleFloats(ptr, &number, 1);
+   ptr += 4;
 
    // write the end of file marker
-   writeLittleFloat(outfile, -9999.0);
-   writecount++;
+   number = -9999.0;
+   ScoreRecord::encodeLittleFloats(ptr, &number, 1);
 
    if ((version < 6) && (writecount > 0x7fff)) {
       cerr << "Warning: data count (" << writecount << ") exceeds safe level"
            << endl;
    }
 
-   // go back to the start of the file and fill in the number of numbers
-   outfile.seekp(0);
-   if (version < 6) {
-      // write two byte counter
-      unsigned char blo = writecount & 0xff;
-      unsigned char bhi = (writecount >> 8) & 0xff;
-      outfile.write((char*)&blo, 1);
-      outfile.write((char*)&bhi, 1);
-   } else {
-      // write four-byte counter 
-      unsigned char bloest = writecount & 0xff;
-      unsigned char bloer  = (writecount >> 8)  & 0xff;
-      unsigned char bhier  = (writecount >> 16) & 0xff;
-      unsigned char bhiest = (writecount >> 24) & 0xff;
-      outfile.write((char*)&bloest, 1);
-      outfile.write((char*)&bloer,  1);
-      outfile.write((char*)&bhier,  1);
-      outfile.write((char*)&bhiest, 1);
+   // fill in the number of numbers at the start of the file.
+   // Version 6 and later use a four-byte counter.
+   for (i=0; i<headersize; i++) {
+      buffer[i] = (char)((writecount >> (8 * i)) & 0xff);
    }
 
+   outfile.write(buffer.getBase(), buffer.getSize());
    return outfile;
 }
 
@@ -722,25 +742,6 @@ void ScorePageBase::writeBinary4Byte(const char* filename) {
 
 
 
-//////////////////////////////
-//
-// ScorePageBase::writeLittleFloat -- Write a 4-byte float in little-endian
-//      format.
-//
-
-void ScorePageBase::writeLittleFloat(ostream& out, float number) { 
-   union { float f; unsigned int i; } num;
-   num.f = number;
-   char byteinfo[4];
-   byteinfo[0] = (char)( num.i        & 0xff);
-   byteinfo[1] = (char)((num.i >> 8)  & 0xff);
-   byteinfo[2] = (char)((num.i >> 16) & 0xff);
-   byteinfo[3] = (char)((num.i >> 24) & 0xff);
-   out.write(byteinfo, 4);
-}
-
-
-
 //////////////////////////////
 //
 // ScorePageBase::printAscii -- Print data in PMX format for readable text.
@@ -1001,7 +1002,7 @@ void ScorePageBase::shrinkParameters(void) {
 //
 
 void ScorePageBase::setVersion(float value) {
-   trailer[trailer.getSize()-1-3] = value;
+   trailer[1] = value;
 }
 
 
@@ -1012,7 +1013,7 @@ void ScorePageBase::setVersion(float value) {
 //
 
 void ScorePageBase::setVersionWinScore(void) {
-   trailer[trailer.getSize()-1-3] = 6.0;
+   trailer[1] = 6.0;
 }
 
 
@@ -1023,7 +1024,7 @@ void ScorePageBase::setVersionWinScore(void) {
 //
 
 float ScorePageBase::getVersion(void) {
-   return trailer[trailer.getSize()-1-3];
+   return trailer[1];
 }
 
 
@@ -1036,7 +1037,7 @@ float ScorePageBase::getVersion(void) {
 void ScorePageBase::setSerial(long value) {
    union { long i; float f; } u;
    u.i = value;
-   trailer[trailer.getSize()-1-4] = u.f;
+   trailer[2] = u.f;
 }
 
 
@@ -1049,7 +1050,7 @@ void ScorePageBase::setSerial(long value) {
 
 long ScorePageBase::getSerial(void) {
    union { long i; float f; } u;
-   u.f = trailer[trailer.getSize()-1-4];
+   u.f = trailer[2];
    return u.i;
 }
 
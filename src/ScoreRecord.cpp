@@ -6,6 +6,7 @@
 // Last Modified: Sat Mar 21 14:28:55 PST 2009
 // Last Modified: Thu Jul 26 20:46:26 PDT 2012 Fixed text object reading.
 // Last Modified: Fri Aug 24 09:57:53 PDT 2012 Renovated.
+// Last Modified: Sun Oct 18 23:31:02 PDT 2026 Buffered binary reading/writing.
 // Filename:      ...sig/src/sigInfo/ScoreRecord.cpp
 // Web Address:   http://sig.sapp.org/include/sigInfo/ScoreRecord.cpp
 // Syntax:        C++ 
@@ -445,12 +446,14 @@ void ScoreRecord::setTextFont(const char* aString) {
 
 //////////////////////////////
 //
-// ScoreRecord::writeBinary -- print the parameter data in Binary
-//    format, as found in a SCORE .mus file where the number of numbers
-//    to be written is given first.
+// ScoreRecord::prepareBinary -- Adjust the parameters for writing in
+//    binary format (removing trailing zero parameters, and setting the
+//    text length for text items), and return the number of 4-byte numbers
+//    (including the parameter count and text chunks) which writeBinary()
+//    will write.  Returns 0 if there are no parameters to write.
 //
 
-int ScoreRecord::writeBinary(ostream& out) { 
+int ScoreRecord::prepareBinary(void) { 
    if (getFixedSize() < 1) {
       return 0;
    }
@@ -462,47 +465,69 @@ int ScoreRecord::writeBinary(ostream& out) {
       setPValue(3, 0.0);
    }
 
-   int i;
-   if (getValue(0) == P1_Text) {
-      // set the length of the text in P12
-      int textlen = strlen(getTextData());
-      int totaltextlen = textlen;
+   if (getValue(0) != P1_Text) {
+      return getFixedSize() + 1;
+   }
 
-      setPValue(12, totaltextlen);
-      if (getPValue(13) == 0.0) {
-         setPValue(13, 0.0); // needed for .MUS files to parse in WinScore
-      }
-      int spaces = totaltextlen % 4;
-      int charbytes = totaltextlen / 4;
-      if (spaces != 0) {
-         spaces = 4 - spaces;
-         charbytes++;
-      }
+   // set the length of the text in P12
+   int textlen = strlen(getTextData());
+   setPValue(12, textlen);
+   if (getPValue(13) == 0.0) {
+      setPValue(13, 0.0); // needed for .MUS files to parse in WinScore
+   }
+   return getFixedSize() + (textlen + 3) / 4 + 1;
+}
 
-      writeLittleEndian(out, (float)(getFixedSize() + charbytes));
-      for (i=0; i<getFixedSize(); i++) {
-         writeLittleEndian(out, getValue(i));
-      }
 
-      const char* ptr;
-      ptr = getTextData();
-      for (i=0; i<textlen; i++) {
-         out << ptr[i];
-      }
 
-      for (i=0; i<spaces; i++) {
-         out << ' ';
-      }
+//////////////////////////////
+//
+// ScoreRecord::writeBinary -- print the parameter data in Binary
+//    format, as found in a SCORE .mus file where the number of numbers
+//    to be written is given first.  The char* version stores the data
+//    in a buffer which must be large enough for the count returned by
+//    prepareBinary(), and prepareBinary() must be called before it.
+//    Both versions return the number of 4-byte numbers written.
+//
 
-      return getFixedSize() + charbytes + 1;
-   } else {
-      writeLittleEndian(out, (float)getFixedSize());
-      for (i=0; i<getFixedSize(); i++) {
-         writeLittleEndian(out, getValue(i));
-      }
-      return getFixedSize() + 1;
+int ScoreRecord::writeBinary(ostream& out) { 
+   int count = prepareBinary();
+   if (count == 0) {
+      return 0;
+   }
+   Array<char> buffer;
+   buffer.setSize(count * 4);
+   writeBinary(buffer.getBase());
+   out.write(buffer.getBase(), buffer.getSize());
+   return count;
+}
+
+
+int ScoreRecord::writeBinary(char* output) { 
+   int fixedcount = getFixedSize();
+   if (fixedcount < 1) {
+      return 0;
    }
 
+   int textlen = 0;
+   int charbytes = 0;
+   if (getValue(0) == P1_Text) {
+      textlen = strlen(getTextData());
+      charbytes = (textlen + 3) / 4;
+   }
+
+   double count = fixedcount + charbytes;
+   encodeLittleFloats(output, &count, 1);
+   encodeLittleFloats(output + 4, fixedParameters.getBase(), fixedcount);
+
+   if (getValue(0) == P1_Text) {
+      // text is padded with spaces to a multiple of 4 bytes.
+      char* ptr = output + 4 + fixedcount * 4;
+      memcpy(ptr, getTextData(), textlen);
+      memset(ptr + textlen, ' ', charbytes * 4 - textlen);
+   }
+
+   return fixedcount + charbytes + 1;
 }
 
 
@@ -510,7 +535,11 @@ int ScoreRecord::writeBinary(ostream& out) {
 //////////////////////////////
 //
 // ScoreRecord::readBinary -- input parameter values from the given
-//     input stream.
+//     input stream.  The second version reads the parameters from
+//     a list of numbers which were already decoded with
+//     decodeLittleFloats(), where values[0] is P1 and bytes is the
+//     raw data for values[0], which is needed for the text of P1=16 items.
+//     The list must contain pcount numbers.
 //
 
 void ScoreRecord::readBinary(istream& instream, int pcount) {
@@ -558,6 +587,98 @@ void ScoreRecord::readBinary(istream& instream, int pcount) {
 }
 
 
+void ScoreRecord::readBinary(const float* values, const char* bytes, 
+      int pcount) {
+   int i;
+   if (pcount < 1) {
+      cout << "Error: invalid parameter count: " << pcount << endl;
+      exit(1);
+   }
+
+   if ((int)values[0] != 16) {
+      // non-text data parameters
+      fixedParameters.setSize(pcount);
+      double* parameters = fixedParameters.getBase();
+      for (i=0; i<pcount; i++) {
+         parameters[i] = values[i];
+      }
+      return;
+   }
+
+   setFixedSize(13);
+   fixedParameters[0] = values[0];
+   for (i=1; (i<13) && (i<pcount); i++) {
+      fixedParameters[i] = ScoreParameters::roundFractionDigits(values[i], 3);
+   }
+   for ( ; i<13; i++) {
+      fixedParameters[i] = 0.0;
+   }
+
+   // The text follows the 13 fixed parameters, and is limited to the
+   // characters before any null character.
+   int count = (int)getPValue(12);
+   if (count > (pcount - 13) * 4) {
+      count = (pcount - 13) * 4;
+   }
+   if (count < 0) {
+      count = 0;
+   }
+   const char* textdata = bytes + 13 * 4;
+   const char* nullchar = (const char*)memchr(textdata, '\0', count);
+   if (nullchar != NULL) {
+      count = (int)(nullchar - textdata);
+   }
+   text.setSize(count + 1);
+   memcpy(text.getBase(), textdata, count);
+   text[count] = '\0';
+}
+
+
+
+//////////////////////////////
+//
+// ScoreRecord::decodeLittleFloats -- Convert a list of 4-byte
+//    little-endian floats into numbers.  The loop does not depend on
+//    the byte order of the computer, and can be vectorized by the compiler.
+//
+
+void ScoreRecord::decodeLittleFloats(float* output, const char* input, 
+      int count) {
+   const unsigned char* bytes = (const unsigned char*)input;
+   unsigned int value;
+   for (int i=0; i<count; i++) {
+      value = (unsigned int)bytes[0] | ((unsigned int)bytes[1] << 8) |
+            ((unsigned int)bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+      memcpy(output + i, &value, 4);
+      bytes += 4;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// ScoreRecord::encodeLittleFloats -- Store a list of numbers as 4-byte
+//    little-endian floats.
+//
+
+void ScoreRecord::encodeLittleFloats(char* output, const double* input, 
+      int count) {
+   unsigned char* bytes = (unsigned char*)output;
+   unsigned int value;
+   float number;
+   for (int i=0; i<count; i++) {
+      number = (float)input[i];
+      memcpy(&value, &number, 4);
+      bytes[0] = (unsigned char)( value        & 0xff);
+      bytes[1] = (unsigned char)((value >> 8)  & 0xff);
+      bytes[2] = (unsigned char)((value >> 16) & 0xff);
+      bytes[3] = (unsigned char)((value >> 24) & 0xff);
+      bytes += 4;
+   }
+}
+
+
 
 ///////////////////////////////
 //
@@ -0,0 +1,719 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 18:41:27 PDT 2026
+// Last Modified: Sun Oct 18 18:41:27 PDT 2026
+// Last Modified: Sun Oct 18 21:48:15 PDT 2026 Skip POSIX classes in getLiterals
+// Filename:      ...sig/src/sigInfo/ThemeIndex.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/ThemeIndex.cpp
+// Syntax:        C++
+//
+// Description:   Binary inverted index of thematic search records as
+//                created by tindex and searched by themax.
+//
+//                Layout (all integers are 32-bit, native byte order):
+//                   8 bytes:  "THEMEIDX"
+//                   int:      format version (THEMEINDEX_VERSION)
+//                   int:      byte-order marker (0x01020304)
+//                   int:      record count, message count, key count,
+//                             posting count, text size
+//                   ints:     text offsets of the records (count+1)
+//                   ints:     text offsets of the messages (count+1)
+//                   ints:     sorted n-gram keys
+//                   ints:     posting list start of each key (count+1)
+//                   ints:     postings (record, note offset)
+//                   chars:    text of the records and messages
+//
+//                An n-gram key is the feature marker followed by three
+//                characters.  Since themax searches a feature with a
+//                regular expression of the form "marker[^\t]*query", an
+//                n-gram is stored for each feature marker which occurs
+//                before it in the same tab-separated field, not only for
+//                the marker at the start of the field.
+//
+
+#include "ThemeIndex.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+#define THEMEINDEX_MAGIC    "THEMEIDX"
+#define THEMEINDEX_VERSION  1
+#define THEMEINDEX_ORDER    0x01020304
+#define THEMEINDEX_HEADER   36         /* header size in bytes */
+
+class ThemeIndexEntry {
+   public:
+      unsigned int key;
+      unsigned int record;
+      unsigned int note;
+};
+
+
+// function declarations:
+static void         appendIndexInt  (string& output, unsigned int value);
+static unsigned int makeIndexKey    (char marker, const char* ngram);
+static int          isNoteStart     (char marker, const string& field,
+                                     int position);
+static int          entryCompare    (const ThemeIndexEntry& a,
+                                     const ThemeIndexEntry& b);
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::ThemeIndex --
+//
+
+ThemeIndex::ThemeIndex(void) {
+   clear();
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::~ThemeIndex --
+//
+
+ThemeIndex::~ThemeIndex() {
+   clear();
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::clear -- Remove all records from the index.
+//
+
+void ThemeIndex::clear(void) {
+   lines.clear();
+   messages.clear();
+   mapped.close();
+   recordcount    = 0;
+   messagecount   = 0;
+   keycount       = 0;
+   recordoffsets  = NULL;
+   messageoffsets = NULL;
+   keys           = NULL;
+   keystarts      = NULL;
+   postings       = NULL;
+   text           = NULL;
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::addLine -- Add a line of tindex output to the index.
+//     Lines starting with "#" are control messages, and empty lines
+//     are ignored.
+//
+
+void ThemeIndex::addLine(const string& line) {
+   int i;
+   for (i=0; i<(int)line.size(); i++) {
+      if (!isspace(line[i])) {
+         break;
+      }
+   }
+   if (i >= (int)line.size()) {
+      return;
+   }
+   if (line[0] == '#') {
+      messages.push_back(line);
+   } else {
+      lines.push_back(line);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::addLines -- Add all lines of tindex output from a stream.
+//
+
+void ThemeIndex::addLines(istream& input) {
+   string line;
+   while (getline(input, line)) {
+      addLine(line);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::write -- Store the added lines as a binary index.
+//     Returns 0 if the file could not be written.
+//
+
+int ThemeIndex::write(const char* filename) {
+   fstream outfile(filename, ios::out | ios::binary);
+   if (!outfile.is_open()) {
+      return 0;
+   }
+   write(outfile);
+   outfile.close();
+   return 1;
+}
+
+
+int ThemeIndex::write(const string& filename) {
+   return write(filename.c_str());
+}
+
+
+void ThemeIndex::write(ostream& out) {
+   vector<ThemeIndexEntry> entries;
+   ThemeIndexEntry entry;
+   vector<char> seen;
+   string field;
+   unsigned int r;
+   int i, k, m;
+   int note;
+
+   for (r=0; r<lines.size(); r++) {
+      stringstream fields(lines[r]);
+      entry.record = r;
+      while (getline(fields, field, '\t')) {
+         seen.clear();
+         note = -1;
+         for (i=0; i<(int)field.size(); i++) {
+            if (i > 0 && isNoteStart(field[0], field, i)) {
+               note++;
+            }
+            if ((i > 0) && (i + 2 < (int)field.size())) {
+               entry.note = note < 0 ? 0 : note;
+               for (m=0; m<(int)seen.size(); m++) {
+                  entry.key = makeIndexKey(seen[m], field.c_str() + i);
+                  entries.push_back(entry);
+               }
+            }
+            if (isFeatureMarker(field[i])) {
+               if (find(seen.begin(), seen.end(), field[i]) == seen.end()) {
+                  seen.push_back(field[i]);
+               }
+            }
+         }
+      }
+   }
+
+   // sort by key, keeping the record order, and keep only the first
+   // occurrence of a key in each record.
+   stable_sort(entries.begin(), entries.end(), entryCompare);
+   k = 0;
+   for (i=0; i<(int)entries.size(); i++) {
+      if ((k > 0) && (entries[k-1].key == entries[i].key) &&
+            (entries[k-1].record == entries[i].record)) {
+         continue;
+      }
+      entries[k++] = entries[i];
+   }
+   entries.resize(k);
+
+   vector<unsigned int> keylist;
+   vector<unsigned int> starts;
+   for (i=0; i<(int)entries.size(); i++) {
+      if (keylist.empty() || (keylist.back() != entries[i].key)) {
+         keylist.push_back(entries[i].key);
+         starts.push_back(i);
+      }
+   }
+   starts.push_back((unsigned int)entries.size());
+
+   string alltext;
+   vector<unsigned int> offsets;
+   for (i=0; i<(int)lines.size(); i++) {
+      offsets.push_back((unsigned int)alltext.size());
+      alltext += lines[i];
+   }
+   offsets.push_back((unsigned int)alltext.size());
+   for (i=0; i<(int)messages.size(); i++) {
+      offsets.push_back((unsigned int)alltext.size());
+      alltext += messages[i];
+   }
+   offsets.push_back((unsigned int)alltext.size());
+
+   string output;
+   output.reserve(THEMEINDEX_HEADER + (offsets.size() + keylist.size() +
+         starts.size() + entries.size() * 2) * 4 + alltext.size());
+   output.append(THEMEINDEX_MAGIC, 8);
+   appendIndexInt(output, THEMEINDEX_VERSION);
+   appendIndexInt(output, THEMEINDEX_ORDER);
+   appendIndexInt(output, (unsigned int)lines.size());
+   appendIndexInt(output, (unsigned int)messages.size());
+   appendIndexInt(output, (unsigned int)keylist.size());
+   appendIndexInt(output, (unsigned int)entries.size());
+   appendIndexInt(output, (unsigned int)alltext.size());
+   for (i=0; i<(int)offsets.size(); i++) {
+      appendIndexInt(output, offsets[i]);
+   }
+   for (i=0; i<(int)keylist.size(); i++) {
+      appendIndexInt(output, keylist[i]);
+   }
+   for (i=0; i<(int)starts.size(); i++) {
+      appendIndexInt(output, starts[i]);
+   }
+   for (i=0; i<(int)entries.size(); i++) {
+      appendIndexInt(output, entries[i].record);
+      appendIndexInt(output, entries[i].note);
+   }
+   output += alltext;
+   out.write(output.data(), output.size());
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::read -- Memory-map a binary index created with write().
+//     Returns 0 if the file is not a valid index.
+//
+
+int ThemeIndex::read(const char* filename) {
+   clear();
+   if (!mapped.open(filename)) {
+      return 0;
+   }
+   const char* data = mapped.getData();
+   long size = mapped.getSize();
+   if ((size < THEMEINDEX_HEADER) ||
+         (strncmp(data, THEMEINDEX_MAGIC, 8) != 0)) {
+      clear();
+      return 0;
+   }
+   const unsigned int* header = (const unsigned int*)(data + 8);
+   if ((header[0] != THEMEINDEX_VERSION) || (header[1] != THEMEINDEX_ORDER)) {
+      clear();
+      return 0;
+   }
+   long postingcount = header[5];
+   long textsize     = header[6];
+   long expected = THEMEINDEX_HEADER;
+   expected += ((long)header[2] + 1 + (long)header[3] + 1) * 4;
+   expected += ((long)header[4] * 2 + 1) * 4;
+   expected += postingcount * 8 + textsize;
+   if (expected != size) {
+      clear();
+      return 0;
+   }
+
+   recordcount    = header[2];
+   messagecount   = header[3];
+   keycount       = header[4];
+   recordoffsets  = header + 7;
+   messageoffsets = recordoffsets + recordcount + 1;
+   keys           = messageoffsets + messagecount + 1;
+   keystarts      = keys + keycount;
+   postings       = (const ThemeIndexPosting*)(keystarts + keycount + 1);
+   text           = (const char*)(postings + postingcount);
+   return 1;
+}
+
+
+int ThemeIndex::read(const string& filename) {
+   return read(filename.c_str());
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::getRecordCount -- Return the number of search records
+//     in a read index.
+//
+
+int ThemeIndex::getRecordCount(void) const {
+   return recordcount;
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::getRecord -- Return the text of a search record.
+//
+
+void ThemeIndex::getRecord(string& line, int index) const {
+   getText(line, recordoffsets, index);
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::getMessageCount -- Return the number of control messages
+//     in a read index.
+//
+
+int ThemeIndex::getMessageCount(void) const {
+   return messagecount;
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::getMessage -- Return the text of a control message.
+//
+
+void ThemeIndex::getMessage(string& line, int index) const {
+   getText(line, messageoffsets, index);
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::getPostings -- Return the posting list of the three
+//     characters starting at ngram for the given feature marker.  The
+//     postings are sorted by record.
+//
+
+const ThemeIndexPosting* ThemeIndex::getPostings(int& count, char marker,
+      const char* ngram) const {
+   count = 0;
+   if (keycount == 0) {
+      return NULL;
+   }
+   unsigned int key = makeIndexKey(marker, ngram);
+   const unsigned int* ptr = lower_bound(keys, keys + keycount, key);
+   if ((ptr == keys + keycount) || (*ptr != key)) {
+      return NULL;
+   }
+   int index = (int)(ptr - keys);
+   count = keystarts[index+1] - keystarts[index];
+   return postings + keystarts[index];
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::getCandidates -- Return the sorted list of records which
+//     contain every literal after its matching feature marker.  Literals
+//     shorter than three characters cannot be used.  Returns 0 if none
+//     of the literals could be used, in which case all records are
+//     candidates.
+//
+
+int ThemeIndex::getCandidates(vector<int>& records,
+      const vector<char>& markers, const vector<string>& literals) const {
+   records.clear();
+   int activeQ = 0;
+   vector<int> list;
+   vector<int> merged;
+   const ThemeIndexPosting* plist;
+   int count;
+   int i, j, k, m;
+   for (i=0; i<(int)literals.size(); i++) {
+      for (j=0; j+2<(int)literals[i].size(); j++) {
+         plist = getPostings(count, markers[i], literals[i].c_str() + j);
+         list.resize(count);
+         for (k=0; k<count; k++) {
+            list[k] = plist[k].record;
+         }
+         if (!activeQ) {
+            records = list;
+            activeQ = 1;
+         } else {
+            merged.clear();
+            k = 0;
+            m = 0;
+            while ((k < (int)records.size()) && (m < (int)list.size())) {
+               if (records[k] < list[m]) {
+                  k++;
+               } else if (list[m] < records[k]) {
+                  m++;
+               } else {
+                  merged.push_back(records[k]);
+                  k++;
+                  m++;
+               }
+            }
+            records.swap(merged);
+         }
+         if (records.empty()) {
+            return 1;
+         }
+      }
+   }
+   return activeQ;
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::getLiterals -- Return the literal strings which must be
+//     contained in any text matched by the regular expression, up to the
+//     first part of the expression which might match a tab character
+//     (since a match of the literals after that may be in a different
+//     field).  Returns 0 (and no literals) if the expression cannot be
+//     analyzed, such as when it contains alternation.
+//
+
+int ThemeIndex::getLiterals(vector<string>& literals, const string& regex) {
+   literals.clear();
+   string run;
+   int depth = 0;
+   int stopQ = 0;
+   int size = (int)regex.size();
+   int i = 0;
+   int j;
+   char ch;
+
+   while ((i < size) && !stopQ) {
+      ch = regex[i];
+      switch (ch) {
+         case '\\':
+            if (i + 1 >= size) {
+               stopQ = 1;
+               break;
+            }
+            ch = regex[i+1];
+            i += 2;
+            if (!isalnum(ch)) {
+               if (depth == 0) {
+                  run += ch;
+               }
+               continue;
+            }
+            if (strchr("dwbB", ch) == NULL) {
+               if (strchr("tsSDWn", ch) == NULL) {
+                  // other escapes are not analyzed
+                  literals.clear();
+                  return 0;
+               }
+               stopQ = 1;
+            }
+            break;
+
+         case '[':
+            j = i + 1;
+            if ((j < size) && (regex[j] == '^')) {
+               stopQ = 1;
+            }
+            if ((j < size) && (regex[j] == ']')) {
+               j++;
+            }
+            while ((j < size) && (regex[j] != ']')) {
+               if ((regex[j] == '\\') || (regex[j] == '\t')) {
+                  stopQ = 1;
+               }
+               if ((regex[j] == '[') && (j + 1 < size) &&
+                     (strchr(":.=", regex[j+1]) != NULL)) {
+                  // skip over a [:class:], [.coll.] or [=equiv=] item
+                  ch = regex[j+1];
+                  j += 2;
+                  while ((j + 1 < size) && 
+                        !((regex[j] == ch) && (regex[j+1] == ']'))) {
+                     j++;
+                  }
+                  j++;
+               }
+               j++;
+            }
+            i = j + 1;
+            break;
+
+         case '(':
+            if ((i + 1 < size) && (regex[i+1] == '?')) {
+               if ((i + 2 >= size) || (regex[i+2] != ':')) {
+                  // options and assertions are not analyzed
+                  literals.clear();
+                  return 0;
+               }
+               i += 2;
+            }
+            depth++;
+            i++;
+            break;
+
+         case ')':
+            depth--;
+            i++;
+            break;
+
+         case '|':
+            literals.clear();
+            return 0;
+
+         case '*':
+         case '?':
+         case '{':
+            // previous character is optional
+            if (!run.empty() && (depth == 0)) {
+               run.resize(run.size() - 1);
+            }
+            if (ch == '{') {
+               while ((i < size) && (regex[i] != '}')) {
+                  i++;
+               }
+            }
+            i++;
+            break;
+
+         case '+':
+         case '^':
+         case '$':
+            i++;
+            break;
+
+         case '.':
+         case '\t':
+            stopQ = 1;
+            break;
+
+         default:
+            if (depth == 0) {
+               run += ch;
+            }
+            i++;
+            continue;
+      }
+
+      // any character which is not a literal ends the current literal
+      if (!run.empty()) {
+         literals.push_back(run);
+         run.clear();
+      }
+   }
+
+   if (!run.empty()) {
+      literals.push_back(run);
+   }
+   return (int)literals.size();
+}
+
+
+
+//////////////////////////////
+//
+// ThemeIndex::isFeatureMarker -- True if the character is one of the
+//     feature markers used in tindex output.
+//
+
+int ThemeIndex::isFeatureMarker(char marker) {
+   switch (marker) {
+      case 'J':  case '}':  case '%':  case '{':  case '#':
+      case ':':  case 'j':  case '~':  case '^':  case ';':
+      case '&':  case '=':  case '\'': case '@':  case '`':
+         return 1;
+   }
+   return 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+//////////////////////////////
+//
+// ThemeIndex::getText -- Extract a string from the text block.
+//
+
+void ThemeIndex::getText(string& line, const unsigned int* offsets,
+      int index) const {
+   line.assign(text + offsets[index], offsets[index+1] - offsets[index]);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// static functions
+//
+
+//////////////////////////////
+//
+// appendIndexInt --
+//
+
+static void appendIndexInt(string& output, unsigned int value) {
+   output.append((const char*)&value, 4);
+}
+
+
+
+//////////////////////////////
+//
+// makeIndexKey -- Pack a feature marker and three characters into a key.
+//
+
+static unsigned int makeIndexKey(char marker, const char* ngram) {
+   return ((unsigned int)(unsigned char)marker    << 24) |
+          ((unsigned int)(unsigned char)ngram[0]  << 16) |
+          ((unsigned int)(unsigned char)ngram[1]  <<  8) |
+           (unsigned int)(unsigned char)ngram[2];
+}
+
+
+
+//////////////////////////////
+//
+// isNoteStart -- True if the character at the given position in a
+//     feature field starts the data for a new note (or interval).
+//     Scale degrees, contours and beat levels use one character per
+//     note, while some features use multiple characters per note.
+//
+
+static int isNoteStart(char marker, const string& field, int position) {
+   char ch = field[position];
+   char lastch = field[position-1];
+   switch (marker) {
+      case '{':   // 12-tone interval: p4, m12, p0, R
+         return (ch == 'p') || (ch == 'm') || (ch == 'R');
+
+      case '}':   // musical interval: XM3, xm2, P1, R
+         if ((ch == 'X') || (ch == 'x') || (ch == 'R')) {
+            return 1;
+         }
+         return (ch == 'P') && (lastch != 'X') && (lastch != 'x');
+
+      case 'J':   // space-separated features
+      case ';':
+      case '\'':
+      case '=':
+         return (ch != ' ') && ((position == 1) || (lastch == ' '));
+
+      case '#':   // one character per note
+      case ':':
+      case '%':
+      case 'j':
+      case '~':
+      case '^':
+      case '&':
+      case '`':
+      case '@':
+         return 1;
+   }
+   return 0;
+}
+
+
+
+//////////////////////////////
+//
+// entryCompare -- Sort index entries by key.
+//
+
+static int entryCompare(const ThemeIndexEntry& a, const ThemeIndexEntry& b) {
+   return a.key < b.key;
+}
+
+
+
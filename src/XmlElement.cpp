@@ -3,6 +3,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun  6 14:21:45 PDT 2011
 // Last Modified: Tue Jun  7 13:02:16 PDT 2011
+// Last Modified: Sun Oct 18 22:10:05 PDT 2026 parse attributes on demand
 // Filename:      ...sig/include/SigInfo/XmlElement.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/XmlElement.h
 // Syntax:        C++ 
@@ -12,9 +13,10 @@
 //
 
 #include "XmlElement.h"
-#include "PerlRegularExpression.h"
 
 #include <string.h>
+#include <ctype.h>
+#include <stdlib.h>
 
 
 //////////////////////////////
@@ -28,6 +30,8 @@ XmlElement::XmlElement(void) {
    endSerial = -1;
    atkey.setSize(0);
    atvalue.setSize(0);
+   item = NULL;
+   parsedQ = 1;
 }
 
 
@@ -49,6 +53,22 @@ XmlElement::~XmlElement() {
 //
 
 void XmlElement::clear(void) {
+   clearAttributes();
+   entryType = XMLENTRY_UNKNOWN;
+   startSerial    = -1;
+   endSerial = -1;
+   item = NULL;
+   parsedQ = 1;
+}
+
+
+
+//////////////////////////////
+//
+// XmlElement::clearAttributes --
+//
+
+void XmlElement::clearAttributes(void) {
    int i;
    int asize = atkey.getSize();
    for (i=0; i<asize; i++) {
@@ -59,11 +79,9 @@ void XmlElement::clear(void) {
    }
    atkey.setSize(0);
    atvalue.setSize(0);
-   entryType = XMLENTRY_UNKNOWN;
-   startSerial    = -1;
-   endSerial = -1;
 }
 
+
 //////////////////////////////
 //
 // XmlElement::setName --
@@ -197,30 +215,220 @@ int XmlElement::isTagQuestion(void) {
 
 
 
+//////////////////////////////
+//
+// XmlElement::setItem -- Store the start tag of the element.  The
+//    attributes in the tag will be parsed when they are first needed.
+//    The item must not be deleted before the element.
+//
+
+void XmlElement::setItem(XmlItem* anItem) { 
+   clearAttributes();
+   item = anItem;
+   parsedQ = 0;
+   if (item != NULL) {
+      setTypeByString(*item);
+   }
+}
+
+
+
 //////////////////////////////
 //
 // XmlElement::parseXmlAttributes -- read an XML Elements attribute list.
 //
 
 void XmlElement::parseXmlAttributes(XmlItem& anItem) { 
-//   setTypeByString(anItem);
-//   startSerial = anItem.getSerial();
-//   
-// ggg
+   setItem(&anItem);
+   parseAttributes();
+}
+
+
+
+//////////////////////////////
+//
+// XmlElement::parseAttributes -- Extract the attributes from the start
+//    tag of the element.  Values may be given in single or double
+//    quotes, and entities in the values are decoded.
 //
 
+void XmlElement::parseAttributes(void) { 
+   parsedQ = 1;
+   if (item == NULL) {
+      return;
+   }
+
+   const char* ptr = item->getBase();
+   const char* end = ptr + item->getSize();
+   const char* start;
+   const char* stop;
+   SigString*  key;
+   SigString*  value;
+
+   // skip over the element name
+   while ((ptr < end) && (isspace((unsigned char)*ptr) || (*ptr == '<'))) {
+      ptr++;
+   }
+   while ((ptr < end) && !isspace((unsigned char)*ptr) && (*ptr != '>') &&
+         (*ptr != '/')) {
+      ptr++;
+   }
 
+   while (ptr < end) {
+      while ((ptr < end) && isspace((unsigned char)*ptr)) {
+         ptr++;
+      }
+      if ((ptr >= end) || (*ptr == '>') || (*ptr == '/') || (*ptr == '?')) {
+         break;
+      }
+      start = ptr;
+      while ((ptr < end) && !isspace((unsigned char)*ptr) && (*ptr != '=') &&
+            (*ptr != '>') && (*ptr != '/')) {
+         ptr++;
+      }
+      if (ptr == start) {
+         // stray "=" without an attribute name
+         ptr++;
+         continue;
+      }
+      key = new SigString;
+      key->setSize(ptr - start);
+      memcpy(key->getBase(), start, ptr - start);
+      value = new SigString;
+
+      while ((ptr < end) && isspace((unsigned char)*ptr)) {
+         ptr++;
+      }
+      if ((ptr < end) && (*ptr == '=')) {
+         ptr++;
+         while ((ptr < end) && isspace((unsigned char)*ptr)) {
+            ptr++;
+         }
+         if ((ptr < end) && ((*ptr == '"') || (*ptr == '\''))) {
+            start = ptr + 1;
+            stop = (const char*)memchr(start, *ptr, end - start);
+            if (stop == NULL) {
+               stop = end;
+            }
+            ptr = (stop < end) ? stop + 1 : end;
+         } else {
+            // unquoted value (not valid XML, but accepted)
+            start = ptr;
+            while ((ptr < end) && !isspace((unsigned char)*ptr) && 
+                  (*ptr != '>') && !((*ptr == '/') && (ptr[1] == '>'))) {
+               ptr++;
+            }
+            stop = ptr;
+         }
+         decodeEntities(*value, start, stop - start);
+      }
+
+      atkey.append(key);
+      atvalue.append(value);
+   }
 }
 
 
 
 //////////////////////////////
 //
-// XmlElement::setTypeByString --
-//
+// XmlElement::decodeEntities -- Convert the predefined XML entities
+//    and numeric character references into characters (UTF-8).
+//    Unknown entities are copied unchanged.
+//
+
+void XmlElement::decodeEntities(SigString& output, const char* text, 
+      int size) { 
+   // decoded text is never longer than the input text
+   output.setSize(size);
+   char* out = output.getBase();
+   const char* ptr;
+   const char* semi;
+   int n = 0;
+   int i = 0;
+   int stop;
+   int length;
+   long code;
+
+   while (i < size) {
+      ptr = (const char*)memchr(text+i, '&', size-i);
+      stop = (ptr == NULL) ? size : (int)(ptr - text);
+      memcpy(out+n, text+i, stop-i);
+      n += stop - i;
+      i = stop;
+      if (i >= size) {
+         break;
+      }
+
+      length = size - i < 12 ? size - i : 12;
+      semi = (const char*)memchr(text+i, ';', length);
+      code = -1;
+      if (semi != NULL) {
+         ptr = text + i + 1;
+         length = (int)(semi - ptr);
+         if ((length == 2) && (strncmp(ptr, "lt", 2) == 0)) {
+            code = '<';
+         } else if ((length == 2) && (strncmp(ptr, "gt", 2) == 0)) {
+            code = '>';
+         } else if ((length == 3) && (strncmp(ptr, "amp", 3) == 0)) {
+            code = '&';
+         } else if ((length == 4) && (strncmp(ptr, "quot", 4) == 0)) {
+            code = '"';
+         } else if ((length == 4) && (strncmp(ptr, "apos", 4) == 0)) {
+            code = '\'';
+         } else if ((length > 2) && (ptr[0] == '#') && 
+               ((ptr[1] == 'x') || (ptr[1] == 'X'))) {
+            code = strtol(ptr+2, NULL, 16);
+         } else if ((length > 1) && (ptr[0] == '#')) {
+            code = strtol(ptr+1, NULL, 10);
+         }
+      }
+      if ((code <= 0) || (code > 0x10ffff)) {
+         out[n++] = '&';
+         i++;
+         continue;
+      }
+
+      if (code < 0x80) {
+         out[n++] = (char)code;
+      } else if (code < 0x800) {
+         out[n++] = (char)(0xc0 | (code >> 6));
+         out[n++] = (char)(0x80 | (code & 0x3f));
+      } else if (code < 0x10000) {
+         out[n++] = (char)(0xe0 | (code >> 12));
+         out[n++] = (char)(0x80 | ((code >> 6) & 0x3f));
+         out[n++] = (char)(0x80 | (code & 0x3f));
+      } else {
+         out[n++] = (char)(0xf0 | (code >> 18));
+         out[n++] = (char)(0x80 | ((code >> 12) & 0x3f));
+         out[n++] = (char)(0x80 | ((code >> 6) & 0x3f));
+         out[n++] = (char)(0x80 | (code & 0x3f));
+      }
+      i = (int)(semi - text) + 1;
+   }
+   output.setSize(n);
+}
+
 
-void setTypeByString(XmlItem& anItem) {
- // ggg
+
+//////////////////////////////
+//
+// XmlElement::setTypeByString -- set the element type from the type of
+//     its start tag.
+//
+
+void XmlElement::setTypeByString(XmlItem& anItem) {
+   switch (anItem.getType()) {
+      case XMLITEM_TYPE_ELEMENTSOLO:  entryType = XMLENTRY_ELEMENTSOLO;  break;
+      case XMLITEM_TYPE_ELEMENTSTART: entryType = XMLENTRY_ELEMENTSTART; break;
+      case XMLITEM_TYPE_ELEMENTEND:   entryType = XMLENTRY_ELEMENTEND;   break;
+      case XMLITEM_TYPE_COMMENT:      entryType = XMLENTRY_COMMENT;      break;
+      case XMLITEM_TYPE_BANG:         entryType = XMLENTRY_TAGBANG;      break;
+      case XMLITEM_TYPE_QUESTION:     entryType = XMLENTRY_TAGQUESTION;  break;
+      case XMLITEM_TYPE_TEXT:         entryType = XMLENTRY_TEXT;         break;
+      case XMLITEM_TYPE_WHITESPACE:   entryType = XMLENTRY_SPACE;        break;
+      default:                        entryType = XMLENTRY_UNKNOWN;
+   }
 }
 
 
@@ -230,7 +438,10 @@ void setTypeByString(XmlItem& anItem) {
 //
 
 int XmlElement::getAttributeSize(void) { 
-  return atkey.getSize();
+   if (!parsedQ) {
+      parseAttributes();
+   }
+   return atkey.getSize();
 }
 
 
@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue Jun  7 13:04:03 PDT 2011
 // Last Modified: Fri Jun 24 14:54:42 PDT 2011
+// Last Modified: Sun Oct 18 22:10:05 PDT 2026 lazy element index
+// Last Modified: Mon Oct 19 03:24:16 PDT 2026 added printItemList
 // Filename:      ...sig/src/sigInfo/XmlFile.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/XmlFile.cpp
 // Syntax:        C++ 
@@ -28,9 +30,9 @@
    #define CSTRING str()
 #endif
    
-#include "PerlRegularExpression.h"
 #include "XmlFile.h"
 #include <string.h>
+#include <ctype.h>
 #include <iomanip>
 
 
@@ -41,12 +43,14 @@
 
 XmlFile::XmlFile(void) { 
    elements.setSize(0);
+   elementBlock = NULL;
    parsedQ = 0;
 }
 
 
 XmlFile::XmlFile(int allocationSize) { 
    elements.setSize(0);
+   elementBlock = NULL;
    parsedQ = 0;
 }
 
@@ -70,12 +74,9 @@ XmlFile::~XmlFile() {
 //
 
 void XmlFile::clearElements(void) {
-   int i;
-   for (i=0; i<elements.getSize(); i++) {
-      if (elements[i] != NULL) {
-         delete elements[i];
-      }
-      elements[i] = NULL;
+   if (elementBlock != NULL) {
+      delete [] elementBlock;
+      elementBlock = NULL;
    }
    elements.setSize(0);
    parsedQ = 0;
@@ -156,6 +157,9 @@ int XmlFile::getItemSerial(int index) const {
 //
 
 XmlElement& XmlFile::operator[](int index) {
+   if (!isParsed()) {
+      parseElements();
+   }
    return *(elements[index]);
 }
 
@@ -174,14 +178,13 @@ XmlItem& XmlFile::getItem(int index) {
 
 //////////////////////////////
 //
-// XmlFile::read --
+// XmlFile::read -- The element index is created when it is first needed.
 //
 
 void XmlFile::read(const char* filename) { 
    clear();
    xmlitems.read(filename);
    parsedQ = 0;
-   parseElements();
 }
 
 
@@ -189,7 +192,6 @@ void XmlFile::read(istream& input) {
    clear();
    xmlitems.read(input);
    parsedQ = 0;
-   parseElements();
 }
 
 
@@ -237,13 +239,51 @@ int XmlFile::deleteItem(int index) {
 //////////////////////////////
 //
 // XmlFile::printElementList -- used for debugging the parsing of elements.
+//    Each element is printed on a separate line with the serial numbers
+//    of its start and end items, its name and its decoded attributes.
 //
 
 ostream& XmlFile::printElementList(ostream& out) {
-   int i;
+   int i, j;
    XmlFile& xmlfile = *this;
    for (i=0; i<getElementSize(); i++) {
-      out << xmlfile[i].getName() << "\n";
+      out << xmlfile[i].getStartSerial() << "\t"
+          << xmlfile[i].getEndSerial()   << "\t"
+          << xmlfile[i].getName();
+      for (j=0; j<xmlfile[i].getAttributeSize(); j++) {
+         out << "\t" << xmlfile[i].getAttributeName(j).getBase()
+             << "=" << xmlfile[i].getAttributeValue(j).getBase();
+      }
+      out << "\n";
+   }
+   return out;
+}
+
+
+
+//////////////////////////////
+//
+// XmlFile::printItemList -- used for debugging the reading of items.
+//    Each item is printed on a separate line with its serial number
+//    and type.  Newlines and tabs in the text are printed as "\n" and "\t".
+//
+
+ostream& XmlFile::printItemList(ostream& out) {
+   int i;
+   const char* ptr;
+   for (i=0; i<getItemSize(); i++) {
+      XmlItem& item = getItem(i);
+      out << item.getSerial() << "\t" << getItemTypeName(item.getType())
+          << "\t";
+      for (ptr = item.getBase(); *ptr != '\0'; ptr++) {
+         switch (*ptr) {
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            case '\r': out << "\\r"; break;
+            default:   out << *ptr;
+         }
+      }
+      out << "\n";
    }
    return out;
 }
@@ -259,6 +299,9 @@ ostream& XmlFile::printElementList(ostream& out) {
 //////////////////////////////
 //
 // XmlFile::parseElements -- parse element structure from xmlitems list.
+//    Each start tag is matched to the closest enclosing start tag with
+//    the same name.  The attributes of the elements are not parsed
+//    until they are accessed.
 //
 
 void XmlFile::parseElements(void) {
@@ -267,18 +310,61 @@ void XmlFile::parseElements(void) {
    }
 
    clearElements();
-   elements.setSize(xmlitems.getSize());
-   elements.setSize(0);
 
    int i;
+   int count = 0;
    for (i=0; i<xmlitems.getSize(); i++) {
       if (xmlitems[i].isElement()) {
-         i = processElement(i);
-      } else {
+         count++;
       }
    }
+   if (count == 0) {
+      parsedQ = 1;
+      return;
+   }
+
+   elementBlock = new XmlElement[count];
+   elements.setSize(count);
 
-   parseAttributes();
+   Array<int> openlist;     // elements which have not been closed yet
+   openlist.setSize(100);
+   openlist.setGrowth(1000);
+   openlist.setSize(0);
+   SigString name;
+   XmlElement* ptr;
+   int n = 0;
+   int k;
+
+   for (i=0; i<xmlitems.getSize(); i++) {
+      switch (xmlitems[i].getType()) {
+         case XMLITEM_TYPE_ELEMENTSOLO:
+         case XMLITEM_TYPE_ELEMENTSTART:
+            ptr = elementBlock + n;
+            getElementName(name, xmlitems[i]);
+            ptr->setName(name);
+            ptr->setItem(&xmlitems[i]);
+            ptr->setStartSerial(xmlitems.getSerial(i));
+            if (xmlitems[i].getType() == XMLITEM_TYPE_ELEMENTSOLO) {
+               ptr->setEndSerial(xmlitems.getSerial(i));
+            } else {
+               openlist.append(n);
+            }
+            elements[n++] = ptr;
+            break;
+
+         case XMLITEM_TYPE_ELEMENTEND:
+            getElementName(name, xmlitems[i]);
+            for (k=openlist.getSize()-1; k>=0; k--) {
+               if (strcmp(elements[openlist[k]]->getName(), 
+                     name.getBase()) == 0) {
+                  elements[openlist[k]]->setEndSerial(xmlitems.getSerial(i));
+                  openlist.setSize(k);
+                  break;
+               }
+            }
+            break;
+      }
+   }
 
    parsedQ = 1;
 }
@@ -287,103 +373,43 @@ void XmlFile::parseElements(void) {
 
 //////////////////////////////
 //
-// XmlFile::parseAttributes -- Extract textual list of attributes 
-//    and store them in key/value array for later access.
+// XmlFile::getElementName -- Extract the name of the element from a
+//    start, solo or end tag.
 //
 
-void XmlFile::parseAttributes(void) {
-//  ggg do some work here
-
+void XmlFile::getElementName(SigString& name, XmlItem& anItem) {
+   const char* ptr = anItem.getBase();
+   while (isspace((unsigned char)*ptr) || (*ptr == '<') || (*ptr == '/')) {
+      ptr++;
+   }
+   const char* start = ptr;
+   while ((*ptr != '\0') && !isspace((unsigned char)*ptr) && (*ptr != '>') &&
+         (*ptr != '/')) {
+      ptr++;
+   }
+   name.setSize(ptr - start);
+   memcpy(name.getBase(), start, ptr - start);
 }
 
 
 
 //////////////////////////////
 //
-// XmlFile::processElement -- Identify the start/end of an element.
+// XmlFile::getItemTypeName -- Return a name for the type of an item.
 //
 
-int XmlFile::processElement(int index) {
-   PerlRegularExpression pre;
-
-   int startindex = index;
-   int endindex   = index;
-
-   if (pre.search(xmlitems[index].cstr(), "^\\s*<\\s*([^\\s>]+).*/\\s*>")) {
-      // element starts/ends at the same index point.
-      // No need to do any further processing so just store and continue.
-      XmlElement *ptr = new XmlElement;
-      ptr->setName(pre.getSubmatch(1));
-      ptr->setStartSerial(xmlitems.getSerial(startindex));
-      ptr->setEndSerial(xmlitems.getSerial(startindex));
-      elements.append(ptr);
-      return endindex;  // index will be incremented in calling function
-   }
-
-   // element-start tag is the input, so search for its ending
-   // in the data.  Apply a recursive processing of children
-   // elements at the same time.
-
-
-   if (!pre.search(xmlitems[index].cstr(), "^\\s*<\\s*([^\\s>]+)")) {
-      // malformed (empty) element tag, skip it.
-      return index;
+const char* XmlFile::getItemTypeName(int itemtype) {
+   switch (itemtype) {
+      case XMLITEM_TYPE_ELEMENTSOLO:  return "solo";
+      case XMLITEM_TYPE_ELEMENTSTART: return "start";
+      case XMLITEM_TYPE_ELEMENTEND:   return "end";
+      case XMLITEM_TYPE_WHITESPACE:   return "space";
+      case XMLITEM_TYPE_TEXT:         return "text";
+      case XMLITEM_TYPE_COMMENT:      return "comment";
+      case XMLITEM_TYPE_BANG:         return "bang";
+      case XMLITEM_TYPE_QUESTION:     return "question";
    }
-
-   pre.getSubmatch(1); // fill in the internal match with element name
-
-   // search for the ending tag like "</element>"
-   SigString endname("<\\s*/\\s*");
-   endname += pre.getSubmatch();
-   endname += "\\s*>";
-
-   // start name is the regular expression for a starting element name
-   SigString startname("<\\s*");
-   startname += pre.getSubmatch();
-   startname += "[\\s>";
-
-   // create and store the current element (so that intervening elements
-   // can be place in the list in the correct order.
-   XmlElement *ptr = new XmlElement;
-   ptr->setName(pre.getSubmatch());
-   ptr->setStartSerial(xmlitems.getSerial(startindex));
-   elements.append(ptr);
-   // set the end index later with ptr->setEndSerial();
-
-   int i = index+1;
-   PerlRegularExpression pre2;
-
-   while (i<xmlitems.getSize()) {
-      if (!xmlitems[i].isElement()) {
-         // not an xml element marker, so continue to next item.
-         i++;
-         continue;
-      }
-
-      // check for single-tag element:
-      if (pre2.search(xmlitems[i].cstr(), "^\\s*<([^\\s>]+).*/\\s*>")) {
-         // found a single-item element process it and continue;
-         i = processElement(i) + 1;
-         continue;
-      }
-
-      // check for an ending tag which matches current element
-      if (pre2.search(xmlitems[i].cstr(), endname.getBase())) {
-         ptr->setEndSerial(xmlitems.getSerial(i));
-         i++;
-         continue;
-      }
-
-      // check for element starting, and process if so:
-      if (pre2.search(xmlitems[i].cstr(), "^\\s*<([^\\s>]+).*\\s*>")) {
-         i = processElement(i) + 1;
-         continue;
-      }
-
-      i++;
-   }
-
-   return i;
+   return "unknown";
 }
 
 
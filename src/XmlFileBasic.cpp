@@ -3,6 +3,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue Jun  7 13:04:03 PDT 2011
 // Last Modified: Tue Jun  7 13:04:06 PDT 2011
+// Last Modified: Sun Oct 18 22:10:05 PDT 2026 single-buffer tokenizer
 // Filename:      ...sig/src/sigInfo/XmlFileBasic.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/XmlFileBasic.cpp
 // Syntax:        C++ 
@@ -29,6 +30,7 @@
    
 #include "XmlFileBasic.h"
 #include <string.h>
+#include <ctype.h>
 
 
 ///////////////////////////////////////////////////////////////////////////
@@ -43,13 +45,13 @@
 //
 
 XmlFileBasic::XmlFileBasic(void) { 
-   itemList.setSize(1123123);
    itemList.setSize(0);
-   itemList.setGrowth(10123123);
+   itemList.setGrowth(10000);
    serialgen = 0;   // the serial number of the next item
-   serialMap.setSize(1123123);
    serialMap.setSize(0);
-   serialMap.setGrowth(10123123);
+   serialMap.setGrowth(10000);
+   itemBlock = NULL;
+   itemBlockSize = 0;
 }
 
 XmlFileBasic::XmlFileBasic(int allocationSize) { 
@@ -57,6 +59,8 @@ XmlFileBasic::XmlFileBasic(int allocationSize) {
    itemList.setSize(0);
    itemList.setGrowth(allocationSize);
    serialgen = 0;   // the serial number of the next item
+   itemBlock = NULL;
+   itemBlockSize = 0;
 }
 
 
@@ -81,10 +85,18 @@ void XmlFileBasic::clear(void) {
    int i;
    int asize = itemList.getSize();
    for (i=0; i<asize; i++) {
-      delete itemList[i];
+      if (!isBlockItem(itemList[i])) {
+         delete itemList[i];
+      }
       itemList[i] = NULL;
    }
    itemList.setSize(0);
+   if (itemBlock != NULL) {
+      delete [] itemBlock;
+      itemBlock = NULL;
+   }
+   itemBlockSize = 0;
+   buffer.setSize(0);
    serialgen = 0;     // reset the serial number generator
 }
 
@@ -201,7 +213,9 @@ int XmlFileBasic::deleteItem(int index) {
 
    serialMap[itemList[index]->getSerial()] = -1;
 
-   delete itemList[index];
+   if (!isBlockItem(itemList[index])) {
+      delete itemList[index];
+   }
    XmlItem** ptr  = &itemList[index];
    XmlItem** ptr2 = &itemList[index+1];
    int asize = itemList.getSize() - index - 1;
@@ -226,8 +240,23 @@ int XmlFileBasic::deleteItem(int index) {
 
 void XmlFileBasic::parseXmlFile(const char* filename) {
    fstream input;
-   input.open(filename, ios::in);
-   parseXmlStream(input);
+   input.open(filename, ios::in | ios::binary);
+   if (!input.is_open()) {
+      clear();
+      return;
+   }
+   input.seekg(0, ios::end);
+   long size = input.tellg();
+   input.seekg(0, ios::beg);
+   if (size <= 0) {
+      parseXmlStream(input);
+      return;
+   }
+   string text;
+   text.resize(size);
+   input.read(&text[0], size);
+   text.resize(input.gcount());
+   parseXmlText(text.c_str(), (int)text.size());
 }
 
 
@@ -238,213 +267,177 @@ void XmlFileBasic::parseXmlFile(const char* filename) {
 //
 
 void XmlFileBasic::parseXmlStream(istream& input) {
-   clear();
-   itemList.setSize(1123123);
-   itemList.setGrowth(1123123);
-   itemList.setSize(0);
+   SSTREAM contents;
+   contents << input.rdbuf();
+   string text = contents.str();
+   parseXmlText(text.c_str(), (int)text.size());
+}
 
-   char null = '\0';
-   int ch;
-   Array<char> space;
-   Array<char> tag;
-   Array<char> text;
 
-   while (!input.eof()) {
-      ch = input.peek();
 
-      if (ch < 0) {
-         // end of data stream
-         break;
-      }
-      if (std::isspace((char)ch)) {
-         extractWhiteSpace(space, input);
-         space.append(null); 
-         appendItem(space);
-      } else if ((char)ch == '<') {
-         extractTag(tag, input);
-         tag.append(null); 
-         appendItem(tag);
+//////////////////////////////
+//
+// XmlFileBasic::parseXmlText -- Split XML text into items.  Items are
+//    whitespace, tags, and text (excluding any trailing whitespace,
+//    which is stored as a separate item).  The boundaries of the items
+//    are found first, then the text of all items is copied into a single
+//    buffer, with a null character after each item, and the items are
+//    allocated in one block which points into that buffer.
+//
+
+void XmlFileBasic::parseXmlText(const char* text, int size) {
+   clear();
+
+   Array<int> offsets;
+   offsets.setSize(size / 8 + 1);
+   offsets.setGrowth(size / 8 + 1);
+   offsets.setSize(0);
+
+   const char* ptr;
+   int end;
+   int i = 0;
+   int k;
+   while (i < size) {
+      offsets.append(i);
+      if (isspace((unsigned char)text[i])) {
+         i += getSpaceSize(text+i, size-i);
+      } else if (text[i] == '<') {
+         i += getTagSize(text+i, size-i);
       } else {
-         extractText(text, space, input);
-         text.append(null); 
-         appendItem(text);
-         if (space.getSize() > 0) {
-            space.append(null); 
-            appendItem(space);
+         ptr = (const char*)memchr(text+i, '<', size-i);
+         end = (ptr == NULL) ? size : (int)(ptr - text);
+         k = end - getSpaceSize(text+i, end-i, 1);
+         if (k < end) {
+            offsets.append(k);
          }
+         i = end;
       }
    }
+
+   int count = offsets.getSize();
+   if (count == 0) {
+      return;
+   }
+   offsets.append(size);
+
+   buffer.setSize(size + count);
+   itemBlock = new XmlItem[count];
+   itemBlockSize = count;
+   itemList.setSize(count);
+   serialMap.setSize(count);
+
+   char* bufptr = buffer.getBase();
+   int length;
+   for (i=0; i<count; i++) {
+      length = offsets[i+1] - offsets[i];
+      memcpy(bufptr, text + offsets[i], length);
+      bufptr[length] = '\0';
+      itemBlock[i].setSerial(i);
+      itemBlock[i].setText(bufptr, length);
+      itemList[i] = itemBlock + i;
+      serialMap[i] = i;
+      bufptr += length + 1;
+   }
+   serialgen = count;
 }
 
 
 
 //////////////////////////////
 //
-// XmlFileBasic::extractText --  Extract a text string from an XML file stream
-//    excluding any space characters at the end of the text string which
-//    are stored separately.  Assumes first character is not '<' and 
-//    the first character should also not be a space character, unless
-//    you want a text item to start with space.
-//          output = text (with no null termination so that UTF-16 can
-//                   eventually be processed.
-//          trailingspace = any white space found after text and before any
-//                   subsequent tag.
+// XmlFileBasic::getTagSize -- Return the number of characters in the
+//    tag at the start of the text (which starts with "<").  Comments
+//    end at "-->", CDATA sections at "]]>", and other tags at the first
+//    ">" which is not inside of a quoted value.  An unterminated tag
+//    extends to the end of the text.
 //
 
-void XmlFileBasic::extractText(Array<char>& output, Array<char>& trailingspace,
-      istream& input) {
-
-   output.setSize(0);
-   Array<char>& whitespace = trailingspace;
-   whitespace.setSize(0);
-   
+int XmlFileBasic::getTagSize(const char* text, int size) {
+   const char* ptr;
    int i;
-   int ch;
-   char cch;
-
-   ch = input.get();
-   while ((!input.eof()) && ((char)ch != '<')) {
-      cch = (char)ch;
-      if (std::isspace(cch)) {
-         whitespace.append(cch);
-      } else {
-         for (i=0; i<whitespace.getSize(); i++) {
-            output.append(*(whitespace.getBase()+i));
+
+   if ((size >= 4) && (strncmp(text, "<!--", 4) == 0)) {
+      i = 4;
+      while ((ptr = (const char*)memchr(text+i, '>', size-i)) != NULL) {
+         i = (int)(ptr - text) + 1;
+         if ((text[i-2] == '-') && (text[i-3] == '-')) {
+            return i;
          }
-         whitespace.setSize(0);
-         output.append(cch);
       }
-      ch = input.get();
+      return size;
    }
-   if ((char)ch == '<') {
-      input.putback((char)ch);
+
+   if ((size >= 9) && (strncmp(text, "<![CDATA[", 9) == 0)) {
+      i = 9;
+      while ((ptr = (const char*)memchr(text+i, '>', size-i)) != NULL) {
+         i = (int)(ptr - text) + 1;
+         if ((text[i-2] == ']') && (text[i-3] == ']')) {
+            return i;
+         }
+      }
+      return size;
    }
 
+   for (i=1; i<size; i++) {
+      switch (text[i]) {
+         case '>':
+            return i + 1;
+         case '"':
+         case '\'':
+            ptr = (const char*)memchr(text+i+1, text[i], size-i-1);
+            if (ptr == NULL) {
+               return size;
+            }
+            i = (int)(ptr - text);
+            break;
+      }
+   }
+   return size;
 }
 
 
 
 //////////////////////////////
 //
-// extractTag -- assumes first character in stream at this point is "<";
-//
-// read through until a ">" is found.  Whenever an "=" is found, switch
-// to an attribute-reading mode, looking for paired double or single quotes
-//
-
-void XmlFileBasic::extractTag(Array<char>& output, istream& input) {
-   int attributeMode =  0;
-   int parenState    = 'x';
-   int finishedQ     =  0;
-   int commentQ      =  0;
-   int secondchar    = -1;
-   int thirdchar     = -1;
-   int fourthchar    = -1;
-   int charcount     =  0;
-   int lastchar      = -1;
-   int lastlastchar  = -1;
-
-   int ch = -1;
-   char cch;
-   lastlastchar = lastchar;
-   lastchar = ch;
-   ch = input.get();
-   charcount++;
-   output.setSize(0);
-   while ((!input.eof()) && (!finishedQ)) {
-      cch = (char)ch;
-      if      (charcount == 2) { secondchar = ch; }
-      else if (charcount == 3) { thirdchar = ch; }
-      else if (charcount == 4) { fourthchar = ch; 
-         if ((secondchar == '!') && (thirdchar == '-') && (fourthchar == '-')) {
-            commentQ = 1;
-         }
-      }
+// XmlFileBasic::getSpaceSize -- Return the number of space characters
+//    at the start of the text, or at the end of the text if fromEnd is
+//    true.
+//
 
-      switch (attributeMode) {
-         case 0:   // in tag but outside of an attribute value
-            if (cch == '=') {
-               if (!commentQ) {
-                  // uncomment to parse attribute data:
-                  // attributeMode = 1;
-               } 
-            } else if (cch == '>') {
-               if (commentQ) {
-                  if ((lastlastchar == '-') && (lastchar == '-')) {
-                     finishedQ = 1;
-                  }
-               } else {
-                  finishedQ = 1;
-               }
-            }
-            output.append(cch);
+int XmlFileBasic::getSpaceSize(const char* text, int size, int fromEnd) {
+   int i;
+   if (fromEnd) {
+      for (i=size-1; i>=0; i--) {
+         if (!isspace((unsigned char)text[i])) {
             break;
-
-         case 1:   // start of attribute value but not inside of parens
-            if (std::isspace(cch)) {
-               output.append(cch);
-            } else if (cch == '\'') {
-               parenState = '\'';
-               attributeMode = 2;
-            } else if (cch == '"') {
-               parenState = '"';
-               attributeMode = 2;
-            } else {
-               cerr << "ERROR READING ATTRIBUTE VALUE\n";
-               exit(1);
-            }
-            if (commentQ) {
-               attributeMode = 0;
-               parenState = 'x';
-            }
-
-         case 2:   // in attribute value within parens.
-            if (cch == parenState) {
-              attributeMode = 0;
-            }
-            if (cch == '>') {
-               cerr << "ERROR: '>' cannot occur within an attribute value\n";
-               exit(1);
-            } if (cch == '<') {
-               cerr << "ERROR: '<' cannot occur within an attribute value\n";
-               exit(1);
-            }
-            output.append(cch);
+         }
       }
-      if (finishedQ) {
+      return size - 1 - i;
+   }
+   for (i=0; i<size; i++) {
+      if (!isspace((unsigned char)text[i])) {
          break;
       }
-      lastlastchar = lastchar;
-      lastchar = ch;
-      ch = input.get();
-      charcount++;
    }
-
+   return i;
 }
 
 
 
 //////////////////////////////
 //
-// extractWhiteSpace --
+// XmlFileBasic::isBlockItem -- Returns true if the item was allocated
+//    when reading a file (in which case it should not be deleted
+//    separately from the other items).
 //
 
-void XmlFileBasic::extractWhiteSpace(Array<char>& output, istream& input) {
-   int ch;
-   char cch;
-   output.setSize(0);
-   ch = input.get();
-   while (!input.eof() && std::isspace((char)ch)) {
-      cch = (char)ch;
-      output.append(cch);
-      ch = input.get();
-   }
-   if (!input.eof()) {
-      input.putback((char)ch);
-   }
+int XmlFileBasic::isBlockItem(XmlItem* item) {
+   return (itemBlock != NULL) && (item >= itemBlock) &&
+          (item < itemBlock + itemBlockSize);
 }
 
 
+
 //////////////////////////////
 //
 // XmlFileBasic::assignSerialMapping --
@@ -3,6 +3,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue Jun  7 13:04:03 PDT 2011
 // Last Modified: Tue Jun  7 13:04:06 PDT 2011
+// Last Modified: Sun Oct 18 22:10:05 PDT 2026 added shared-buffer items
 // Filename:      ...sig/src/sigInfo/XmlItem.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/XmlItem.cpp
 // Syntax:        C++ 
@@ -27,11 +28,17 @@
    #define CSTRING str()
 #endif
    
-#include "PerlRegularExpression.h"
 #include "XmlItem.h"
 #include <string.h>
 
 
+static char XmlItemEmpty[1] = {'\0'};
+
+static int  isXmlSpace      (char ch);
+static int  isXmlNameStart  (char ch);
+static const char* skipXmlSpace(const char* ptr);
+
+
 ///////////////////////////////////////////////////////////////////////////
 //
 // XmlItem class functions --
@@ -44,17 +51,40 @@
 //
 
 XmlItem::XmlItem(void) {
+   text   = XmlItemEmpty;
+   length = 0;
+   owned  = NULL;
    setSerial(-1);
-   setText("");
+   setType();
 }
 
 XmlItem::XmlItem(int serialnum, Array<char>& item) {
+   text   = XmlItemEmpty;
+   length = 0;
+   owned  = NULL;
    setSerial(serialnum);
    setText(item);
 }
 
 
 
+//////////////////////////////
+//
+// XmlItem::clear --
+//
+
+void XmlItem::clear(void) {
+   serial = -1;
+   if (owned != NULL) {
+      delete owned;
+      owned = NULL;
+   }
+   text   = XmlItemEmpty;
+   length = 0;
+}
+
+
+
 //////////////////////////////
 //
 // XmlItem::getType -- return the raw type of item.
@@ -126,12 +156,37 @@ void XmlItem::setSerial(int aserial) {
 //
 
 int XmlItem::setText(Array<char>& item) {
-   string = item;
+   if (owned == NULL) {
+      owned = new SigString;
+   }
+   *owned = item;
+   text   = owned->getBase();
+   length = owned->getSize();
    return setType();
 }
 
 int XmlItem::setText(const char* item) {
-   string = item;
+   if (owned == NULL) {
+      owned = new SigString;
+   }
+   *owned = item;
+   text   = owned->getBase();
+   length = owned->getSize();
+   return setType();
+}
+
+//
+// The buffer version does not copy the text: the buffer must be
+// null-terminated at size and must not be freed before the item.
+//
+
+int XmlItem::setText(char* buffer, int size) {
+   if (owned != NULL) {
+      delete owned;
+      owned = NULL;
+   }
+   text   = buffer;
+   length = size;
    return setType();
 }
 
@@ -145,51 +200,118 @@ int XmlItem::setText(const char* item) {
 //
 
 int XmlItem::setType(void) {
-   PerlRegularExpression pre;
+   const char* ptr = skipXmlSpace(text);
 
-   if (pre.search(string.getBase(), "^\\s*$")) {
+   if (*ptr == '\0') {
       itemtype = XMLITEM_TYPE_WHITESPACE;
       return itemtype;
    }
 
-   if (!pre.search(string.getBase(), "^\\s*<")) {
+   if (*ptr != '<') {
       itemtype = XMLITEM_TYPE_TEXT;
       return itemtype;
    }
 
-   if (pre.search(string.getBase(), "^\\s*<\\s*!\\s*-\\s*-\\s*")) {  
-      itemtype = XMLITEM_TYPE_COMMENT;
-      return itemtype;
-   }
-   
-   if (pre.search(string.getBase(), "^\\s*<\\s*!")) {
+   ptr = skipXmlSpace(ptr+1);
+   if (*ptr == '!') {
+      ptr = skipXmlSpace(ptr+1);
+      if (*ptr == '-') {
+         ptr = skipXmlSpace(ptr+1);
+         if (*ptr == '-') {
+            itemtype = XMLITEM_TYPE_COMMENT;
+            return itemtype;
+         }
+      }
       itemtype = XMLITEM_TYPE_BANG;
       return itemtype;
    }
 
-   if (pre.search(string.getBase(), "^\\s*<\\s*\\?")) {
+   if (*ptr == '?') {
       itemtype = XMLITEM_TYPE_QUESTION;
       return itemtype;
    }
 
-   if (pre.search(string.getBase(), "^\\s*<\\s*[A-Z\\d].*\\s*/\\s*>")) {
-      itemtype = XMLITEM_TYPE_ELEMENTSOLO;
+   // element tags must end in ">", ignoring any trailing space.
+   int last = length - 1;
+   while ((last >= 0) && isXmlSpace(text[last])) {
+      last--;
+   }
+   if ((last < 0) || (text[last] != '>')) {
+      itemtype = XMLITEM_TYPE_UNKNOWN;
       return itemtype;
    }
 
-   if (pre.search(string.getBase(), "^\\s*<\\s*/\\s*[A-Z\\d].*\\s*>")) {
-      itemtype = XMLITEM_TYPE_ELEMENTEND;
+   if (*ptr == '/') {
+      ptr = skipXmlSpace(ptr+1);
+      if (isXmlNameStart(*ptr)) {
+         itemtype = XMLITEM_TYPE_ELEMENTEND;
+      } else {
+         itemtype = XMLITEM_TYPE_UNKNOWN;
+      }
       return itemtype;
    }
 
-   if (pre.search(string.getBase(), "^\\s*<\\s*[A-Za-z\\d].*\\s*>")) {
-      itemtype = XMLITEM_TYPE_ELEMENTSTART;
+   if (!isXmlNameStart(*ptr)) {
+      itemtype = XMLITEM_TYPE_UNKNOWN;
       return itemtype;
    }
 
-   itemtype = XMLITEM_TYPE_UNKNOWN;
+   last--;
+   while ((last >= 0) && isXmlSpace(text[last])) {
+      last--;
+   }
+   if ((last >= 0) && (text[last] == '/')) {
+      itemtype = XMLITEM_TYPE_ELEMENTSOLO;
+   } else {
+      itemtype = XMLITEM_TYPE_ELEMENTSTART;
+   }
    return itemtype;
 }
+
+
+
+//////////////////////////////
+//
+// isXmlSpace -- space characters in XML data.
+//
+
+static int isXmlSpace(char ch) {
+   switch (ch) {
+      case ' ': case '\t': case '\n': case '\r': case '\f': case '\v':
+         return 1;
+   }
+   return 0;
+}
+
+
+
+//////////////////////////////
+//
+// isXmlNameStart -- true if the character can start an element name.
+//    Non-ASCII (UTF-8) characters are allowed.
+//
+
+static int isXmlNameStart(char ch) {
+   if ((ch >= 'a') && (ch <= 'z')) { return 1; }
+   if ((ch >= 'A') && (ch <= 'Z')) { return 1; }
+   if ((ch >= '0') && (ch <= '9')) { return 1; }
+   if ((ch == '_') || (ch == ':')) { return 1; }
+   return (unsigned char)ch >= 0x80;
+}
+
+
+
+//////////////////////////////
+//
+// skipXmlSpace -- return a pointer to the first non-space character.
+//
+
+static const char* skipXmlSpace(const char* ptr) {
+   while (isXmlSpace(*ptr)) {
+      ptr++;
+   }
+   return ptr;
+}
    
 
 